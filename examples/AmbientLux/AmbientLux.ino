@@ -0,0 +1,99 @@
+/*!
+@file AmbientLux.ino
+
+@section AmbientLux_intro_section Description
+
+Example program for using the VCNL4010 library to measure the ambient light in lux. The
+VCNL4010AutoRange class adjusts the number of conversions averaged for each reading and the rate
+of readings to the light level, so that the noise stays below 1% of the reading: in bright light
+readings come 10 times per second, in dim light more conversions are averaged and readings come
+less often.
+
+Each reading is printed in lux along with the averaging and rate in use whenever the averaging
+changes or the light level changes by more than 5%.
+
+@section AmbientLux_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section AmbientLux_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section AmbientLux_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include "VCNL4010AutoRange.h"  // Include the library
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};  ///< Set the baud rate for Serial I/O
+const uint8_t  NOISE_PER_MILLE{10};   ///< Noise target of 1% of the reading
+const uint8_t  PERCENTAGE{5};         ///< Percentage change in lux to print a reading
+
+/***************************************************************************************************
+** Declare global variables and instantiate classes                                               **
+***************************************************************************************************/
+VCNL4010          Sensor;             ///< Instantiate the class
+VCNL4010AutoRange AutoRange(Sensor);  ///< Auto-ranging of the ambient light readings
+uint32_t          LastLux{0};         ///< Last lux value printed
+
+void setup() {
+  /*!
+    @brief    Arduino method called once at startup to initialize the system
+    @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+              called one time and then control goes to the main "loop()" method, from which control
+              never returns
+    @return   void
+  */
+  Serial.begin(SERIAL_SPEED);  // Start serial port at the specified baud rate
+#ifdef __AVR_ATmega32U4__      // If we are a 32U4 processor, then wait for the interface to start
+  delay(2000);
+#endif
+  Serial.println("Starting VCNL4010 AmbientLux program");
+  while (!Sensor.begin()) {  // Loop until sensor found
+    Serial.println("Error, unable to find or identify VCNL4010.\nChecking again in 5 seconds...");
+    delay(5000);
+  }  // of if-then we can't initialize or find the device
+  Sensor.setAmbientContinuous(true);  // Device measures on its own at the rate set
+  AutoRange.begin(NOISE_PER_MILLE);   // Start with the default budget of 160 conversions/s
+}  // of method setup()
+
+void loop() {
+  /*!
+    @brief    Arduino method for the main program loop
+    @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+              repeating.
+    @return   void
+  */
+  static uint8_t lastAveraging{0};   // Averaging of the last printed reading
+  if (!AutoRange.service()) return;  // No new reading
+  const uint32_t lux   = AutoRange.getLux();
+  const uint32_t delta = LastLux * PERCENTAGE / 100;
+  if (AutoRange.getAveraging() == lastAveraging && lux + delta >= LastLux &&
+      lux <= LastLux + delta) {
+    return;
+  }  // if-then nothing changed
+  Serial.print(lux >> VCNL4010_LUX_FRACTION_BITS);  // Integer part
+  Serial.print('.');
+  const uint8_t hundredths = (lux & 0xFF) * 100 >> VCNL4010_LUX_FRACTION_BITS;
+  if (hundredths < 10) Serial.print('0');
+  Serial.print(hundredths);
+  Serial.print(" lux, averaging ");
+  Serial.print(AutoRange.getAveraging());
+  Serial.print(", ");
+  Serial.print(AutoRange.getRate());
+  Serial.println(" readings/s");
+  LastLux       = lux;
+  lastAveraging = AutoRange.getAveraging();
+}  // of method loop()
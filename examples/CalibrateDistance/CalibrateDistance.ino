@@ -0,0 +1,139 @@
+/*!
+@file CalibrateDistance.ino
+
+@section CalibrateDistance_intro_section Description
+
+Example program for using the VCNL4010 library to measure distances in millimeters. The proximity
+reading depends on the distance, the target's reflectivity, the LED current and the modulator
+frequency, so the conversion is calibrated with the target that will be measured.
+
+The program asks for the target to be placed at a series of distances from the sensor and records
+the proximity reading at each one. It then builds a VCNL4010DistanceTable, prints it so that it can
+be pasted into a program as a constant, and from then on prints the distance to the target whenever
+it changes by at least 2mm.
+
+@section CalibrateDistance_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section CalibrateDistance_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section CalibrateDistance_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include "VCNL4010Calibration.h"  // Include the library
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};  ///< Set the baud rate for Serial I/O
+const uint16_t DISTANCES[]{5, 10, 15, 20, 30, 40, 60, 80, 100, 150};  ///< Calibration points in mm
+const uint8_t  POINTS{sizeof(DISTANCES) / sizeof(DISTANCES[0])};      ///< Number of points
+
+/***************************************************************************************************
+** Declare global variables and instantiate classes                                               **
+***************************************************************************************************/
+VCNL4010              Sensor;               ///< Instantiate the class
+VCNL4010Calibration   Calibration(Sensor);  ///< Calibration for the sensor
+VCNL4010DistanceTable Table;                ///< Calibration table
+uint16_t              LastDistance{0};      ///< Last distance printed
+
+void printArray(const char *name, const uint16_t *values) {
+  /*!
+    @brief    Prints one array of the calibration table
+    @param[in] name Name of the structure member
+    @param[in] values Values to print
+  */
+  Serial.print(name);
+  for (uint8_t i = 0; i < VCNL4010_CALIBRATION_POINTS; ++i) {
+    Serial.print(values[i]);
+    Serial.print(i + 1 < VCNL4010_CALIBRATION_POINTS ? ", " : "},\n");
+  }  // for-next each value
+}  // of method printArray()
+
+void setup() {
+  /*!
+    @brief    Arduino method called once at startup to initialize the system
+    @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+              called one time and then control goes to the main "loop()" method, from which control
+              never returns
+    @return   void
+  */
+  Serial.begin(SERIAL_SPEED);  // Start serial port at the specified baud rate
+#ifdef __AVR_ATmega32U4__      // If we are a 32U4 processor, then wait for the interface to start
+  delay(2000);
+#endif
+  Serial.println("Starting VCNL4010 CalibrateDistance program");
+  while (!Sensor.begin()) {  // Loop until sensor found
+    Serial.println("Error, unable to find or identify VCNL4010.\nChecking again in 5 seconds...");
+    delay(5000);
+  }  // of if-then we can't initialize or find the device
+  Sensor.setLEDmA(200);                 // Maximum current for the longest range
+  Sensor.setProximityHz(128);           // Fast readings for averaging
+  Sensor.setProximityContinuous(true);  // Device measures on its own
+  for (uint8_t i = 0; i < POINTS; ++i) {
+    Serial.print("Place the target at ");
+    Serial.print(DISTANCES[i]);
+    Serial.println("mm and send any character");
+    while (!Serial.available()) delay(10);  // Wait for the target to be in place
+    while (Serial.available()) Serial.read();
+    if (!Calibration.addPoint(DISTANCES[i], 32)) {
+      Serial.println("Reading the sensor failed, repeating this point");
+      --i;
+    }  // if-then point not recorded
+  }    // for-next each calibration point
+  if (!Calibration.build(Table) || !Calibration.begin(Table)) {
+    Serial.println("Calibration failed, the readings do not change with the distance");
+    while (true) delay(1000);
+  }  // if-then calibration failed
+  Serial.print("Calibrated with ");
+  Serial.print(Table.count);
+  Serial.println(" points:\nconst VCNL4010DistanceTable TABLE PROGMEM{");
+  Serial.print("    ");
+  Serial.print(Table.magic);
+  Serial.print(", ");
+  Serial.print(Table.ledCurrent);
+  Serial.print(", ");
+  Serial.print(Table.timing);
+  Serial.print(", ");
+  Serial.print(Table.count);
+  Serial.println(",");
+  printArray("    {", Table.proximity);
+  printArray("    {", Table.distance);
+  Serial.print("    {");
+  for (uint8_t i = 0; i < VCNL4010_CALIBRATION_POINTS; ++i) {
+    Serial.print(Table.slope[i]);
+    Serial.print(i + 1 < VCNL4010_CALIBRATION_POINTS ? ", " : "},\n");
+  }  // for-next each slope
+  Serial.print("    ");
+  Serial.print(Table.checksum);
+  Serial.println("};");
+}  // of method setup()
+
+void loop() {
+  /*!
+    @brief    Arduino method for the main program loop
+    @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+              repeating.
+    @return   void
+  */
+  const uint16_t distance = Calibration.getDistanceMm();
+  if (distance == 0) return;  // Reading failed
+  if (distance + 2 <= LastDistance || distance >= LastDistance + 2) {
+    Serial.print("Distance ");
+    Serial.print(distance);
+    Serial.println("mm");
+    LastDistance = distance;
+  }  // if-then distance changed
+}  // of method loop()
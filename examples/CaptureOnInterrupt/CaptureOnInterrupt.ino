@@ -0,0 +1,108 @@
+/*!
+@file CaptureOnInterrupt.ino
+
+@section CaptureOnInterrupt_intro_section Description
+
+Example program for using the VCNL4010 library to capture proximity readings at 250 samples per
+second without polling the sensor. The VCNL4010 runs in continuous mode and raises its INT pin
+whenever a new proximity reading is ready. The interrupt routine only calls onInterrupt(), the
+device is read later from the main loop by service(), which pushes a timestamped sample into a
+ring buffer. The program then takes the samples out of the ring in batches and displays the
+average of each batch along with the overflow counters.
+
+The INT pin on the VCNL4010 needs to be connected to a pin that supports interrupts, see
+https://www.arduino.cc/en/Reference/attachInterrupt for the pins that may be used. The INT pin is
+open-drain, so the internal pull-up resistor is enabled.
+
+@section CaptureOnInterrupt_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section CaptureOnInterrupt_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section CaptureOnInterrupt_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.1   | 2026-10-17 | SV-Zanshin | Configure the sensor with a compile-time VCNL4010Profile     |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include "VCNL4010.h"  // Include the library
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};  ///< Set the baud rate for Serial I/O
+const uint8_t  INTERRUPT_PIN{2};      ///< Pin connected to the VCNL4010 INT pin
+const uint8_t  BATCH_SIZE{8};         ///< Number of samples taken from the ring at once
+/*! @brief 250 continuous proximity readings/s at 200mA with an interrupt on each reading */
+typedef VCNL4010Profile<250, 200, 2, 32, 0, true, false, VCNL4010_INT_PROX_READY> CaptureProfile;
+
+/***************************************************************************************************
+** Declare global variables and instantiate classes                                               **
+***************************************************************************************************/
+VCNL4010            Sensor;   ///< Instantiate the class
+VCNL4010CaptureRing Samples;  ///< Ring buffer for the captured samples
+
+void sensorInterrupt() {
+  /*!
+    @brief    Interrupt routine for the VCNL4010 INT pin
+    @details  Only flags the interrupt, the I2C bus is not used from within the interrupt routine
+  */
+  Sensor.onInterrupt();
+}  // of method sensorInterrupt()
+
+void setup() {
+  /*!
+    @brief    Arduino method called once at startup to initialize the system
+    @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+              called one time and then control goes to the main "loop()" method, from which control
+              never returns
+    @return   void
+  */
+  Serial.begin(SERIAL_SPEED);  // Start serial port at the specified baud rate
+#ifdef __AVR_ATmega32U4__      // If we are a 32U4 processor, then wait for the interface to start
+  delay(2000);
+#endif
+  Serial.println("Starting VCNL4010 CaptureOnInterrupt program");
+  Sensor.beginCapture(Samples);  // Push a sample into the ring on each interrupt
+  while (!Sensor.begin(CaptureProfile(), VCNL4010_I2C_ADDRESS, I2C_FAST_MODE)) {
+    Serial.println("Error, unable to find or identify VCNL4010.\nChecking again in 5 seconds...");
+    delay(5000);
+  }  // of if-then we can't initialize or find the device
+  pinMode(INTERRUPT_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(INTERRUPT_PIN), sensorInterrupt, FALLING);
+  Serial.println("VCNL4010 initialized.\n");
+}  // of method setup()
+
+void loop() {
+  /*!
+    @brief    Arduino method for the main program loop
+    @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+              repeating.
+    @return   void
+  */
+  Sensor.service();  // Handles pending interrupts, never waits
+  if (Samples.available() >= BATCH_SIZE) {
+    VCNL4010TimedSample batch[BATCH_SIZE];
+    uint8_t             count = Samples.pop(batch, BATCH_SIZE);
+    uint32_t            total{0};
+    for (uint8_t i = 0; i < count; ++i) total += batch[i].proximity;
+    Serial.print("Time = ");
+    Serial.print(batch[count - 1].micros);
+    Serial.print(", average proximity = ");
+    Serial.print(total / count);
+    Serial.print(", overflows = ");
+    Serial.print(Samples.overflows());
+    Serial.print(", coalesced = ");
+    Serial.println(Sensor.getCoalescedInterrupts());
+  }  // if-then a batch is available
+}  // of method loop()
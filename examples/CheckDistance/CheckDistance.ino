@@ -34,6 +34,7 @@ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
 
 | Version | Date       | Developer  | Comments                                                     |
 | ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.3   | 2026-10-17 | SV-Zanshin | Filter the readings and use integer math for the threshold   |
 | 1.0.2   | 2020-12-24 | SV-Zanshin | Changed code to make it more legible                         |
 | 1.0.1   | 2019-01-23 | SV-Zanshin | Changed coding style to doxygen                              |
 | 1.0.0   | 2017-09-01 | SV-Zanshin | Initial coding                                               |
@@ -44,9 +45,11 @@ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
 ** Declare all program constants                                                                  **
 ***************************************************************************************************/
 const uint32_t SERIAL_SPEED{115200};  ///< Set the baud rate for Serial I/O
-const float    PERCENTAGE{0.15};      ///< Percentage delta trigger
+const uint8_t  PERCENTAGE{15};        ///< Percentage delta trigger
 VCNL4010       Sensor;                ///< Instantiate the VCNL4010 class
-void           setup() {
+/*! @brief Ignore single outliers, then take the median of 5 and smooth with a short average */
+VCNL4010Chain<VCNL4010SpikeReject<1000, 3>, VCNL4010Median<5>, VCNL4010Ema<2>> Filter;
+void setup() {
   /*!
     @brief    Arduino method called once at startup to initialize the system
     @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
@@ -70,6 +73,8 @@ void           setup() {
   Serial.println("  - Proximity sensor power set to 200mA");
   Sensor.setProximityHz(128);
   Serial.println("  - Proximity sampling set to 128x per second");
+  Sensor.setProximityFilter(&Filter);
+  Serial.println("  - Proximity readings are filtered");
   Serial.println("- VCNL4010 initialized.\n\n");
   Serial.println("---> Move object close to sensor <---\n");
 }  // of method setup()
@@ -81,7 +86,7 @@ void loop() {
   */
   static uint16_t proximityLast{0};                             // Last displayed Proximity reading
   uint16_t        proximityCurrent = Sensor.getProximity();     // Get the Proximity sensor value
-  uint16_t proximityDelta  = proximityCurrent * PERCENTAGE;     // Set delta to percentage of value
+  uint16_t proximityDelta  = (uint32_t)proximityCurrent * PERCENTAGE / 100;  // % of the value
   int16_t  proximityChange = proximityLast - proximityCurrent;  // Compute the delta Proximity
 
   if (abs(proximityChange) >
@@ -0,0 +1,107 @@
+/*!
+@file LowPowerProximity.ino
+
+@section LowPowerProximity_intro_section Description
+
+Example program for using the VCNL4010 library with the lowest power use of the proximity sensor.
+The VCNL4010Power class lowers the IR LED current as far as the signal to noise ratio allows and
+slows the proximity rate while nothing moves, until the sensor sleeps at 2 readings per second with
+the threshold interrupt armed. When the interrupt fires or motion is seen the rate goes back up to
+250 readings per second.
+
+Each change of the settings is printed with the estimated energy per reading and average current,
+which can be used to budget the battery life.
+
+The INT pin on the VCNL4010 needs to be connected to a pin that supports interrupts, see
+https://www.arduino.cc/en/Reference/attachInterrupt for the pins that may be used.
+
+@section LowPowerProximity_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section LowPowerProximity_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section LowPowerProximity_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include "VCNL4010Power.h"  // Include the library
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};  ///< Set the baud rate for Serial I/O
+const uint8_t  INTERRUPT_PIN{2};      ///< Pin connected to the VCNL4010 INT pin
+const uint8_t  SNR_TARGET{20};        ///< Lowest signal to noise ratio of the readings
+const uint8_t  MIN_HZ{16};            ///< Lowest proximity rate before sleeping
+
+/***************************************************************************************************
+** Declare global variables and instantiate classes                                               **
+***************************************************************************************************/
+VCNL4010      Sensor;         ///< Instantiate the class
+VCNL4010Power Power(Sensor);  ///< Power management for the sensor
+
+void sensorInterrupt() {
+  /*!
+    @brief    Interrupt routine for the VCNL4010 INT pin
+  */
+  Sensor.onInterrupt();
+}  // of method sensorInterrupt()
+
+void setup() {
+  /*!
+    @brief    Arduino method called once at startup to initialize the system
+    @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+              called one time and then control goes to the main "loop()" method, from which control
+              never returns
+    @return   void
+  */
+  Serial.begin(SERIAL_SPEED);  // Start serial port at the specified baud rate
+#ifdef __AVR_ATmega32U4__      // If we are a 32U4 processor, then wait for the interface to start
+  delay(2000);
+#endif
+  Serial.println("Starting VCNL4010 LowPowerProximity program");
+  while (!Sensor.begin()) {  // Loop until sensor found
+    Serial.println("Error, unable to find or identify VCNL4010.\nChecking again in 5 seconds...");
+    delay(5000);
+  }  // of if-then we can't initialize or find the device
+  pinMode(INTERRUPT_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(INTERRUPT_PIN), sensorInterrupt, FALLING);
+  Power.begin(SNR_TARGET, MIN_HZ, true);  // Interrupt pin is used while sleeping
+}  // of method setup()
+
+void loop() {
+  /*!
+    @brief    Arduino method for the main program loop
+    @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+              repeating.
+    @return   void
+  */
+  switch (Power.service()) {
+    case VCNL4010_POWER_NONE: return;
+    case VCNL4010_POWER_MOTION: Serial.print("Motion: "); break;
+    case VCNL4010_POWER_SLEEPING: Serial.print("Sleeping: "); break;
+    case VCNL4010_POWER_WAKE: Serial.print("Woken up: "); break;
+    default: Serial.print("Tuned: "); break;
+  }  // of switch on the power event
+  Serial.print(Power.getLEDmA());
+  Serial.print("mA, ");
+  Serial.print(Power.getRateHz());
+  Serial.print(" readings/s, SNR ");
+  Serial.print(Power.getSNR());
+  Serial.print(", ");
+  Serial.print(Power.getEnergyPerSample());
+  Serial.print("nJ/reading, ");
+  Serial.print(Power.getAverageMicroAmps());
+  Serial.println("uA");
+}  // of method loop()
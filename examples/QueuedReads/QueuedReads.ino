@@ -0,0 +1,112 @@
+/*!
+@file QueuedReads.ino
+
+@section QueuedReads_intro_section Description
+
+Example program for using the VCNL4010 library with the VCNL4010Queue transaction queue. The queue
+sits between the driver and the I2C bus. Writes made by the driver are posted and merged, so the
+interrupt control and threshold writes of setInterrupt() go out as a single burst, and the program
+queues its own reads of the proximity result with a completion callback instead of waiting for them.
+The main loop keeps on doing other work and only calls poll() to work on the queue.
+
+On platforms with interrupt- or DMA-driven I2C a transport derived from VCNL4010Queue runs the
+transactions in the background, here the queue is worked off by poll() in the loop.
+
+@section QueuedReads_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section QueuedReads_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section QueuedReads_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include "VCNL4010Queue.h"  // Include the library
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};  ///< Set the baud rate for Serial I/O
+const uint16_t READ_MILLIS{100};      ///< Milliseconds between queued reads
+
+/***************************************************************************************************
+** Declare global variables and instantiate classes                                               **
+***************************************************************************************************/
+VCNL4010WireBus Bus;              ///< I2C bus using "Wire"
+VCNL4010Queue   Queue(Bus);       ///< Queues and merges transactions
+VCNL4010        Sensor(Queue);    ///< Instantiate the class on the queue
+uint32_t        LastRead{0};      ///< millis() value of the last queued read
+uint32_t        LoopCount{0};     ///< Loop iterations, stands for other work done
+bool            ReadBusy{false};  ///< A queued read has not completed yet
+
+void proximityRead(const VCNL4010Transaction &transaction, void *context) {
+  /*!
+    @brief    Completion callback of the queued proximity reads
+    @param[in] transaction Completed transaction, data holds the result MSB and LSB
+    @param[in] context Not used
+  */
+  (void)context;
+  ReadBusy = false;
+  if (transaction.status != VCNL4010_I2C_OK) {
+    Serial.println("Read failed");
+    return;
+  }  // if-then failed
+  Serial.print("Proximity ");
+  Serial.print((uint16_t)transaction.data[0] << 8 | transaction.data[1]);
+  Serial.print(", loops since last read ");
+  Serial.println(LoopCount);
+  LoopCount = 0;
+}  // of method proximityRead()
+
+void setup() {
+  /*!
+    @brief    Arduino method called once at startup to initialize the system
+    @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+              called one time and then control goes to the main "loop()" method, from which control
+              never returns
+    @return   void
+  */
+  Serial.begin(SERIAL_SPEED);  // Start serial port at the specified baud rate
+#ifdef __AVR_ATmega32U4__      // If we are a 32U4 processor, then wait for the interface to start
+  delay(2000);
+#endif
+  Serial.println("Starting VCNL4010 QueuedReads program");
+  while (!Sensor.begin()) {  // Loop until sensor found
+    Serial.println("Error, unable to find or identify VCNL4010.\nChecking again in 5 seconds...");
+    delay(5000);
+  }  // of if-then we can't initialize or find the device
+  Sensor.setInterrupt(1, false, false, true, false, 0, 5000);  // Two writes, one burst
+  Sensor.setProximityHz(16);                                   // 16.625 measurements per second
+  Sensor.setProximityContinuous(true);                         // Device measures on its own
+  Queue.drain();                                               // Send the settings now
+  Serial.print("Transactions ");
+  Serial.print(Queue.getSubmitted());
+  Serial.print(", merged ");
+  Serial.println(Queue.getCoalesced());
+}  // of method setup()
+
+void loop() {
+  /*!
+    @brief    Arduino method for the main program loop
+    @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+              repeating.
+    @return   void
+  */
+  ++LoopCount;  // Other work goes here
+  if (!ReadBusy && millis() - LastRead >= READ_MILLIS) {
+    LastRead = millis();
+    ReadBusy = Queue.submitRead(VCNL4010_I2C_ADDRESS, REGISTER_PROXIMITY, 2, proximityRead);
+  }  // if-then time for the next read
+  Queue.poll();  // Work on the queue, calls proximityRead() when done
+}  // of method loop()
@@ -0,0 +1,91 @@
+/*!
+@file RecordSamples.ino
+
+@section RecordSamples_intro_section Description
+
+Example program for using the VCNL4010 library to record the raw readings of a sensor in the field.
+The VCNL4010Recorder sits between the driver and the I2C bus and logs every new proximity and
+ambient light reading with its time, as well as every change of the sensor configuration, in a
+compact binary format.
+
+The recording is written to the serial port, so after the "Recording" line everything received is
+binary data. It can be captured into a file on the host, e.g. with "cat /dev/ttyACM0 > trace.bin"
+on Linux after removing the text line at the start, and played back with the VCNL4010Replay class
+through the normal driver calls. The program stops recording after RECORD_SECONDS seconds.
+
+@section RecordSamples_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section RecordSamples_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section RecordSamples_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include "VCNL4010Record.h"  // Include the library
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};  ///< Set the baud rate for Serial I/O
+const uint16_t RECORD_SECONDS{600};   ///< Length of the recording
+
+/***************************************************************************************************
+** Declare global variables and instantiate classes                                               **
+***************************************************************************************************/
+VCNL4010WireBus  Bus;               ///< I2C bus using "Wire"
+VCNL4010Recorder Recorder(Bus);     ///< Records what passes over the bus
+VCNL4010         Sensor(Recorder);  ///< Instantiate the class on the recorder
+uint32_t         StartMillis{0};    ///< millis() value at the start of the recording
+
+void setup() {
+  /*!
+    @brief    Arduino method called once at startup to initialize the system
+    @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+              called one time and then control goes to the main "loop()" method, from which control
+              never returns
+    @return   void
+  */
+  Serial.begin(SERIAL_SPEED);  // Start serial port at the specified baud rate
+#ifdef __AVR_ATmega32U4__      // If we are a 32U4 processor, then wait for the interface to start
+  delay(2000);
+#endif
+  Serial.println("Starting VCNL4010 RecordSamples program");
+  while (!Sensor.begin()) {  // Loop until sensor found
+    Serial.println("Error, unable to find or identify VCNL4010.\nChecking again in 5 seconds...");
+    delay(5000);
+  }  // of if-then we can't initialize or find the device
+  Sensor.setProximityHz(32);            // 31.25 measurements per second
+  Sensor.setProximityContinuous(true);  // Device measures on its own
+  Sensor.setAmbientContinuous(true);    // Ambient light too, at the default 2 per second
+  Sensor.flush();                       // Wait until the settings are active
+  Serial.println("Recording");
+  Recorder.start(Serial);  // Binary data from here on
+  StartMillis = millis();
+}  // of method setup()
+
+void loop() {
+  /*!
+    @brief    Arduino method for the main program loop
+    @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+              repeating.
+    @return   void
+  */
+  uint16_t value;
+  if (!Recorder.isRecording()) return;
+  Sensor.service();  // New readings are recorded as they are read
+  Sensor.tryGetProximity(value);
+  Sensor.tryGetAmbientLight(value);
+  if (millis() - StartMillis >= RECORD_SECONDS * 1000UL) Recorder.stop();
+}  // of method loop()
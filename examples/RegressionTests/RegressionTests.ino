@@ -27,6 +27,7 @@ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
 
 | Version | Date       | Developer  | Comments                                                     |
 | ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.1   | 2026-10-17 | SV-Zanshin | Call flush() as parameter changes are no longer blocking     |
 | 1.0.0   | 2020-12-25 | SV-Zanshin | Issue #15 - Initial coding                                   |
 
 */
@@ -61,6 +62,7 @@ void setup() {
   Serial.println("Setting and checking VCNL4010 attributes.");
 
   Sensor.setProximityHz(128);
+  Sensor.flush();  // Wait until the change has been written
   uint8_t value = Sensor.readByte(REGISTER_PROXIMITY_RATE);
   if (value != 6) {
     Serial.print("Error in Proximity Hertz, should be \"6\", value = \"");
@@ -68,6 +70,7 @@ void setup() {
     Serial.println("\".");
   }  // if-then bad Proximity change
   Sensor.setProximityHz(32);
+  Sensor.flush();  // Wait until the change has been written
   value = Sensor.readByte(REGISTER_PROXIMITY_RATE);
   if (value != 4) {
     Serial.print("Error in Proximity Hertz, should be \"4\", value = \"");
@@ -76,6 +79,7 @@ void setup() {
   }  // if-then bad Proximity change
 
   Sensor.setProximityFreq(1);
+  Sensor.flush();  // Wait until the change has been written
   value = Sensor.readByte(REGISTER_PROXIMITY_TIMING) & B00011000;
   if (value >> 3 != 1) {
     Serial.print("Error in Proximity Freq, should be \"1\", value = \"");
@@ -83,6 +87,7 @@ void setup() {
     Serial.println("\".");
   }  // if-then bad Proximity change
   Sensor.setProximityFreq(2);
+  Sensor.flush();  // Wait until the change has been written
   value = Sensor.readByte(REGISTER_PROXIMITY_TIMING) & B00011000;
   if (value >> 3 != 2) {
     Serial.print("Error in Proximity Freq, should be \"2\", value = \"");
@@ -91,6 +96,7 @@ void setup() {
   }  // if-then bad Proximity change
 
   Sensor.setAmbientLight(5, 5);
+  Sensor.flush();  // Wait until the change has been written
   value = Sensor.readByte(REGISTER_AMBIENT_PARAM) & B01110111;
   if (value != B1000010) {
     Serial.print("Error in Ambient, should be B1000010, value = \"");
@@ -98,6 +104,7 @@ void setup() {
     Serial.println("\".");
   }  // if-then bad Proximity change
   Sensor.setAmbientLight(3, 2);
+  Sensor.flush();  // Wait until the change has been written
   value = Sensor.readByte(REGISTER_AMBIENT_PARAM) & B01110111;
   if (value != B100001) {
     Serial.print("Error in Ambient Freq, should be B100001, value = \"");
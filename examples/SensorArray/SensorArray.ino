@@ -0,0 +1,97 @@
+/*!
+@file SensorArray.ino
+
+@section SensorArray_intro_section Description
+
+Example program for using the VCNL4010 library with 8 sensors on one I2C bus. All VCNL4010 have the
+same fixed I2C address, so each sensor is connected to one channel of a TCA9548A I2C multiplexer at
+address 0x70. The VCNL4010Array class selects the multiplexer channels and reads all of the sensors
+in one pass without waiting for any single sensor, the sensors measure in parallel. The program
+displays the proximity readings of all sensors along with the number of readings per second and
+the number of multiplexer channel switches made.
+
+@section SensorArray_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section SensorArray_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section SensorArray_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include "VCNL4010Array.h"  // Include the library
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};  ///< Set the baud rate for Serial I/O
+const uint8_t  SENSOR_COUNT{8};       ///< Number of sensors, one per multiplexer channel
+const uint16_t DISPLAY_MS{1000};      ///< Milliseconds between displayed lines
+
+/***************************************************************************************************
+** Declare global variables and instantiate classes                                               **
+***************************************************************************************************/
+VCNL4010WireBus                     Bus;             ///< I2C bus using "Wire"
+VCNL4010Array<SENSOR_COUNT>         Sensors(Bus);    ///< Sensors behind the multiplexer
+VCNL4010ArrayReadings<SENSOR_COUNT> Readings;        ///< Latest readings of all sensors
+uint32_t                            SampleCount{0};  ///< Readings since last display
+uint32_t                            LastDisplay{0};  ///< millis() value of the last display
+
+void setup() {
+  /*!
+    @brief    Arduino method called once at startup to initialize the system
+    @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+              called one time and then control goes to the main "loop()" method, from which control
+              never returns
+    @return   void
+  */
+  Serial.begin(SERIAL_SPEED);  // Start serial port at the specified baud rate
+#ifdef __AVR_ATmega32U4__      // If we are a 32U4 processor, then wait for the interface to start
+  delay(2000);
+#endif
+  Serial.println("Starting VCNL4010 SensorArray program");
+  while (!Sensors.begin(I2C_FAST_MODE)) {  // Loop until at least one sensor is found
+    Serial.println("Error, unable to find any VCNL4010.\nChecking again in 5 seconds...");
+    delay(5000);
+  }  // of if-then we can't initialize or find the devices
+  Serial.print("Sensors found on channels (bitmask): ");
+  Serial.println(Sensors.getPresent(), BIN);
+  for (uint8_t i = 0; i < SENSOR_COUNT; ++i) {
+    Sensors[i].setLEDmA(200);  // Boost power to Proximity sensor
+  }                            // for-next each sensor
+  LastDisplay = millis();
+}  // of method setup()
+
+void loop() {
+  /*!
+    @brief    Arduino method for the main program loop
+    @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+              repeating.
+    @return   void
+  */
+  uint32_t ready = Sensors.collect(Readings);  // One pass over all sensors, never waits
+  for (; ready; ready &= ready - 1) ++SampleCount;
+  if (millis() - LastDisplay >= DISPLAY_MS) {
+    LastDisplay = millis();
+    for (uint8_t i = 0; i < SENSOR_COUNT; ++i) {
+      Serial.print(Readings.proximity[i]);
+      Serial.print(' ');
+    }  // for-next each sensor
+    Serial.print("- readings/s = ");
+    Serial.print(SampleCount * 1000 / DISPLAY_MS);
+    Serial.print(", channel switches = ");
+    Serial.println(Sensors.mux().getSelects());
+    SampleCount = 0;
+  }  // if-then time to display
+}  // of method loop()
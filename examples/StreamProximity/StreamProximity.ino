@@ -0,0 +1,101 @@
+/*!
+@file StreamProximity.ino
+
+@section StreamProximity_intro_section Description
+
+Example program for using the VCNL4010 library to stream every proximity reading at the highest
+rate of 250 readings per second. In streaming mode service() reads each new reading once, checks
+that its two bytes belong to the same measurement, estimates when the device made it and pushes it
+into a ring buffer. The loop takes the readings out in batches and once a second shows how many
+readings arrived, how many were dropped because service() was not called often enough and the
+average time between readings.
+
+@section StreamProximity_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section StreamProximity_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section StreamProximity_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include <VCNL4010.h>  // Include the library
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};  ///< Set the baud rate for Serial I/O
+const uint8_t  BATCH_SIZE{16};        ///< Readings taken from the ring at once
+
+/***************************************************************************************************
+** Declare global variables and instantiate classes                                               **
+***************************************************************************************************/
+VCNL4010             Sensor;             ///< Instantiate the class
+VCNL4010StreamRing   Ring;               ///< Readings waiting to be processed
+VCNL4010StreamSample Batch[BATCH_SIZE];  ///< Readings taken from the ring
+uint32_t             LastReport{0};      ///< millis() value of the last report
+uint32_t             Readings{0};        ///< Readings since the last report
+uint32_t             FirstMicros{0};     ///< Time of the first reading since the last report
+uint32_t             LastMicros{0};      ///< Time of the last reading
+
+void setup() {
+  /*!
+    @brief    Arduino method called once at startup to initialize the system
+    @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+              called one time and then control goes to the main "loop()" method, from which control
+              never returns
+    @return   void
+  */
+  Serial.begin(SERIAL_SPEED);  // Start serial port at the specified baud rate
+#ifdef __AVR_ATmega32U4__      // If we are a 32U4 processor, then wait for the interface to start
+  delay(2000);
+#endif
+  Serial.println("Starting VCNL4010 StreamProximity program");
+  while (!Sensor.begin(I2C_FAST_MODE)) {  // Loop until sensor found
+    Serial.println("Error, unable to find or identify VCNL4010.\nChecking again in 5 seconds...");
+    delay(5000);
+  }  // of if-then we can't initialize or find the device
+  Sensor.setProximityHz(250);  // Fastest rate
+  Sensor.beginStream(Ring);    // Continuous mode, every reading into the ring
+  LastReport = millis();
+}  // of method setup()
+
+void loop() {
+  /*!
+    @brief    Arduino method for the main program loop
+    @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+              repeating.
+    @return   void
+  */
+  Sensor.service();  // Read a new reading if there is one
+  const uint8_t count = Ring.pop(Batch, BATCH_SIZE);
+  for (uint8_t i = 0; i < count; ++i) {
+    if (Readings++ == 0) FirstMicros = Batch[i].micros;
+    LastMicros = Batch[i].micros;
+  }  // for-next each reading in the batch
+  if (millis() - LastReport < 1000) return;
+  LastReport += 1000;
+  Serial.print("Readings ");
+  Serial.print(Readings);
+  Serial.print(", dropped ");
+  Serial.print(Sensor.getStreamDropped());
+  Serial.print(", ring overflows ");
+  Serial.print(Ring.overflows());
+  if (Readings > 1) {
+    Serial.print(", microseconds between readings ");
+    Serial.print((LastMicros - FirstMicros) / (Readings - 1));
+  }  // if-then interval known
+  Serial.println();
+  Readings = 0;
+}  // of method loop()
@@ -0,0 +1,112 @@
+/*!
+@file TrackPresence.ino
+
+@section TrackPresence_intro_section Description
+
+Example program for using the VCNL4010 library to detect presence with as few wakeups of the host
+as possible. The VCNL4010 measures proximity on its own 8 times per second and only raises its INT
+pin when 4 consecutive readings are outside of the low and high threshold window. The
+VCNL4010Tracker class keeps that window centred on a running baseline of the readings, so slow
+changes in the surroundings do not cause interrupts, while an object approaching or leaving does.
+
+The program only does something when the INT pin was raised or, to follow slow drift, once every
+10 seconds. A battery powered device would sleep in between, see the WakeOnInterrupt example for
+how to put an AVR processor to sleep.
+
+The INT pin on the VCNL4010 needs to be connected to a pin that supports interrupts, see
+https://www.arduino.cc/en/Reference/attachInterrupt for the pins that may be used.
+
+@section TrackPresence_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section TrackPresence_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section TrackPresence_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include "VCNL4010Tracker.h"  // Include the library
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SERIAL_SPEED{115200};  ///< Set the baud rate for Serial I/O
+const uint8_t  INTERRUPT_PIN{2};      ///< Pin connected to the VCNL4010 INT pin
+const uint16_t DRIFT_MS{10000};       ///< Milliseconds between baseline updates
+
+/***************************************************************************************************
+** Declare global variables and instantiate classes                                               **
+***************************************************************************************************/
+VCNL4010        Sensor;           ///< Instantiate the class
+VCNL4010Tracker Tracker(Sensor);  ///< Threshold window tracking for the sensor
+uint32_t        LastDrift{0};     ///< millis() value of the last baseline update
+volatile bool   WokenUp{false};   ///< Set by the interrupt routine
+
+void sensorInterrupt() {
+  /*!
+    @brief    Interrupt routine for the VCNL4010 INT pin
+  */
+  Sensor.onInterrupt();
+  WokenUp = true;
+}  // of method sensorInterrupt()
+
+void setup() {
+  /*!
+    @brief    Arduino method called once at startup to initialize the system
+    @details  This is an Arduino IDE method which is called first upon boot or restart. It is only
+              called one time and then control goes to the main "loop()" method, from which control
+              never returns
+    @return   void
+  */
+  Serial.begin(SERIAL_SPEED);  // Start serial port at the specified baud rate
+#ifdef __AVR_ATmega32U4__      // If we are a 32U4 processor, then wait for the interface to start
+  delay(2000);
+#endif
+  Serial.println("Starting VCNL4010 TrackPresence program");
+  while (!Sensor.begin()) {  // Loop until sensor found
+    Serial.println("Error, unable to find or identify VCNL4010.\nChecking again in 5 seconds...");
+    delay(5000);
+  }  // of if-then we can't initialize or find the device
+  Sensor.setLEDmA(100);                 // Proximity LED current
+  Sensor.setProximityHz(8);             // 7.8 measurements per second
+  Sensor.setProximityContinuous(true);  // Device measures on its own
+  Sensor.flush();                       // Wait until the settings are active
+  Tracker.begin(60, 15, 4, 1);          // Window +/-60, move after 15, 4 readings, fast baseline
+  pinMode(INTERRUPT_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(INTERRUPT_PIN), sensorInterrupt, FALLING);
+  Serial.print("Baseline is ");
+  Serial.println(Tracker.getBaseline());
+  LastDrift = millis();
+}  // of method setup()
+
+void loop() {
+  /*!
+    @brief    Arduino method for the main program loop
+    @details  This is the main program for the Arduino IDE, it is an infinite loop and keeps on
+              repeating.
+    @return   void
+  */
+  if (!WokenUp && millis() - LastDrift < DRIFT_MS) return;  // Nothing to do, could sleep here
+  WokenUp   = false;
+  LastDrift = millis();
+  switch (Tracker.service()) {
+    case VCNL4010_TRACK_NEAR: Serial.println("Object approached"); break;
+    case VCNL4010_TRACK_FAR: Serial.println("Object left"); break;
+    case VCNL4010_TRACK_RECENTER:
+      Serial.print("Baseline moved to ");
+      Serial.println(Tracker.getBaseline());
+      break;
+    default: break;
+  }  // of switch on the tracker event
+}  // of method loop()
@@ -0,0 +1,190 @@
+/*!
+@file VCNL4010Benchmark.cpp
+
+@section VCNL4010Benchmark_intro_section Description
+
+Host-side benchmark of the VCNL4010 library. It runs the driver against the VCNL4010Sim simulated
+device, whose bus transactions take the time their bits need at the bus speed, and measures the
+sample rates actually achieved against the configured rates. The sweep covers:\n
+- I2C_STANDARD_MODE, I2C_FAST_MODE, I2C_FAST_MODE_PLUS_MODE and I2C_HIGH_SPEED_MODE
+- All eight setProximityHz() rates
+- All eight ambient light averaging settings, at the highest ambient light rate of 10/s
+- Triggered mode, where service() starts each measurement, and continuous mode\n
+\n
+For each combination the program polls with service() and tryGetProximity()/tryGetAmbientLight()
+for a stretch of virtual time and writes one CSV line to stdout with the achieved proximity and
+ambient light samples per second, the proximity results the device replaced before they were read,
+the fraction of the time the bus was busy and the host CPU time per sample. The CPU time includes
+the simulated device model, so it is an upper bound for the driver's own processing time.\n
+\n
+This file is not part of the Arduino library. It is built and run on Linux from this directory
+with:\n
+    g++ -std=gnu++11 -O2 -I../../src ../../src/VCNL4010*.cpp VCNL4010Benchmark.cpp -o benchmark\n
+    ./benchmark [-d seconds] [-p pollMicros] > results.csv\n
+\n
+"-d" sets the virtual time measured for each combination, default 1 second. "-p" sets the time
+the host spends elsewhere between two service() calls, default 0 for back-to-back polling.
+
+@section VCNL4010Benchmark_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section VCNL4010Benchmark_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section VCNL4010Benchmark_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include <stdio.h>   // printf()
+#include <stdlib.h>  // strtoul()
+#include <time.h>    // clock_gettime()
+
+#include "VCNL4010.h"     // Library under test
+#include "VCNL4010Sim.h"  // Simulated device
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t SPEEDS[]{I2C_STANDARD_MODE, I2C_FAST_MODE, I2C_FAST_MODE_PLUS_MODE,
+                        I2C_HIGH_SPEED_MODE};                    ///< Bus speeds swept
+const uint8_t  PROXIMITY_HZ[]{2, 4, 8, 16, 32, 64, 128, 250};    ///< setProximityHz() values
+const char    *PROXIMITY_RATES[]{"1.95",  "3.90625", "7.8125", "15.625",
+                                 "31.25", "62.5",    "125",    "250"};  ///< Configured rates
+const uint8_t  AVERAGING[]{1, 2, 4, 8, 16, 32, 64, 128};  ///< Ambient light averaging values
+const uint8_t  AMBIENT_RATE{10};                          ///< Ambient light readings per second
+const uint32_t WARMUP_MICROS{100000};                     ///< Virtual time before measuring
+
+/***************************************************************************************************
+** Declare global variables                                                                       **
+***************************************************************************************************/
+uint32_t DurationMicros{1000000};  ///< Virtual time measured for each combination
+uint32_t PollMicros{0};            ///< Time between two service() calls
+
+struct Result {
+  /*!
+   * @struct Result
+   * @brief  Measurements of one combination of settings
+   */
+  uint32_t proximity;     ///< Proximity readings retrieved
+  uint32_t ambient;       ///< Ambient light readings retrieved
+  uint32_t overwrites;    ///< Proximity results replaced before they were read
+  uint32_t busMicros;     ///< Time the bus was busy
+  uint32_t transactions;  ///< Bus transactions made
+  uint64_t cpuNanos;      ///< Host CPU time used
+};                        // of struct Result
+
+uint64_t cpuNanos() {
+  /*!
+    @brief    Returns the CPU time used by the process
+    @return   CPU time in nanoseconds
+  */
+  timespec now;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}  // of method cpuNanos()
+
+void poll(VCNL4010 &sensor, VCNL4010Sim &sim, const uint32_t micros, Result *result) {
+  /*!
+    @brief    Polls the sensor for the given virtual time
+    @param[in] sensor Sensor to poll
+    @param[in] sim Simulated device of the sensor
+    @param[in] micros Virtual time to poll for
+    @param[out] result Readings retrieved are counted here, ignored if nullptr
+  */
+  const uint32_t start = sim.micros();
+  uint16_t       value;
+  while (sim.micros() - start < micros) {
+    sensor.service();
+    if (sensor.tryGetProximity(value) && result) ++result->proximity;
+    if (sensor.tryGetAmbientLight(value) && result) ++result->ambient;
+    if (PollMicros) sim.advance(PollMicros);
+  }  // of while-loop until the time is up
+}  // of method poll()
+
+Result run(const uint32_t speed, const uint8_t proximityHz, const uint8_t averaging,
+           const bool continuous) {
+  /*!
+    @brief    Measures one combination of settings on a newly powered up simulated device
+    @param[in] speed I2C bus speed
+    @param[in] proximityHz Value for setProximityHz()
+    @param[in] averaging Ambient light conversions per reading
+    @param[in] continuous "true" for continuous mode, "false" for triggered mode
+    @return   Measurements
+  */
+  VCNL4010Sim sim;
+  VCNL4010    sensor(sim);
+  Result      result{0, 0, 0, 0, 0, 0};
+  sim.setScene(2000, 100);
+  sim.setNoise(20, 5);
+  sensor.begin(speed);
+  sensor.setProximityHz(proximityHz);
+  sensor.setAmbientLight(AMBIENT_RATE, averaging);
+  sensor.setProximityContinuous(continuous);
+  sensor.setAmbientContinuous(continuous);
+  sensor.flush();
+  poll(sensor, sim, WARMUP_MICROS, nullptr);  // Settle into the steady state
+  const uint32_t busMicros    = sim.getBusMicros();
+  const uint32_t transactions = sim.getTransactions();
+  const uint32_t overwrites   = sim.getProximityOverwrites();
+  const uint64_t cpuStart     = cpuNanos();
+  poll(sensor, sim, DurationMicros, &result);
+  result.cpuNanos     = cpuNanos() - cpuStart;
+  result.busMicros    = sim.getBusMicros() - busMicros;
+  result.transactions = sim.getTransactions() - transactions;
+  result.overwrites   = sim.getProximityOverwrites() - overwrites;
+  return result;
+}  // of method run()
+
+int main(int argc, char *argv[]) {
+  /*!
+    @brief    Runs all combinations and writes the results as CSV to stdout
+    @param[in] argc Number of arguments
+    @param[in] argv Arguments, "-d seconds" and "-p pollMicros"
+    @return   0 on success, 1 for invalid arguments
+  */
+  for (int i = 1; i < argc; ++i) {
+    if (argv[i][0] == '-' && (argv[i][1] == 'd' || argv[i][1] == 'p') && i + 1 < argc) {
+      const uint32_t value = strtoul(argv[i + 1], nullptr, 10);
+      if (argv[i][1] == 'd') {
+        DurationMicros = value * 1000000;
+      } else {
+        PollMicros = value;
+      }  // if-then-else duration
+      ++i;
+    } else {
+      fprintf(stderr, "Usage: %s [-d seconds] [-p pollMicros]\n", argv[0]);
+      return 1;
+    }  // if-then-else known option
+  }    // for-next each argument
+  if (DurationMicros == 0) DurationMicros = 1000000;
+  const double seconds = DurationMicros / 1e6;
+  printf("mode,i2c_hz,proximity_hz,ambient_hz,ambient_averaging,proximity_per_s,ambient_per_s,"
+         "proximity_overwrites,bus_utilization,transactions_per_s,cpu_ns_per_sample\n");
+  for (uint8_t mode = 0; mode < 2; ++mode) {
+    for (const uint32_t speed : SPEEDS) {
+      for (uint8_t rate = 0; rate < sizeof(PROXIMITY_HZ); ++rate) {
+        for (const uint8_t averaging : AVERAGING) {
+          const Result   result  = run(speed, PROXIMITY_HZ[rate], averaging, mode);
+          const uint32_t samples = result.proximity + result.ambient;
+          printf("%s,%u,%s,%u,%u,%.2f,%.2f,%u,%.4f,%.1f,%.0f\n",
+                 mode ? "continuous" : "triggered", speed, PROXIMITY_RATES[rate], AMBIENT_RATE,
+                 averaging, result.proximity / seconds, result.ambient / seconds,
+                 result.overwrites, result.busMicros / (double)DurationMicros,
+                 result.transactions / seconds,
+                 samples ? (double)result.cpuNanos / samples : 0.0);
+        }  // for-next each averaging
+      }    // for-next each proximity rate
+    }      // for-next each speed
+  }        // for-next each mode
+  return 0;
+}  // of method main()
@@ -0,0 +1,141 @@
+/*!
+@file VCNL4010Consumer.cpp
+
+@section VCNL4010Consumer_intro_section Description
+
+Example consumer of the VCNL4010 daemon, see VCNL4010Daemon.cpp. It maps the shared memory object
+read-only, checks the header and then follows the ring, printing each sample with its age in
+microseconds. Samples are taken straight from the shared memory with vcnl4010ShmRead(), without
+system calls; the program only sleeps while no new sample is there. At the end it prints the number
+of samples read, the samples lost because this program fell more than a ring behind, and the gaps in
+the measurement numbers, which are measurements that the daemon could not read in time.\n
+\n
+This file is not part of the Arduino library. It is built on Linux from this directory with:\n
+    g++ -std=gnu++11 -O2 VCNL4010Consumer.cpp -o vcnl4010c -lrt\n
+    ./vcnl4010c [-n /vcnl4010] [-c count] [-q]\n
+\n
+"-n" sets the shared memory object name, "-c" stops after the given number of samples, by default
+the program runs until the daemon stops, and "-q" prints only the totals.
+
+@section VCNL4010Consumer_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section VCNL4010Consumer_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section VCNL4010Consumer_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include <fcntl.h>     // O_RDONLY
+#include <signal.h>    // kill()
+#include <stdio.h>     // printf()
+#include <stdlib.h>    // strtoull()
+#include <string.h>    // strcmp()
+#include <sys/mman.h>  // shm_open(), mmap()
+#include <sys/stat.h>  // fstat()
+#include <time.h>      // clock_gettime()
+#include <unistd.h>    // close(), usleep()
+
+#include "VCNL4010Shm.h"  // Shared memory layout
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t IDLE_MICROS{500};  ///< Sleep while no new sample is there
+
+int main(int argc, char *argv[]) {
+  /*!
+    @brief    Maps the shared memory object and reads samples until the count is reached or the
+              daemon stops
+    @param[in] argc Number of arguments
+    @param[in] argv Arguments, see the file description
+    @return   0 on success, 1 on errors or invalid arguments
+  */
+  const char *name{VCNL4010_SHM_NAME};
+  uint64_t    count{0};
+  bool        quiet{false};
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-q") == 0) {
+      quiet = true;
+    } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      name = argv[++i];
+    } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+      count = strtoull(argv[++i], nullptr, 10);
+    } else {
+      fprintf(stderr, "Usage: %s [-n /vcnl4010] [-c count] [-q]\n", argv[0]);
+      return 1;
+    }  // if-then-else known option
+  }    // for-next each argument
+  const int fd = shm_open(name, O_RDONLY, 0);
+  if (fd < 0) {
+    perror("Cannot open the shared memory object");
+    return 1;
+  }  // if-then daemon not running
+  struct stat info;
+  if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(VCNL4010ShmHeader)) {
+    fprintf(stderr, "Shared memory object is too small\n");
+    return 1;
+  }  // if-then too small
+  const void *memory = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);  // The mapping stays valid
+  if (memory == MAP_FAILED) {
+    perror("Cannot map the shared memory object");
+    return 1;
+  }  // if-then cannot map
+  const VCNL4010ShmHeader *header = static_cast<const VCNL4010ShmHeader *>(memory);
+  if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != VCNL4010_SHM_MAGIC ||
+      header->version != VCNL4010_SHM_VERSION || header->slotSize != sizeof(VCNL4010ShmSlot) ||
+      header->headerSize + (uint64_t)header->capacity * header->slotSize > (uint64_t)info.st_size) {
+    fprintf(stderr, "Shared memory object has an unknown layout\n");
+    return 1;
+  }  // if-then unknown layout
+  printf("Daemon %u, %u slots, %u proximity readings/s\n", header->pid, header->capacity,
+         header->proximityHz);
+  uint64_t        next = vcnl4010ShmHead(header) + 1;  // Start with the next new sample
+  uint64_t        read{0}, lost{0}, gaps{0};
+  uint32_t        lastSequence{0};
+  VCNL4010ShmSlot sample;
+  while (count == 0 || read < count) {
+    const uint64_t head = vcnl4010ShmHead(header);
+    if (next > head) {
+      if (kill(header->pid, 0) != 0) break;  // Daemon has stopped
+      usleep(IDLE_MICROS);
+      continue;
+    }  // if-then no new sample
+    if (head - next >= header->capacity) {
+      lost += head - next + 1 - header->capacity;  // Already overwritten
+      next = head + 1 - header->capacity;
+    }  // if-then fell behind
+    if (!vcnl4010ShmRead(header, next, sample)) {
+      ++lost;  // Overwritten while being copied
+      ++next;
+      continue;
+    }  // if-then overwritten
+    if (read && sample.sequence != lastSequence + 1) gaps += sample.sequence - lastSequence - 1;
+    lastSequence = sample.sequence;
+    ++read;
+    ++next;
+    if (!quiet) {
+      timespec now;
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      const uint64_t nanos = (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+      printf("%10u %5u %5u %8lld us\n", sample.sequence, sample.proximity, sample.ambient,
+             (long long)(nanos - sample.nanos) / 1000);
+    }  // if-then print each sample
+  }    // of while-loop until done
+  printf("read %llu, lost %llu, gaps %llu, dropped by the daemon %llu\n", (unsigned long long)read,
+         (unsigned long long)lost, (unsigned long long)gaps,
+         (unsigned long long)__atomic_load_n(&header->dropped, __ATOMIC_RELAXED));
+  return 0;
+}  // of method main()
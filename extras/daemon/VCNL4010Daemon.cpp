@@ -0,0 +1,467 @@
+/*!
+@file VCNL4010Daemon.cpp
+
+@section VCNL4010Daemon_intro_section Description
+
+Linux daemon which owns a VCNL4010 and shares its readings with any number of processes. The
+daemon runs the driver in streaming mode, see VCNL4010::beginStream(), with the proximity sensor in
+continuous mode at the rate set with "-r" and the ambient light sensor in continuous mode. Every
+proximity reading is written with its estimated time, its measurement number and the latest ambient
+light reading into a ring in a POSIX shared memory object, whose layout is described in
+VCNL4010Shm.h. Consumers map the object and read the samples without copies through the kernel and
+without system calls per sample, see VCNL4010Consumer.cpp.\n
+\n
+The configuration is changed at runtime through a Unix domain stream socket, one command per line,
+each answered by a line starting with "ok" or "error":\n
+- "rate Hz": proximity readings per second, 2, 4, 8, 16, 32, 64, 128 or 250
+- "led mA": IR LED current, 0 to 200 in steps of 10
+- "ambient rate averaging": ambient light readings per second and conversions per reading
+- "status": answers with the samples written, the dropped measurements and the settings\n
+\n
+e.g. with: echo "rate 64" | nc -U /tmp/vcnl4010.sock\n
+\n
+With "-f" the daemon runs on a VCNL4010Sim simulated device instead of the I2C bus, whose clock
+follows the real time, so the daemon and its consumers can be tested without hardware.\n
+\n
+This file is not part of the Arduino library. It is built on Linux from this directory with:\n
+    g++ -std=gnu++11 -O2 -I../../src ../../src/VCNL4010*.cpp VCNL4010Daemon.cpp -o vcnl4010d
+        -lrt\n
+    ./vcnl4010d [-b /dev/i2c-1] [-f] [-n /vcnl4010] [-s /tmp/vcnl4010.sock] [-r Hz] [-l mA]
+        [-c capacity]\n
+\n
+"-b" sets the i2c-dev device, "-f" selects the simulated device, "-n" the shared memory object
+name, "-s" the control socket path, "-r" the initial proximity rate, default 250, "-l" the initial
+LED current, default 20 mA, and "-c" the number of slots in the ring, a power of 2, default 1024.
+The daemon runs until it receives SIGINT or SIGTERM, then removes the shared memory object and the
+socket.
+
+@section VCNL4010Daemon_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section VCNL4010Daemon_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section VCNL4010Daemon_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include <errno.h>       // errno
+#include <fcntl.h>       // O_CREAT, O_RDWR
+#include <poll.h>        // poll()
+#include <signal.h>      // signal()
+#include <stdio.h>       // printf(), snprintf()
+#include <stdlib.h>      // strtoul()
+#include <string.h>      // memset(), strncmp()
+#include <sys/mman.h>    // shm_open(), mmap()
+#include <sys/socket.h>  // socket(), bind(), listen(), accept()
+#include <sys/un.h>      // sockaddr_un
+#include <time.h>        // clock_gettime()
+#include <unistd.h>      // close(), ftruncate(), getpid()
+
+#include "VCNL4010.h"     // Sensor class
+#include "VCNL4010Shm.h"  // Shared memory layout
+#include "VCNL4010Sim.h"  // Simulated device
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint8_t  MAX_CLIENTS{8};           ///< Control connections open at the same time
+const uint8_t  COMMAND_LENGTH{64};       ///< Longest command line
+const uint8_t  BATCH_SIZE{16};           ///< Readings taken from the stream ring at once
+const uint32_t MAX_CAPACITY{1UL << 20};  ///< Most slots in the shared memory ring
+
+/***************************************************************************************************
+** Declare global variables                                                                       **
+***************************************************************************************************/
+const char            *BusDevice{"/dev/i2c-1"};           ///< i2c-dev device
+const char            *ShmName{VCNL4010_SHM_NAME};        ///< Shared memory object name
+const char            *SocketPath{"/tmp/vcnl4010.sock"};  ///< Control socket path
+bool                   Fake{false};                       ///< Use the simulated device
+unsigned long          Capacity{1024};                    ///< Slots in the ring
+unsigned long          ProximityHz{250};                  ///< Initial proximity rate
+unsigned long          LEDmA{20};                         ///< Initial LED current
+volatile sig_atomic_t  Running{1};                        ///< Cleared by SIGINT and SIGTERM
+VCNL4010ShmHeader     *Header{nullptr};                   ///< Mapped shared memory object
+VCNL4010ShmSlot       *Slots{nullptr};                    ///< Ring in the shared memory object
+
+struct Client {
+  /*!
+   * @struct Client
+   * @brief  Open control connection
+   */
+  int     fd;                    ///< Socket, -1 when not in use
+  uint8_t used;                  ///< Characters in the line buffer
+  char    line[COMMAND_LENGTH];  ///< Command line received so far
+};                               // of struct Client
+
+void stop(int signal) {
+  /*!
+    @brief    Signal handler, ends the main loop
+    @param[in] signal Signal number
+  */
+  (void)signal;
+  Running = 0;
+}  // of method stop()
+
+uint64_t monotonicNanos() {
+  /*!
+    @brief    Returns the CLOCK_MONOTONIC time
+    @return   Time in nanoseconds
+  */
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}  // of method monotonicNanos()
+
+uint16_t simScene(const uint32_t micros, const bool proximity, void *context) {
+  /*!
+    @brief    Scene of the simulated device, an object which comes near for 2 of every 5 seconds
+    @param[in] micros Simulated time
+    @param[in] proximity "true" for the proximity reading, "false" for the ambient light reading
+    @param[in] context Not used
+    @return   Reading without noise
+  */
+  (void)context;
+  if (!proximity) return 200 + (micros / 100000) % 50;  // Slowly changing light
+  return (micros / 1000000) % 5 < 2 ? 12000 : 2100;
+}  // of method simScene()
+
+bool parseNumber(const char *text, unsigned long &number) {
+  /*!
+    @brief    Converts a command line argument to a number
+    @param[in] text Argument
+    @param[out] number Value of the argument
+    @return   "false" unless the whole argument is a decimal number
+  */
+  char *end;
+  errno  = 0;
+  number = strtoul(text, &end, 10);
+  return *text >= '0' && *text <= '9' && !*end && !errno;
+}  // of method parseNumber()
+
+bool isRate(const unsigned long hz) {
+  /*!
+    @brief    Checks a proximity rate given on the command line or through the socket
+    @param[in] hz Proximity readings per second
+    @return   "true" if the sensor supports the rate
+  */
+  return hz <= 255 && VCNL4010Encode::isProximityRate(hz);
+}  // of method isRate()
+
+bool isLEDCurrent(const unsigned long mA) {
+  /*!
+    @brief    Checks an LED current given on the command line or through the socket
+    @param[in] mA IR LED current
+    @return   "true" if the sensor supports the current
+  */
+  return mA <= 200 && mA % 10 == 0;
+}  // of method isLEDCurrent()
+
+bool createShm() {
+  /*!
+    @brief    Creates and maps the shared memory object and writes its header
+    @return   "true" on success
+  */
+  const size_t size = sizeof(VCNL4010ShmHeader) + Capacity * sizeof(VCNL4010ShmSlot);
+  const int    fd   = shm_open(ShmName, O_CREAT | O_RDWR | O_TRUNC, 0644);
+  if (fd < 0) return false;
+  if (ftruncate(fd, size) != 0) {
+    close(fd);
+    return false;
+  }  // if-then cannot set the size
+  void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);  // The mapping stays valid
+  if (memory == MAP_FAILED) return false;
+  memset(memory, 0, size);
+  Header             = static_cast<VCNL4010ShmHeader *>(memory);
+  Slots              = reinterpret_cast<VCNL4010ShmSlot *>(Header + 1);
+  Header->version    = VCNL4010_SHM_VERSION;
+  Header->headerSize = sizeof(VCNL4010ShmHeader);
+  Header->slotSize   = sizeof(VCNL4010ShmSlot);
+  Header->capacity   = Capacity;
+  Header->pid        = getpid();
+  __atomic_store_n(&Header->magic, VCNL4010_SHM_MAGIC, __ATOMIC_RELEASE);  // Header complete
+  return true;
+}  // of method createShm()
+
+void writeSample(const uint64_t nanos, const uint32_t sequence, const uint16_t proximity,
+                 const uint16_t ambient) {
+  /*!
+    @brief    Writes the next sample into the ring and publishes it
+    @param[in] nanos CLOCK_MONOTONIC time of the measurement
+    @param[in] sequence Measurement number
+    @param[in] proximity Proximity reading
+    @param[in] ambient Latest ambient light reading
+  */
+  const uint64_t   index = Header->head + 1;  // Only the daemon writes the head
+  VCNL4010ShmSlot *slot  = Slots + ((index - 1) & (Capacity - 1));
+  __atomic_store_n(&slot->index, 0, __ATOMIC_RELAXED);  // Consumers reject the slot from here
+  __atomic_thread_fence(__ATOMIC_RELEASE);              // before the fields change
+  __atomic_store_n(&slot->nanos, nanos, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->sequence, sequence, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->proximity, proximity, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->ambient, ambient, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->index, index, __ATOMIC_RELEASE);
+  __atomic_store_n(&Header->head, index, __ATOMIC_RELEASE);
+}  // of method writeSample()
+
+void setConfig(const uint8_t proximityHz, const uint8_t ledmA, const uint8_t ambientRate,
+               const uint8_t ambientAveraging) {
+  /*!
+    @brief    Stores the settings in the header and counts the change
+    @param[in] proximityHz Proximity readings per second
+    @param[in] ledmA IR LED current
+    @param[in] ambientRate Ambient light readings per second
+    @param[in] ambientAveraging Ambient light conversions per reading
+  */
+  __atomic_store_n(&Header->proximityHz, proximityHz, __ATOMIC_RELAXED);
+  __atomic_store_n(&Header->ledMilliamps, ledmA, __ATOMIC_RELAXED);
+  __atomic_store_n(&Header->ambientRate, ambientRate, __ATOMIC_RELAXED);
+  __atomic_store_n(&Header->ambientAveraging, ambientAveraging, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&Header->configVersion, 1, __ATOMIC_RELEASE);
+}  // of method setConfig()
+
+void command(VCNL4010 &sensor, const char *line, char *reply, const size_t size) {
+  /*!
+    @brief    Carries out a control command
+    @param[in] sensor Sensor owned by the daemon
+    @param[in] line Command line without the line end
+    @param[out] reply Answer without the line end
+    @param[in] size Size of the answer buffer
+  */
+  unsigned first{0}, second{0};
+  if (sscanf(line, "rate %u", &first) == 1) {
+    if (!isRate(first)) {
+      snprintf(reply, size, "error rate must be 2, 4, 8, 16, 32, 64, 128 or 250");
+      return;
+    }  // if-then unsupported rate
+    sensor.setProximityHz(first);
+    setConfig(first, Header->ledMilliamps, Header->ambientRate, Header->ambientAveraging);
+  } else if (sscanf(line, "led %u", &first) == 1) {
+    if (!isLEDCurrent(first)) {
+      snprintf(reply, size, "error LED current must be 0 to 200 mA in steps of 10");
+      return;
+    }  // if-then unsupported current
+    sensor.setLEDmA(first);
+    setConfig(Header->proximityHz, first, Header->ambientRate, Header->ambientAveraging);
+  } else if (sscanf(line, "ambient %u %u", &first, &second) == 2) {
+    if (first > 255 || !VCNL4010Encode::isAmbientRate(first) || second > 128 ||
+        !VCNL4010Encode::isPowerOf2(second)) {
+      snprintf(reply, size, "error rate must be 1-6, 8 or 10 and averaging 1, 2, 4 to 128");
+      return;
+    }  // if-then unsupported setting
+    sensor.setAmbientLight(first, second);
+    setConfig(Header->proximityHz, Header->ledMilliamps, first, second);
+  } else if (strncmp(line, "status", 6) == 0) {
+    snprintf(reply, size, "ok head %llu dropped %llu rate %u led %u ambient %u %u",
+             (unsigned long long)Header->head, (unsigned long long)Header->dropped,
+             Header->proximityHz, Header->ledMilliamps, Header->ambientRate,
+             Header->ambientAveraging);
+    return;
+  } else {
+    snprintf(reply, size, "error unknown command");
+    return;
+  }  // if-then-else command
+  snprintf(reply, size, "ok");
+}  // of method command()
+
+int openSocket() {
+  /*!
+    @brief    Creates the non-blocking control socket
+    @return   Socket, -1 on error
+  */
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (strlen(SocketPath) >= sizeof(address.sun_path)) return -1;
+  strcpy(address.sun_path, SocketPath);
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if (fd < 0) return -1;
+  unlink(SocketPath);  // Left over from a previous run
+  if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+      listen(fd, MAX_CLIENTS) != 0) {
+    close(fd);
+    return -1;
+  }  // if-then cannot listen
+  return fd;
+}  // of method openSocket()
+
+void serveClients(VCNL4010 &sensor, const int listener, Client *clients, pollfd *fds) {
+  /*!
+    @brief    Accepts new control connections and answers complete command lines
+    @param[in] sensor Sensor owned by the daemon
+    @param[in] listener Control socket
+    @param[in,out] clients Control connections
+    @param[in] fds Result of poll(), the listener first and then one entry per client
+  */
+  if (fds[0].revents & POLLIN) {
+    const int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+    uint8_t   i{0};
+    while (i < MAX_CLIENTS && clients[i].fd >= 0) ++i;
+    if (i < MAX_CLIENTS) {
+      clients[i].fd   = fd;
+      clients[i].used = 0;
+    } else if (fd >= 0) {
+      close(fd);  // Too many connections
+    }             // if-then-else free entry
+  }               // if-then new connection
+  for (uint8_t i = 0; i < MAX_CLIENTS; ++i) {
+    Client &client = clients[i];
+    if (client.fd < 0 || !(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+    const ssize_t length =
+        read(client.fd, client.line + client.used, COMMAND_LENGTH - 1 - client.used);
+    if (length <= 0) {
+      close(client.fd);
+      client.fd = -1;
+      continue;
+    }  // if-then connection closed
+    client.used += length;
+    char *end;
+    while ((end = static_cast<char *>(memchr(client.line, '\n', client.used)))) {
+      *end = '\0';
+      if (end > client.line && end[-1] == '\r') end[-1] = '\0';
+      char reply[96];
+      command(sensor, client.line, reply, sizeof(reply) - 1);
+      strcat(reply, "\n");
+      if (write(client.fd, reply, strlen(reply)) < 0) break;
+      client.used -= end + 1 - client.line;
+      memmove(client.line, end + 1, client.used);
+    }                                                        // of while-loop complete lines
+    if (client.used == COMMAND_LENGTH - 1) client.used = 0;  // Discard an overlong line
+  }                                                          // for-next each client
+}  // of method serveClients()
+
+int main(int argc, char *argv[]) {
+  /*!
+    @brief    Starts the sensor, creates the shared memory object and the control socket and runs
+              the acquisition loop until stopped
+    @param[in] argc Number of arguments
+    @param[in] argv Arguments, see the file description
+    @return   0 on success, 1 on errors or invalid arguments
+  */
+  for (int i = 1; i < argc; ++i) {
+    const char option = argv[i][0] == '-' ? argv[i][1] : 0;
+    if (option == 'f') {
+      Fake = true;
+    } else if (option && strchr("bnsrlc", option) && i + 1 < argc) {
+      const char *value = argv[++i];
+      bool        valid{true};
+      if (option == 'b') BusDevice = value;
+      if (option == 'n') ShmName = value;
+      if (option == 's') SocketPath = value;
+      if (option == 'r') valid = parseNumber(value, ProximityHz);
+      if (option == 'l') valid = parseNumber(value, LEDmA);
+      if (option == 'c') valid = parseNumber(value, Capacity);
+      if (!valid) {
+        fprintf(stderr, "Invalid number \"%s\" for -%c\n", value, option);
+        return 1;
+      }  // if-then not a number
+    } else {
+      fprintf(stderr,
+              "Usage: %s [-b /dev/i2c-1] [-f] [-n /vcnl4010] [-s /tmp/vcnl4010.sock] [-r Hz] "
+              "[-l mA] [-c capacity]\n",
+              argv[0]);
+      return 1;
+    }  // if-then-else known option
+  }    // for-next each argument
+  if (!isRate(ProximityHz)) {
+    fprintf(stderr, "Rate must be 2, 4, 8, 16, 32, 64, 128 or 250\n");
+    return 1;
+  }  // if-then unsupported rate
+  if (!isLEDCurrent(LEDmA)) {
+    fprintf(stderr, "LED current must be 0 to 200 mA in steps of 10\n");
+    return 1;
+  }  // if-then unsupported current
+  if (Capacity < 2 || Capacity > MAX_CAPACITY || (Capacity & (Capacity - 1))) {
+    fprintf(stderr, "Capacity must be a power of 2 from 2 to %lu\n", (unsigned long)MAX_CAPACITY);
+    return 1;
+  }  // if-then invalid capacity
+  VCNL4010LinuxBus linuxBus(BusDevice);
+  VCNL4010Sim      sim;
+  sim.setScene(simScene, nullptr);
+  sim.setNoise(40, 4);
+  VCNL4010 sensor(Fake ? static_cast<VCNL4010Bus &>(sim) : linuxBus);
+  if (!sensor.begin(I2C_FAST_MODE)) {
+    fprintf(stderr, "VCNL4010 not found on %s\n", Fake ? "the simulated bus" : BusDevice);
+    return 1;
+  }  // if-then sensor not found
+  if (!createShm()) {
+    perror("Cannot create the shared memory object");
+    return 1;
+  }  // if-then no shared memory
+  const int listener = openSocket();
+  if (listener < 0) {
+    perror("Cannot create the control socket");
+    shm_unlink(ShmName);
+    return 1;
+  }  // if-then no socket
+  signal(SIGINT, stop);
+  signal(SIGTERM, stop);
+  signal(SIGPIPE, SIG_IGN);  // Clients may go away before the answer
+  VCNL4010StreamRing   ring;
+  VCNL4010StreamSample batch[BATCH_SIZE];
+  Client               clients[MAX_CLIENTS];
+  pollfd               fds[MAX_CLIENTS + 1];
+  for (Client &client : clients) client.fd = -1;
+  sensor.setLEDmA(LEDmA);
+  sensor.setAmbientLight(2, 32);
+  sensor.setAmbientContinuous(true);
+  sensor.setProximityHz(ProximityHz);
+  sensor.beginStream(ring);
+  setConfig(ProximityHz, LEDmA, 2, 32);
+  uint64_t lastNanos = monotonicNanos();
+  uint32_t sequence{0};       // Measurement number extended to 32 bits
+  uint16_t lastSequence{0};   // Last 16 bit measurement number from the driver
+  uint16_t ambient{0};        // Latest ambient light reading
+  uint64_t dropped{0};        // Lost readings extended to 64 bits
+  uint32_t lastMissed{0};     // Last count of readings missed by the driver
+  uint16_t lastOverflows{0};  // Last count of readings lost in the full stream ring
+  while (Running) {
+    const uint32_t period =
+        VCNL4010Encode::proximityPeriod(VCNL4010Encode::proximityRate(Header->proximityHz));
+    fds[0] = {listener, POLLIN, 0};
+    for (uint8_t i = 0; i < MAX_CLIENTS; ++i) fds[i + 1] = {clients[i].fd, POLLIN, 0};
+    const int timeout = period / 4000 ? period / 4000 : 1;  // Poll 4 times per measurement
+    if (poll(fds, MAX_CLIENTS + 1, timeout) > 0) serveClients(sensor, listener, clients, fds);
+    const uint64_t nanos = monotonicNanos();
+    if (Fake) sim.advance((nanos - lastNanos) / 1000);  // Simulated clock follows the real time
+    lastNanos = nanos;
+    sensor.service();
+    sensor.tryGetAmbientLight(ambient);
+    const uint32_t now = sensor.getMicros();
+    uint8_t        count;
+    while ((count = ring.pop(batch, BATCH_SIZE))) {
+      for (uint8_t i = 0; i < count; ++i) {
+        sequence += (uint16_t)(batch[i].sequence - lastSequence);
+        lastSequence = batch[i].sequence;
+        writeSample(nanos - (uint64_t)(now - batch[i].micros) * 1000, sequence,
+                    batch[i].proximity, ambient);
+      }  // for-next each reading
+    }    // of while-loop readings waiting
+    const uint32_t missed    = sensor.getStreamDropped();
+    const uint16_t overflows = ring.overflows();
+    dropped += (uint32_t)(missed - lastMissed) + (uint16_t)(overflows - lastOverflows);
+    lastMissed    = missed;  // Both counters wrap, only their increments are added
+    lastOverflows = overflows;
+    __atomic_store_n(&Header->dropped, dropped, __ATOMIC_RELAXED);
+  }  // of while-loop until stopped
+  sensor.endStream();
+  for (Client &client : clients) {
+    if (client.fd >= 0) close(client.fd);
+  }  // for-next each client
+  close(listener);
+  unlink(SocketPath);
+  shm_unlink(ShmName);
+  printf("Stopped after %llu samples\n", (unsigned long long)Header->head);
+  return 0;
+}  // of method main()
@@ -0,0 +1,131 @@
+/*! @file VCNL4010Shm.h
+
+@section VCNL4010Shm_intro_section Description
+
+Shared memory layout of the VCNL4010 daemon, see VCNL4010Daemon.cpp. The daemon creates a POSIX
+shared memory object, by default "/vcnl4010", made of a 64 byte VCNL4010ShmHeader followed by
+"capacity" VCNL4010ShmSlot entries of 24 bytes each. All fields are in the byte order of the host
+and at their natural alignment, so consumers written in other languages can map the object from
+the tables below:\n
+\n
+| Offset | Size | Field            | Contents                                                 |
+| ------ | ---- | ---------------- | -------------------------------------------------------- |
+| 0      | 4    | magic            | VCNL4010_SHM_MAGIC, the characters "VCNL"                |
+| 4      | 2    | version          | VCNL4010_SHM_VERSION                                     |
+| 6      | 2    | headerSize       | 64, offset of the first slot                             |
+| 8      | 4    | slotSize         | 24                                                       |
+| 12     | 4    | capacity         | Number of slots, a power of 2                            |
+| 16     | 8    | head             | Number of samples written so far                         |
+| 24     | 8    | dropped          | Measurements made by the device but not read in time     |
+| 32     | 4    | pid              | Process ID of the daemon                                 |
+| 36     | 4    | configVersion    | Incremented after each configuration change              |
+| 40     | 2    | proximityHz      | Proximity readings/s as set with setProximityHz()        |
+| 42     | 2    | ledMilliamps     | IR LED current as set with setLEDmA()                    |
+| 44     | 1    | ambientRate      | Ambient light readings/s as set with setAmbientLight()   |
+| 45     | 1    | ambientAveraging | Ambient light conversions averaged per reading           |
+| 46     | 18   | reserved         | 0                                                        |
+\n
+Sample number "n", counting from 1, is in slot (n - 1) & (capacity - 1). Each slot holds:\n
+\n
+| Offset | Size | Field     | Contents                                                         |
+| ------ | ---- | --------- | ---------------------------------------------------------------- |
+| 0      | 8    | index     | Sample number "n", 0 or another number while the slot is written |
+| 8      | 8    | nanos     | Estimated CLOCK_MONOTONIC time of the measurement in nanoseconds |
+| 16     | 4    | sequence  | Measurement number, gaps are measurements that were dropped      |
+| 20     | 2    | proximity | Proximity reading                                                |
+| 22     | 2    | ambient   | Latest ambient light reading                                     |
+\n
+The daemon writes a slot by storing 0 into "index", then the other fields, then the sample number
+into "index", and then stores the new "head", with release ordering between the steps. A consumer
+keeps the number of the last sample it took, reads "head" with acquire ordering and copies each new
+slot with vcnl4010ShmRead(), which checks "index" before and after copying the slot. If the daemon
+has already overwritten the slot the copy fails, and the consumer has fallen more than "capacity"
+samples behind. Reading needs no system calls and no locks, and the daemon never waits for
+consumers.
+
+See main library header file for details
+*/
+#ifndef VCNL4010Shm_h
+/*! @brief Guard code definition for the VCNL4010Shm header */
+#define VCNL4010Shm_h
+#include <stdint.h>  // Fixed width integer types
+
+const uint32_t VCNL4010_SHM_MAGIC{0x4C4E4356};    ///< "VCNL" in little endian
+const uint16_t VCNL4010_SHM_VERSION{1};           ///< Layout version
+const char     VCNL4010_SHM_NAME[]{"/vcnl4010"};  ///< Default shared memory object name
+
+struct VCNL4010ShmHeader {
+  /*!
+   * @struct VCNL4010ShmHeader
+   * @brief  Header at the start of the shared memory object
+   */
+  uint32_t magic;             ///< VCNL4010_SHM_MAGIC
+  uint16_t version;           ///< VCNL4010_SHM_VERSION
+  uint16_t headerSize;        ///< Size of this header, offset of the first slot
+  uint32_t slotSize;          ///< Size of a slot
+  uint32_t capacity;          ///< Number of slots, a power of 2
+  uint64_t head;              ///< Samples written so far
+  uint64_t dropped;           ///< Measurements not read in time
+  uint32_t pid;               ///< Process ID of the daemon
+  uint32_t configVersion;     ///< Incremented after each configuration change
+  uint16_t proximityHz;       ///< Proximity readings per second
+  uint16_t ledMilliamps;      ///< IR LED current
+  uint8_t  ambientRate;       ///< Ambient light readings per second
+  uint8_t  ambientAveraging;  ///< Ambient light conversions per reading
+  uint8_t  reserved[18];      ///< Set to 0
+};                            // of struct VCNL4010ShmHeader
+
+struct VCNL4010ShmSlot {
+  /*!
+   * @struct VCNL4010ShmSlot
+   * @brief  One sample in the shared memory ring
+   */
+  uint64_t index;      ///< Sample number, 0 while being written
+  uint64_t nanos;      ///< CLOCK_MONOTONIC time of the measurement
+  uint32_t sequence;   ///< Measurement number
+  uint16_t proximity;  ///< Proximity reading
+  uint16_t ambient;    ///< Latest ambient light reading
+};                     // of struct VCNL4010ShmSlot
+
+static_assert(sizeof(VCNL4010ShmHeader) == 64, "Header layout must be 64 bytes");
+static_assert(sizeof(VCNL4010ShmSlot) == 24, "Slot layout must be 24 bytes");
+
+inline const VCNL4010ShmSlot *vcnl4010ShmSlots(const VCNL4010ShmHeader *header) {
+  /*!
+    @brief     Returns the first slot of the ring
+    @param[in] header Mapped shared memory object
+    @return    Pointer to the first slot
+  */
+  return reinterpret_cast<const VCNL4010ShmSlot *>(reinterpret_cast<const uint8_t *>(header) +
+                                                   header->headerSize);
+}  // of function vcnl4010ShmSlots()
+
+inline uint64_t vcnl4010ShmHead(const VCNL4010ShmHeader *header) {
+  /*!
+    @brief     Returns the number of samples written so far
+    @param[in] header Mapped shared memory object
+    @return    Number of the newest sample, 0 if there is none
+  */
+  return __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+}  // of function vcnl4010ShmHead()
+
+inline bool vcnl4010ShmRead(const VCNL4010ShmHeader *header, const uint64_t index,
+                            VCNL4010ShmSlot &sample) {
+  /*!
+    @brief     Copies sample number "index" from the ring
+    @param[in] header Mapped shared memory object
+    @param[in] index Sample number, from 1 up to vcnl4010ShmHead()
+    @param[out] sample Copy of the slot
+    @return    "false" if the slot no longer or not yet holds sample "index"
+  */
+  const VCNL4010ShmSlot *slot = vcnl4010ShmSlots(header) + ((index - 1) & (header->capacity - 1));
+  if (__atomic_load_n(&slot->index, __ATOMIC_ACQUIRE) != index) return false;
+  sample.nanos     = __atomic_load_n(&slot->nanos, __ATOMIC_RELAXED);
+  sample.sequence  = __atomic_load_n(&slot->sequence, __ATOMIC_RELAXED);
+  sample.proximity = __atomic_load_n(&slot->proximity, __ATOMIC_RELAXED);
+  sample.ambient   = __atomic_load_n(&slot->ambient, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);  // Copy must be complete before the index is checked
+  sample.index = __atomic_load_n(&slot->index, __ATOMIC_RELAXED);
+  return sample.index == index;
+}  // of function vcnl4010ShmRead()
+#endif
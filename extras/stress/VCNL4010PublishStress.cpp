@@ -0,0 +1,213 @@
+/*!
+@file VCNL4010PublishStress.cpp
+
+@section VCNL4010PublishStress_intro_section Description
+
+Host-side stress test of VCNL4010Publisher and the bus lock hooks. One owner thread runs the driver
+against the VCNL4010Sim simulated device with the proximity sensor in continuous mode at 250
+readings/s and publishes every new reading with publish(). Before each publication the owner stores
+the reading in a table indexed by its sequence number. Any number of reader threads call read() in
+a tight loop and compare each reading with the table entry of its sequence number, so a torn or
+mixed-up reading is detected. The sequence numbers each reader sees must never decrease.\n
+\n
+A further thread uses the same simulated bus for another device, holding the same std::mutex as
+the lock hooks installed with VCNL4010Bus::setLock(), while the owner keeps the sensor busy.\n
+\n
+At the end the program prints the number of publications, the reads and the average time per read
+of each reader, and the number of errors. It returns 1 if any error was found.\n
+\n
+This file is not part of the Arduino library. It is built and run on Linux from this directory
+with:\n
+    g++ -std=gnu++11 -O2 -pthread -I../../src ../../src/VCNL4010*.cpp VCNL4010PublishStress.cpp
+        -o stress\n
+    ./stress [-d seconds] [-r readers]\n
+\n
+"-d" sets the wall clock time of the test, default 5 seconds. "-r" sets the number of reader
+threads, default 4.
+
+@section VCNL4010PublishStress_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section VCNL4010PublishStress_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section VCNL4010PublishStress_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include <stdio.h>   // printf()
+#include <stdlib.h>  // strtoul()
+
+#include <atomic>  // std::atomic
+#include <chrono>  // std::chrono::steady_clock
+#include <mutex>   // std::mutex
+#include <thread>  // std::thread
+
+#include "VCNL4010Publish.h"  // Library under test
+#include "VCNL4010Sim.h"      // Simulated device
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint32_t TABLE_SIZE{1UL << 16};  ///< Publications remembered for checking, a power of 2
+const uint8_t  MAX_READERS{64};        ///< Most reader threads
+const uint8_t  OTHER_DEVICE{0x40};     ///< Address of the other device on the bus
+
+/***************************************************************************************************
+** Declare global variables                                                                       **
+***************************************************************************************************/
+uint32_t              Seconds{5};                 ///< Wall clock time of the test
+uint32_t              Readers{4};                 ///< Reader threads
+std::atomic<uint64_t> Table[TABLE_SIZE];          ///< Published readings by sequence number
+std::atomic<bool>     Running{true};              ///< Cleared to stop all threads
+std::atomic<uint32_t> Errors{0};                  ///< Inconsistent readings and bus errors
+std::atomic<uint32_t> OtherTransactions{0};       ///< Transactions of the other device
+std::mutex            BusMutex;                   ///< Shared by all users of the bus
+uint64_t              Reads[MAX_READERS]{0};      ///< Reads made by each reader
+uint64_t              ReadNanos[MAX_READERS]{0};  ///< Time spent reading by each reader
+
+uint64_t pack(const VCNL4010Reading &reading) {
+  /*!
+    @brief    Packs a reading without its sequence number into one word for the table
+    @param[in] reading Reading to pack
+    @return   Packed reading
+  */
+  return (uint64_t)reading.micros << 32 | (uint32_t)reading.proximity << 16 | reading.ambient;
+}  // of method pack()
+
+void lockBus(void *context) {
+  /*!
+    @brief    Lock hook, takes the bus mutex
+    @param[in] context Mutex
+  */
+  static_cast<std::mutex *>(context)->lock();
+}  // of method lockBus()
+
+void unlockBus(void *context) {
+  /*!
+    @brief    Unlock hook, gives the bus mutex back
+    @param[in] context Mutex
+  */
+  static_cast<std::mutex *>(context)->unlock();
+}  // of method unlockBus()
+
+void reader(const uint8_t index, const VCNL4010Publisher *publisher) {
+  /*!
+    @brief    Reader thread, reads and checks the latest reading until stopped
+    @param[in] index Number of the reader
+    @param[in] publisher Publisher to read from
+  */
+  VCNL4010Reading reading;
+  uint32_t        last{0};
+  uint64_t        reads{0};
+  const auto      start = std::chrono::steady_clock::now();
+  while (Running.load(std::memory_order_relaxed)) {
+    if (!publisher->read(reading)) continue;
+    ++reads;
+    if (reading.sequence < last ||
+        Table[reading.sequence & (TABLE_SIZE - 1)].load(std::memory_order_acquire) !=
+            pack(reading)) {
+      ++Errors;
+    }  // if-then sequence went back or reading differs from the one published
+    last = reading.sequence;
+  }  // of while-loop until stopped
+  Reads[index]     = reads;
+  ReadNanos[index] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+}  // of method reader()
+
+void otherDevice(VCNL4010Sim *sim) {
+  /*!
+    @brief    Thread using the bus for another device, which does not answer
+    @param[in] sim Simulated bus
+  */
+  uint8_t data;
+  while (Running.load(std::memory_order_relaxed)) {
+    BusMutex.lock();
+    if (sim->read(OTHER_DEVICE, 0, &data, 1) == VCNL4010_I2C_OK) ++Errors;
+    BusMutex.unlock();
+    ++OtherTransactions;
+    std::this_thread::yield();
+  }  // of while-loop until stopped
+}  // of method otherDevice()
+
+int main(int argc, char *argv[]) {
+  /*!
+    @brief    Runs the owner, reader and other device threads and prints the results
+    @param[in] argc Number of arguments
+    @param[in] argv Arguments, "-d seconds" and "-r readers"
+    @return   0 if no errors were found, 1 for errors or invalid arguments
+  */
+  for (int i = 1; i < argc; ++i) {
+    if (argv[i][0] == '-' && (argv[i][1] == 'd' || argv[i][1] == 'r') && i + 1 < argc) {
+      const uint32_t value = strtoul(argv[i + 1], nullptr, 10);
+      if (argv[i][1] == 'd') {
+        Seconds = value;
+      } else {
+        Readers = value;
+      }  // if-then-else duration
+      ++i;
+    } else {
+      fprintf(stderr, "Usage: %s [-d seconds] [-r readers]\n", argv[0]);
+      return 1;
+    }  // if-then-else known option
+  }    // for-next each argument
+  if (Readers == 0 || Readers > MAX_READERS) Readers = 4;
+  VCNL4010Sim       sim;
+  VCNL4010          sensor(sim);
+  VCNL4010Publisher publisher(sensor);
+  sim.setScene(2000, 100);
+  sim.setNoise(500, 50);
+  sim.setLock(lockBus, unlockBus, &BusMutex);
+  if (!sensor.begin(I2C_FAST_MODE)) {
+    fprintf(stderr, "Simulated sensor not found\n");
+    return 1;
+  }  // if-then sensor not found
+  sensor.setProximityHz(250);
+  sensor.setAmbientLight(10, 1);
+  sensor.setProximityContinuous(true);
+  sensor.setAmbientContinuous(true);
+  sensor.flush();
+  std::thread threads[MAX_READERS];
+  for (uint8_t i = 0; i < Readers; ++i) threads[i] = std::thread(reader, i, &publisher);
+  std::thread other(otherDevice, &sim);
+  const auto  end = std::chrono::steady_clock::now() + std::chrono::seconds(Seconds);
+  uint16_t    proximity{0}, ambient{0};
+  while (std::chrono::steady_clock::now() < end) {  // Owner loop
+    BusMutex.lock();
+    sim.advance(100);  // The virtual clock is part of the shared bus
+    BusMutex.unlock();
+    sensor.service();
+    const bool newProximity = sensor.tryGetProximity(proximity);
+    const bool newAmbient   = sensor.tryGetAmbientLight(ambient);
+    if (!newProximity && !newAmbient) continue;
+    BusMutex.lock();
+    const VCNL4010Reading reading{sensor.getMicros(), publisher.getSequence() + 1, proximity,
+                                  ambient};
+    BusMutex.unlock();
+    Table[reading.sequence & (TABLE_SIZE - 1)].store(pack(reading), std::memory_order_release);
+    publisher.publish(reading.proximity, reading.ambient, reading.micros);
+  }  // of while-loop until the time is up
+  Running = false;
+  for (uint8_t i = 0; i < Readers; ++i) threads[i].join();
+  other.join();
+  printf("publications %u, other device transactions %u\n", publisher.getSequence(),
+         OtherTransactions.load());
+  for (uint8_t i = 0; i < Readers; ++i) {
+    printf("reader %u: %llu reads, %.1f ns per read\n", i, (unsigned long long)Reads[i],
+           Reads[i] ? (double)ReadNanos[i] / Reads[i] : 0.0);
+  }  // for-next each reader
+  printf("errors %u\n", Errors.load());
+  return Errors.load() ? 1 : 0;
+}  // of method main()
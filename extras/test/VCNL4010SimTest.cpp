@@ -0,0 +1,703 @@
+/*!
+@file VCNL4010SimTest.cpp
+
+@section VCNL4010SimTest_intro_section Description
+
+Host-side test of the VCNL4010 library against the VCNL4010Sim simulated device. The checks cover:\n
+- begin() finding the simulated device
+- The self-timed proximity measurement rates of the device model
+- Measurements which complete during a burst read, which the model shows in the later bytes only
+- VCNL4010Array reading all sensors, and returning within the timeout when a sensor stops
+  answering
+- VCNL4010Tracker ignoring single readings outside of the window, and reporting an event at once
+  after a threshold interrupt
+- VCNL4010Calibration building tables whose readings fall strictly with the distance, also from
+  points which level off or are noisy at the far end, and recording no point and no distance
+  when the readings fail
+- VCNL4010Recorder recording every reading in polled and in streaming mode, so that replaying
+  the recording with VCNL4010Replay gives the driver the same readings
+- VCNL4010Power going to sleep on a static scene, arming the threshold interrupt in short
+  service() steps, and waking up when the scene changes
+- VCNL4010Queue merging the interrupt settings into one burst, completing reads after the posted
+  writes, calling callbacks in order also when they queue new transactions into a full queue, and
+  reporting a failed posted write to the driver
+- Random sequences of configuration calls, service() steps and waits. At checkpoints the queued
+  settings must be written by flush(), the device registers must match the settings made, and new
+  readings must arrive within the timeout and match the simulated scene\n
+\n
+Each failed check prints one line starting with "FAIL". At the end the program prints the number
+of checks and failures.\n
+\n
+This file is not part of the Arduino library. It is built and run on Linux from this directory
+with:\n
+    g++ -std=gnu++11 -O2 -I../../src ../../src/VCNL4010*.cpp VCNL4010SimTest.cpp -o simtest\n
+    ./simtest [-s seed] [-n steps]\n
+\n
+"-s" sets the seed of the random configuration sequences, default 1, and "-n" the number of random
+steps, default 20000.
+
+@section VCNL4010SimTest_license GNU General Public License v3.0
+
+This program is free software: you can redistribute it and/or modify it under the terms of the GNU
+General Public License as published by the Free Software Foundation, either version 3 of the
+License, or (at your option) any later version. This program is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details. You should have
+received a copy of the GNU General Public License along with this program.  If not, see
+<http://www.gnu.org/licenses/>.
+
+@section VCNL4010SimTest_author Author
+
+Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
+
+@section VCNL4010SimTest_versions Changelog
+
+| Version | Date       | Developer  | Comments                                                     |
+| ------- | ---------- | ---------- | ------------------------------------------------------------ |
+| 1.0.0   | 2026-10-17 | SV-Zanshin | Initial coding                                               |
+
+*/
+#include <stdarg.h>  // va_list
+#include <stdio.h>   // printf()
+#include <stdlib.h>  // strtoul()
+
+#include "VCNL4010.h"       // Library under test
+#include "VCNL4010Array.h"        // Sensors behind multiplexers
+#include "VCNL4010Calibration.h"  // Distance tables
+#include "VCNL4010Power.h"        // Duty cycling
+#include "VCNL4010Queue.h"        // Transaction queue
+#include "VCNL4010Record.h"       // Recording and replay
+#include "VCNL4010Sim.h"          // Simulated device
+#include "VCNL4010Tracker.h"      // Threshold tracking
+/***************************************************************************************************
+** Declare all program constants                                                                  **
+***************************************************************************************************/
+const uint16_t SCENE_PROXIMITY{1000};  ///< Fixed proximity scene at 20mA
+const uint16_t SCENE_AMBIENT{100};     ///< Fixed ambient light scene
+const uint32_t READ_TIMEOUT{2000000};  ///< Timeout for readings, longer than the slowest rate
+const uint8_t  ARRAY_SIZE{4};          ///< Sensors behind the simulated multiplexer
+const uint8_t  RECORD_READINGS{50};    ///< Readings recorded and replayed in each mode
+const uint8_t  QUEUE_READS{20};        ///< Reads queued by the queue callback test
+const uint32_t SERVICE_MICROS{10000};  ///< Longest service() step, no wait for the device
+
+/***************************************************************************************************
+** Declare global variables                                                                       **
+***************************************************************************************************/
+uint32_t Seed{1};        ///< Seed of the random configuration sequences
+uint32_t Steps{20000};   ///< Number of random steps
+uint32_t Random{1};      ///< xorshift32 state
+uint32_t Checks{0};      ///< Checks made
+uint32_t Failures{0};    ///< Checks failed
+
+bool check(const bool ok, const char *format, ...) {
+  /*!
+    @brief    Counts a check and prints a line if it failed
+    @param[in] ok Result of the check
+    @param[in] format printf() format of the description, followed by its arguments
+    @return   "ok"
+  */
+  ++Checks;
+  if (ok) return true;
+  ++Failures;
+  va_list arguments;
+  va_start(arguments, format);
+  printf("FAIL ");
+  vprintf(format, arguments);
+  printf("\n");
+  va_end(arguments);
+  return false;
+}  // of method check()
+
+uint32_t random(const uint32_t range) {
+  /*!
+    @brief    Returns a pseudo random number
+    @param[in] range Number of possible values
+    @return   Number from 0 to range-1
+  */
+  Random ^= Random << 13;  // xorshift32 generator
+  Random ^= Random >> 17;
+  Random ^= Random << 5;
+  return Random % range;
+}  // of method random()
+
+uint16_t proximityScene(const uint32_t micros, const bool proximity, void *context) {
+  /*!
+    @brief    Scene whose proximity reading is the number of the measurement
+    @param[in] micros Simulated time
+    @param[in] proximity "true" for the proximity reading
+    @param[in] context Counter of the proximity measurements
+    @return   Reading
+  */
+  (void)micros;
+  if (!proximity) return SCENE_AMBIENT;
+  return ++*static_cast<uint16_t *>(context);
+}  // of method proximityScene()
+
+void testBegin() {
+  /*!
+    @brief    begin() finds the simulated device and reads the product ID
+  */
+  VCNL4010Sim sim;
+  VCNL4010    sensor(sim);
+  check(sensor.begin(), "begin() did not find the simulated device");
+  check(sensor.readByte(REGISTER_PRODUCT) == VCNL4010_PRODUCT_VERSION, "product ID");
+  VCNL4010Sim other(0x14);
+  VCNL4010    missing(other);
+  check(!missing.begin(), "begin() found a device on the wrong address");
+}  // of method testBegin()
+
+void testRates() {
+  /*!
+    @brief    Each self-timed proximity rate makes the number of measurements its period gives
+  */
+  for (uint8_t code = 0; code < 8; ++code) {
+    VCNL4010Sim sim;
+    VCNL4010    sensor(sim);
+    sensor.begin();
+    sensor.setProximityHz(2 << code > 128 ? 250 : 2 << code);
+    sensor.setProximityContinuous(true);
+    sensor.flush();
+    const uint32_t period = VCNL4010Encode::proximityPeriod(code);
+    const uint32_t start  = sim.getProximityCount();
+    sim.advance(period * 8 - period / 2);  // 8 measurements, the first one at once
+    check(sim.getProximityCount() - start == 8, "rate code %u made %u measurements", code,
+          sim.getProximityCount() - start);
+  }  // for-next each rate
+}  // of method testRates()
+
+void testMidBurst() {
+  /*!
+    @brief    A proximity measurement completing during a burst read from REGISTER_CMD shows up in
+              the result bytes but not in the status byte read before it, and the read of its MSB
+              clears the data ready bit
+  */
+  VCNL4010Sim sim;
+  VCNL4010    sensor(sim);
+  uint16_t    counter{0};
+  sim.setScene(proximityScene, &counter);
+  sensor.begin();  // 100kHz, 10us per bus cycle
+  sensor.setProximityHz(250);
+  sensor.setProximityContinuous(true);
+  sensor.flush();
+  const uint32_t count = sim.getProximityCount();
+  while (sim.getProximityCount() == count) sim.advance(1);  // Just after a measurement
+  const uint32_t done = sim.micros();
+  uint8_t        buffer[REGISTER_PROXIMITY + 2 - REGISTER_CMD];
+  sim.read(VCNL4010_I2C_ADDRESS, REGISTER_PROXIMITY, buffer, 1);  // Clears its data ready bit
+  sim.advance(done + VCNL4010Encode::proximityPeriod(7) - 500 - sim.micros());  // Next in 500us
+  sim.read(VCNL4010_I2C_ADDRESS, REGISTER_CMD, buffer, sizeof(buffer));  // Status at 280us
+  const uint16_t value = (uint16_t)buffer[REGISTER_PROXIMITY - REGISTER_CMD] << 8 |
+                         buffer[REGISTER_PROXIMITY + 1 - REGISTER_CMD];  // MSB at 910us
+  check(!(buffer[0] & _BV(BIT_PROX_DATA_RDY)), "status byte shows the later measurement");
+  check(value == counter, "result bytes hold %u instead of the new reading %u", value, counter);
+  check(!(sim.getRegister(REGISTER_CMD) & _BV(BIT_PROX_DATA_RDY)), "data ready not cleared");
+}  // of method testMidBurst()
+
+class MuxSim : public VCNL4010Bus {
+  /*!
+   * @class MuxSim
+   * @brief Simulated TCA9548A multiplexer with a VCNL4010Sim on each channel. The simulated
+   *        devices share one clock, each is brought up to the current time before it is accessed
+   */
+ public:
+  VCNL4010Sim sims[ARRAY_SIZE];  ///< Device on each channel
+  bool        begin(const uint32_t speed) override {
+    for (VCNL4010Sim &sim : sims) sim.begin(speed);
+    return true;
+  }  ///< Start all devices
+  uint8_t read(const uint8_t device, const uint8_t reg, uint8_t *data,
+               const uint8_t length) override {
+    VCNL4010Sim *sim = selected();
+    if (!sim) return VCNL4010_I2C_NACK_ADDR;
+    const uint8_t status = sim->read(device, reg, data, length);
+    _now                 = sim->micros();
+    return status;
+  }  ///< Read from the device on the selected channel
+  uint8_t write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                const uint8_t length) override {
+    if (device == VCNL4010_MUX_ADDRESS) {
+      _channels = reg;  // Channel mask
+      _now += 20;
+      return VCNL4010_I2C_OK;
+    }  // if-then multiplexer
+    VCNL4010Sim *sim = selected();
+    if (!sim) return VCNL4010_I2C_NACK_ADDR;
+    const uint8_t status = sim->write(device, reg, data, length);
+    _now                 = sim->micros();
+    return status;
+  }  ///< Write to the multiplexer or the device on the selected channel
+  uint32_t micros() override { return _now; }                          ///< Shared clock
+  void     delayMicroseconds(const uint32_t us) override { _now += us; }  ///< Advance clock
+
+ private:
+  VCNL4010Sim *selected() {
+    for (uint8_t i = 0; i < ARRAY_SIZE; ++i) {
+      if (_channels != _BV(i)) continue;
+      sims[i].advance(_now - sims[i].micros());
+      return &sims[i];
+    }  // for-next each channel
+    return nullptr;
+  }  ///< Device of the one selected channel, brought up to the current time
+  uint32_t _now{0};       // Shared clock
+  uint8_t  _channels{0};  // Channel mask written to the multiplexer
+};                        // of class MuxSim
+
+void testArray() {
+  /*!
+    @brief    VCNL4010Array::read() returns a reading of every sensor, and returns within the
+              timeout with the partial mask when a sensor stops answering
+  */
+  MuxSim                            bus;
+  VCNL4010Array<ARRAY_SIZE>         sensors(bus);
+  VCNL4010ArrayReadings<ARRAY_SIZE> readings;
+  const uint32_t                    all = (1 << ARRAY_SIZE) - 1;
+  check(sensors.begin() == all, "array found sensors %X", sensors.getPresent());
+  check(sensors.read(readings) == all, "array read %X", readings.proximityReady);
+  bus.sims[2].setFail(VCNL4010_I2C_NACK_ADDR);  // Unplugged
+  const uint32_t start = bus.micros();
+  check(sensors.read(readings, 100000) == (all & ~_BV(2)), "array read without sensor 2 %X",
+        readings.proximityReady);
+  check(bus.micros() - start < 200000, "array read took %u us", bus.micros() - start);
+}  // of method testArray()
+
+void trackerInterrupt(void *context) {
+  /*!
+    @brief    INT pin callback of the simulated device
+    @param[in] context Sensor to notify
+  */
+  static_cast<VCNL4010 *>(context)->onInterrupt();
+}  // of method trackerInterrupt()
+
+void testTracker() {
+  /*!
+    @brief    A single reading outside of the window is ignored, "count" readings in a row are an
+              event, and after a threshold interrupt the first reading is an event
+  */
+  VCNL4010Sim     sim;
+  VCNL4010        sensor(sim);
+  VCNL4010Tracker tracker(sensor);
+  sim.setScene(SCENE_PROXIMITY, SCENE_AMBIENT);
+  sim.onInterrupt(trackerInterrupt, &sensor);
+  sensor.begin();
+  tracker.begin(100, 20, 4, 4);
+  const uint32_t recenters = tracker.getRecenters();
+  check(tracker.update(5000) == VCNL4010_TRACK_NONE, "tracker reported a single spike");
+  check(tracker.update(SCENE_PROXIMITY) == VCNL4010_TRACK_NONE, "tracker after a spike");
+  check(tracker.getEvents() == 0 && tracker.getRecenters() == recenters,
+        "tracker moved the window for a spike");
+  VCNL4010TrackerEvent event{VCNL4010_TRACK_NONE};
+  for (uint8_t i = 0; i < 4; ++i) {
+    check(event == VCNL4010_TRACK_NONE, "tracker event after %u readings", i);
+    event = tracker.update(5000);
+  }  // for-next each reading outside of the window
+  check(event == VCNL4010_TRACK_NEAR && tracker.getBaseline() == 5000, "tracker near event");
+  for (uint8_t i = 0; i < 4; ++i) event = tracker.update(SCENE_PROXIMITY);
+  check(event == VCNL4010_TRACK_FAR && tracker.getEvents() == 2, "tracker far event");
+  sensor.setProximityHz(250);
+  sensor.setProximityContinuous(true);
+  sensor.flush();
+  sim.setScene(5000, SCENE_AMBIENT);  // Object approaches
+  const uint32_t start = sim.micros();
+  while (!sim.interruptAsserted() && sim.micros() - start < 100000) sim.advance(100);
+  check(sim.interruptAsserted(), "no threshold interrupt");
+  check(tracker.service() == VCNL4010_TRACK_NEAR, "tracker after a threshold interrupt");
+}  // of method testTracker()
+
+void checkTable(VCNL4010Calibration &calibration, const char *name) {
+  /*!
+    @brief    Builds a table from the points added and checks that it can be used
+    @param[in] calibration Calibration with the points added
+    @param[in] name Name of the points for the failure lines
+  */
+  VCNL4010DistanceTable table;
+  if (!calibration.build(table)) return;  // Too few distinct points is not an error
+  check(VCNL4010Calibration::isValid(table), "%s table is not valid", name);
+  for (uint8_t i = 1; i < table.count; ++i) {
+    check(table.proximity[i] < table.proximity[i - 1] && table.distance[i] > table.distance[i - 1],
+          "%s table entry %u does not follow entry %u", name, i, i - 1);
+  }  // for-next each entry
+  uint16_t last{0}, proximity = table.proximity[0] + 1;
+  while (proximity > 0 && VCNL4010Calibration::toDistanceMm(table, proximity) >= last) {
+    last = VCNL4010Calibration::toDistanceMm(table, proximity--);
+  }  // while-loop distance does not fall
+  check(proximity == 0, "%s distance falls at reading %u", name, proximity);
+}  // of method checkTable()
+
+void testCalibration() {
+  /*!
+    @brief    Tables are built with strictly falling readings even where pooled readings round to
+              the same value
+  */
+  VCNL4010Sim         sim;
+  VCNL4010            sensor(sim);
+  VCNL4010Calibration calibration(sensor);
+  sensor.begin();
+  calibration.addReading(10, 100);  // Pools round to 100 and 100
+  calibration.addReading(20, 100);
+  calibration.addReading(30, 101);
+  calibration.addReading(40, 100);
+  checkTable(calibration, "rounded");
+  calibration.clear();
+  for (uint8_t i = 0; i < VCNL4010_CALIBRATION_POINTS; ++i) {
+    calibration.addReading(10 + 10 * i, i < 8 ? 2000 / (i + 1) : 3);  // Far points level off
+  }  // for-next each point
+  checkTable(calibration, "flat");
+  for (uint16_t run = 0; run < 1000; ++run) {
+    calibration.clear();
+    for (uint8_t i = 0; i < VCNL4010_CALIBRATION_POINTS; ++i) {
+      const uint16_t distance = 10 + 10 * i + random(3);  // Some distances repeat
+      calibration.addReading(distance, 4000 / distance + random(5));  // Noise of up to 4 counts
+    }  // for-next each point
+    checkTable(calibration, "noisy");
+  }  // for-next each run
+  calibration.clear();
+  sim.setScene(5 * SCENE_PROXIMITY, SCENE_AMBIENT);  // Near target
+  check(calibration.addPoint(10, 4), "near point not measured");
+  sim.setScene(SCENE_PROXIMITY, SCENE_AMBIENT);  // Far target
+  check(calibration.addPoint(100, 4), "far point not measured");
+  VCNL4010DistanceTable table;
+  check(calibration.build(table) && calibration.begin(table), "measured table not used");
+  sim.setFail(VCNL4010_I2C_NACK_ADDR);  // Unplugged
+  check(!calibration.addPoint(50, 4) && calibration.getPoints() == 2,
+        "point recorded from failed readings");
+  check(calibration.getDistanceMm() == 0, "distance from a failed reading");
+}  // of method testCalibration()
+
+uint8_t readReadings(VCNL4010 &sensor, const bool stream, uint16_t *values) {
+  /*!
+    @brief    Reads RECORD_READINGS proximity readings
+    @param[in] sensor Sensor to read
+    @param[in] stream "true" to read the readings streamed by service(), otherwise with
+              getProximity()
+    @param[out] values Readings
+    @return   Number of readings read before the timeout
+  */
+  VCNL4010StreamRing   ring;
+  VCNL4010StreamSample sample;
+  uint8_t              count{0};
+  if (stream) sensor.beginStream(ring);
+  for (uint32_t poll = 0; count < RECORD_READINGS && poll < 100000; ++poll) {
+    if (!stream) {
+      if (sensor.getProximity(values[count], READ_TIMEOUT) != VCNL4010_I2C_OK) break;
+      ++count;
+      continue;
+    }  // if-then polled
+    sensor.service();
+    while (count < RECORD_READINGS && ring.pop(sample)) values[count++] = sample.proximity;
+  }  // for-next each poll
+  if (stream) sensor.endStream();
+  return count;
+}  // of method readReadings()
+
+void testRecord() {
+  /*!
+    @brief    Readings read in polled and streaming mode are recorded and replayed in order
+  */
+  for (uint8_t stream = 0; stream < 2; ++stream) {
+    const char *mode = stream ? "streaming" : "polled";
+    uint16_t    counter{0};
+    uint16_t    recorded[RECORD_READINGS], replayed[RECORD_READINGS];
+    FILE       *file = tmpfile();
+    if (!check(file != nullptr, "cannot create a recording file")) return;
+    VCNL4010Sim      sim;
+    VCNL4010Recorder recorder(sim);
+    VCNL4010         sensor(recorder);
+    sim.setScene(proximityScene, &counter);
+    sensor.begin();
+    sensor.setProximityHz(250);
+    check(recorder.start(file), "%s recording did not start", mode);
+    const uint8_t count = readReadings(sensor, stream, recorded);
+    recorder.stop();
+    check(count == RECORD_READINGS, "%s read %u readings", mode, count);
+    rewind(file);
+    VCNL4010Replay replay;
+    VCNL4010       player(replay);
+    check(replay.open(file), "%s recording cannot be replayed", mode);
+    player.begin();
+    player.setProximityHz(250);
+    const uint8_t played = readReadings(player, stream, replayed);
+    check(played == count && replay.isValid(), "%s replayed %u of %u readings", mode, played,
+          count);
+    for (uint8_t i = 0; i < played && i < count; ++i) {
+      if (!check(replayed[i] == recorded[i], "%s reading %u replayed as %u, recorded %u", mode, i,
+                 replayed[i], recorded[i])) {
+        break;
+      }  // if-then first difference
+    }    // for-next each reading
+    fclose(file);
+  }  // for-next each mode
+}  // of method testRecord()
+
+void testPower() {
+  /*!
+    @brief    A static scene puts the sensor to sleep, the threshold interrupt is armed without a
+              long service() step, and a change of the scene wakes it up
+  */
+  VCNL4010Sim   sim;
+  VCNL4010      sensor(sim);
+  VCNL4010Power power(sensor);
+  sim.setScene(SCENE_PROXIMITY, SCENE_AMBIENT);
+  sensor.begin();
+  power.begin();
+  uint32_t longest{0};
+  uint32_t start = sim.micros();
+  while (power.getState() != VCNL4010_POWER_SLEEP && sim.micros() - start < 20000000) {
+    const uint32_t step = sim.micros();
+    power.service();
+    if (sim.micros() - step > longest) longest = sim.micros() - step;
+    sim.advance(100);
+  }  // while-loop active
+  check(power.getState() == VCNL4010_POWER_SLEEP, "power did not go to sleep");
+  start = sim.micros();
+  while (!(sensor.readByte(REGISTER_INTERRUPT) & 0b10) && sim.micros() - start < READ_TIMEOUT) {
+    const uint32_t step = sim.micros();
+    power.service();
+    if (sim.micros() - step > longest) longest = sim.micros() - step;
+    sim.advance(100);
+  }  // while-loop interrupt not armed
+  check(sensor.readByte(REGISTER_INTERRUPT) & 0b10, "threshold interrupt not armed");
+  check(sensor.readByte(REGISTER_PROXIMITY_RATE) == 0, "sleep rate not written");
+  check(longest < SERVICE_MICROS, "power service() step took %uus", longest);
+  sim.setScene(5 * SCENE_PROXIMITY, SCENE_AMBIENT);  // Object approaches
+  VCNL4010PowerEvent event{VCNL4010_POWER_NONE};
+  start = sim.micros();
+  while (event != VCNL4010_POWER_WAKE && sim.micros() - start < READ_TIMEOUT) {
+    event = power.service();
+    sim.advance(1000);
+  }  // while-loop sleeping
+  check(event == VCNL4010_POWER_WAKE && power.getRateHz() == 250, "power did not wake up");
+}  // of method testPower()
+
+class WriteLogSim : public VCNL4010Sim {
+  /*!
+   * @class WriteLogSim
+   * @brief Simulated device which logs the bus writes and can be made to fail them
+   */
+ public:
+  uint8_t write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                const uint8_t length) override {
+    ++writes;
+    lastReg    = reg;
+    lastLength = length;
+    if (failWrites) return VCNL4010_I2C_NACK_DATA;
+    return VCNL4010Sim::write(device, reg, data, length);
+  }                            ///< Log and pass on
+  uint16_t writes{0};          ///< Writes made
+  uint8_t  lastReg{0};         ///< First register of the last write
+  uint8_t  lastLength{0};      ///< Length of the last write
+  bool     failWrites{false};  ///< Writes return VCNL4010_I2C_NACK_DATA
+};                             // of class WriteLogSim
+
+struct QueueReads {
+  /*!
+   * @struct QueueReads
+   * @brief  State of the queue callback test
+   */
+  VCNL4010Queue *queue;      ///< Queue to submit to
+  uint8_t        submitted;  ///< Reads submitted
+  uint8_t        completed;  ///< Reads completed
+  bool           ordered;    ///< All callbacks came in order
+  bool           intact;     ///< No transaction changed while its callback ran
+};                           // of struct QueueReads
+
+void queueRead(const VCNL4010Transaction &transaction, void *context) {
+  /*!
+    @brief    Callback of the queue test, checks the order and submits the next read
+    @param[in] transaction Completed read
+    @param[in] context QueueReads state
+  */
+  QueueReads   &state = *static_cast<QueueReads *>(context);
+  const uint8_t reg   = REGISTER_CMD + state.completed % 16;
+  state.ordered       = state.ordered && transaction.reg == reg && transaction.length == 1 &&
+                        transaction.status == VCNL4010_I2C_OK;
+  ++state.completed;
+  if (state.submitted < QUEUE_READS) {
+    state.queue->submitRead(VCNL4010_I2C_ADDRESS, REGISTER_CMD + state.submitted++ % 16, 1,
+                            queueRead, context);
+  }  // if-then more reads
+  state.intact = state.intact && transaction.reg == reg && transaction.callback == queueRead;
+}  // of method queueRead()
+
+void testQueue() {
+  /*!
+    @brief    Posted writes are merged, completed before reads and their failures reported, and
+              callbacks are called in order with their own transaction
+  */
+  WriteLogSim   sim;
+  VCNL4010Queue queue(sim);
+  VCNL4010      sensor(queue);
+  sensor.begin();
+  queue.drain();  // Settings written by begin()
+  const uint16_t writes = sim.writes;
+  sensor.setInterrupt(4, false, false, true, false, 100, 2000);
+  check(queue.getPending() == 1 && sim.writes == writes, "interrupt settings not posted");
+  sensor.readByte(REGISTER_INTERRUPT);
+  check(sim.writes == writes + 1 && sim.lastReg == REGISTER_INTERRUPT && sim.lastLength == 5,
+        "interrupt settings written in %u writes, last %u bytes at %02X", sim.writes - writes,
+        sim.lastLength, sim.lastReg);
+  sensor.writeByte(REGISTER_LED_CURRENT, 12);
+  check(queue.getPending() == 1, "write not posted");
+  check(sensor.readByte(REGISTER_LED_CURRENT) == 12 && queue.getPending() == 0,
+        "read does not see the posted write");
+  QueueReads state{&queue, 0, 0, true, true};
+  while (state.submitted < VCNL4010_QUEUE_SIZE) {
+    queue.submitRead(VCNL4010_I2C_ADDRESS, REGISTER_CMD + state.submitted++ % 16, 1, queueRead,
+                     &state);
+  }  // while-loop queue not full
+  check(queue.getPending() == VCNL4010_QUEUE_SIZE, "queue not full");
+  queue.drain();
+  check(state.completed == QUEUE_READS && state.ordered, "%u queued reads completed in order",
+        state.completed);
+  check(state.intact, "transaction changed while its callback ran");
+  const uint16_t errors = sensor.getI2CErrors();
+  sim.failWrites        = true;
+  sensor.writeByte(REGISTER_LED_CURRENT, 5);  // Fails when the read completes it
+  sensor.readByte(REGISTER_LED_CURRENT);
+  sim.failWrites = false;
+  check(sensor.getI2CErrors() == errors + 1 && queue.getLastError() == VCNL4010_I2C_NACK_DATA,
+        "failed posted write not reported");
+}  // of method testQueue()
+
+void testFuzz() {
+  /*!
+    @brief    Random configuration sequences, see the file description
+  */
+  VCNL4010Sim sim;
+  VCNL4010    sensor(sim);
+  sim.setScene(SCENE_PROXIMITY, SCENE_AMBIENT);
+  const uint32_t SPEEDS[]{I2C_STANDARD_MODE, I2C_FAST_MODE, I2C_FAST_MODE_PLUS_MODE};
+  Random = Seed ? Seed : 1;
+  check(sensor.begin(SPEEDS[random(3)]), "begin() did not find the simulated device");
+  uint8_t  rate{sim.getRegister(REGISTER_PROXIMITY_RATE)};  // Expected register values
+  uint8_t  led{sim.getRegister(REGISTER_LED_CURRENT)};
+  uint8_t  ambient{sim.getRegister(REGISTER_AMBIENT_PARAM)};
+  uint8_t  timing{sim.getRegister(REGISTER_PROXIMITY_TIMING)};
+  uint8_t  control{sim.getRegister(REGISTER_INTERRUPT)};
+  uint16_t low  = (uint16_t)sim.getRegister(REGISTER_LOW_THRESH_MSB) << 8 |
+                 sim.getRegister(REGISTER_LOW_THRESH_LSB);
+  uint16_t high = (uint16_t)sim.getRegister(REGISTER_HIGH_THRESH_MSB) << 8 |
+                  sim.getRegister(REGISTER_HIGH_THRESH_LSB);
+  uint16_t value{0};
+  for (uint32_t step = 0; step < Steps; ++step) {
+    switch (random(10)) {
+      case 0: {
+        const uint8_t Hz = random(2) ? 2 << random(7) : random(256);
+        sensor.setProximityHz(Hz);
+        rate = VCNL4010Encode::proximityRate(Hz);
+        break;
+      }
+      case 1: {
+        const uint8_t mA = random(256);
+        sensor.setLEDmA(mA);
+        led = VCNL4010Encode::ledCurrent(mA);
+        break;
+      }
+      case 2: {
+        const uint8_t samples = random(12), averaging = random(256);
+        sensor.setAmbientLight(samples, averaging);
+        ambient = (ambient & 0b10001000) | VCNL4010Encode::ambientRate(samples) |
+                  VCNL4010Encode::ambientAveraging(averaging);
+        break;
+      }
+      case 3: {
+        const uint8_t frequency = random(4);
+        sensor.setProximityFreq(frequency);
+        timing = (timing & 0b11100111) | frequency << 3;
+        break;
+      }
+      case 4: sensor.setProximityContinuous(random(2)); break;
+      case 5: sensor.setAmbientContinuous(random(2)); break;
+      case 6: {
+        const uint8_t  count = 1 << random(8), flags = random(16);
+        const uint16_t from = random(65536), to = random(65536);
+        sensor.setInterrupt(count, flags & 1, flags & 2, flags & 4, flags & 8, from, to);
+        control = VCNL4010Encode::interruptCount(count) |
+                  (flags & 1 ? VCNL4010_INT_PROX_READY : 0) |
+                  (flags & 2 ? VCNL4010_INT_ALS_READY : 0) | (flags & 12 ? 0b10 : 0) |
+                  (flags & 8 ? 1 : 0);
+        if (flags & 12) {
+          low  = from;
+          high = to;
+        }  // if-then thresholds written
+        break;
+      }
+      case 7:
+        sensor.service();
+        sensor.tryGetProximity(value);
+        sensor.tryGetAmbientLight(value);
+        break;
+      case 8: sim.advance(random(20000)); break;
+      default: {
+        if (random(8)) break;  // Checkpoint on every 80th step on average
+        check(sensor.flush(READ_TIMEOUT) == VCNL4010_I2C_OK, "step %u flush() failed", step);
+        check(sim.getRegister(REGISTER_PROXIMITY_RATE) == rate, "step %u rate %02X, expected %02X",
+              step, sim.getRegister(REGISTER_PROXIMITY_RATE), rate);
+        check(sim.getRegister(REGISTER_LED_CURRENT) == led, "step %u LED %02X, expected %02X", step,
+              sim.getRegister(REGISTER_LED_CURRENT), led);
+        check(sim.getRegister(REGISTER_AMBIENT_PARAM) == ambient,
+              "step %u ambient %02X, expected %02X", step, sim.getRegister(REGISTER_AMBIENT_PARAM),
+              ambient);
+        check(sim.getRegister(REGISTER_PROXIMITY_TIMING) == timing,
+              "step %u timing %02X, expected %02X", step,
+              sim.getRegister(REGISTER_PROXIMITY_TIMING), timing);
+        check(sim.getRegister(REGISTER_INTERRUPT) == control,
+              "step %u interrupt %02X, expected %02X", step, sim.getRegister(REGISTER_INTERRUPT),
+              control);
+        check((uint16_t)(sim.getRegister(REGISTER_LOW_THRESH_MSB) << 8 |
+                         sim.getRegister(REGISTER_LOW_THRESH_LSB)) == low &&
+                  (uint16_t)(sim.getRegister(REGISTER_HIGH_THRESH_MSB) << 8 |
+                             sim.getRegister(REGISTER_HIGH_THRESH_LSB)) == high,
+              "step %u thresholds", step);
+        sensor.service();  // Take up readings made with the previous settings
+        sensor.tryGetProximity(value);
+        sensor.tryGetAmbientLight(value);
+        if (check(sensor.getProximity(value, READ_TIMEOUT) == VCNL4010_I2C_OK,
+                  "step %u no proximity reading", step)) {
+          check(value == SCENE_PROXIMITY * led / 2, "step %u proximity %u, expected %u", step,
+                value, SCENE_PROXIMITY * led / 2);
+        }  // if-then reading arrived
+        if (check(sensor.getAmbientLight(value, READ_TIMEOUT) == VCNL4010_I2C_OK,
+                  "step %u no ambient light reading", step)) {
+          check(value == SCENE_AMBIENT, "step %u ambient light %u", step, value);
+        }  // if-then reading arrived
+        break;
+      }
+    }  // of switch operation
+  }    // for-next each step
+  check(sensor.getI2CErrors() == 0, "%u I2C errors", sensor.getI2CErrors());
+}  // of method testFuzz()
+
+int main(int argc, char *argv[]) {
+  /*!
+    @brief    Runs all tests and prints the number of checks and failures
+    @param[in] argc Number of arguments
+    @param[in] argv Arguments, "-s seed" and "-n steps"
+    @return   0 if all checks passed, 1 for failures or invalid arguments
+  */
+  for (int i = 1; i < argc; ++i) {
+    if (argv[i][0] == '-' && (argv[i][1] == 's' || argv[i][1] == 'n') && i + 1 < argc) {
+      const uint32_t value = strtoul(argv[i + 1], nullptr, 10);
+      if (argv[i][1] == 's') {
+        Seed = value;
+      } else {
+        Steps = value;
+      }  // if-then-else seed
+      ++i;
+    } else {
+      fprintf(stderr, "Usage: %s [-s seed] [-n steps]\n", argv[0]);
+      return 1;
+    }  // if-then-else known option
+  }    // for-next each argument
+  testBegin();
+  testRates();
+  testMidBurst();
+  testArray();
+  testTracker();
+  testCalibration();
+  testRecord();
+  testPower();
+  testQueue();
+  testFuzz();
+  printf("%u checks, %u failures\n", Checks, Failures);
+  return Failures ? 1 : 0;
+}  // of method main()
@@ -5,59 +5,91 @@ Arduino Library for the Vishay VCNL4010\n\n
 See main library header file for details
 */
 #include "VCNL4010.h"  // Include the header definition
-VCNL4010::VCNL4010() {
+#if !defined(ARDUINO)
+#define noInterrupts()  ///< No interrupt routines to block outside of Arduino
+#define interrupts()    ///< No interrupt routines to block outside of Arduino
+#else
+static VCNL4010WireBus defaultBus;  ///< Transport for the default constructor, uses "Wire"
+VCNL4010::VCNL4010() : _bus(&defaultBus) {
   /*!
    * @brief   Class constructor
-   * @details Class Constructor for VCNL4010 instantiates the class. Unused
+   * @details Class Constructor for VCNL4010 instantiates the class using the Arduino "Wire" bus
    */
+#if VCNL4010_STATS
+  _stats.reset();
+#endif
+}
+#endif
+VCNL4010::VCNL4010(VCNL4010Bus &bus) : _bus(&bus) {
+  /*!
+   * @brief   Class constructor
+   * @details Class Constructor for VCNL4010 instantiates the class using the given bus transport
+   * @param[in] bus Bus transport to use, e.g. VCNL4010WireBus, VCNL4010LinuxBus or VCNL4010FakeBus
+   */
+#if VCNL4010_STATS
+  _stats.reset();
+#endif
 }
 VCNL4010::~VCNL4010() { /*!
                          * @brief   Class destructor
                          * @details Class Destructor for VCNL4010 destroys the class. Unused
                          */
 }
-bool VCNL4010::begin(const uint8_t deviceAddress, const uint32_t &i2CSpeed) {
+bool VCNL4010::begin(const VCNL4010Image &image, const uint8_t deviceAddress,
+                     const uint32_t &i2CSpeed) {
   /*!
-    @brief     Starts the I2C communications with the VCNL4010 (overloaded)
-    @details   This is the only overloaded begin() that actually starts the device and initializes
-               the system. The other begin() calls all call this one with the appropraite
-               parameter value set.
+    @brief     Starts the I2C communications with the VCNL4010 and writes a register image
+    @details   This is the begin() that actually starts the device and initializes the system, the
+               other begin() calls use it with the default settings of VCNL4010Profile<>. The image
+               is written with one burst for REGISTER_PROXIMITY_RATE through REGISTER_AMBIENT_PARAM
+               and one for REGISTER_INTERRUPT through REGISTER_PROXIMITY_TIMING, each of which is
+               skipped if the device already has those values. REGISTER_CMD is written last
+    @param[in] image Register image, usually a VCNL4010Profile
     @param[in] deviceAddress I2C device address
     @param[in] i2CSpeed Speed of the I2C bus in Herz
     @return    "true" when device has been detected, otherwise false
   */
-  _I2Caddress = deviceAddress;  // Set the private device address variable
-  Wire.begin();                 // Start I2C as master device
-  Wire.setClock(i2CSpeed);      // Set the I2C speed
-  if (readByte(REGISTER_PRODUCT) != VCNL4010_PRODUCT_VERSION) {
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_CONFIG);
+  _I2Caddress = deviceAddress;                // Set the private device address variable
+  if (!_bus->begin(i2CSpeed)) return false;  // Start the bus at the requested speed
+  _i2cSpeed  = i2CSpeed;                     // Remember speed for the delay policy
+  _i2cErrors = 0;                            // Reset the error counter
+  setI2CDelay(_i2cPolicy);                   // and compute the delay for this speed
+  if (!resync()) {
     return false;  // return an error if the signature does not match
   }                // if-then not a VCNL4010 then return
-
-  /*************************************************************
-  ** Set VCNL4010 to a known state with everything turned off **
-  *************************************************************/
-  writeByte(REGISTER_CMD, 0);  // turn off all settings
-  uint8_t commandRegister = readByte(REGISTER_CMD);
-  if (commandRegister & _BV(BIT_ALS_DATA_RDY)) {
-    readWord(REGISTER_AMBIENT_LIGHT);  // ignore any data, used to clear flag
-  }                                    // of if-then an ALS reading is ready
-  if (commandRegister & _BV(BIT_PROX_DATA_RDY)) {
-    readWord(REGISTER_PROXIMITY);  // ignore any data, used to clear flag
-  }                                // of if-then an PROX reading is ready
-  /*****************************************************************
-  ** Then explicitly set default values directly to all registers **
-  *****************************************************************/
-  writeByte(REGISTER_PROXIMITY_RATE, 0);         // 1.95 measurements per second
-  writeByte(REGISTER_LED_CURRENT, 2);            // 20mA
-  writeByte(REGISTER_AMBIENT_LIGHT, B00011101);  // 2 samples/s, 32 averaged
-  writeByte(REGISTER_PROXIMITY_TIMING, 1);       // no delay, 1 dead time, 390.625kHz
-  writeByte(REGISTER_INTERRUPT, 0);              // turn off interrupts
+  /*************************************************************************************************
+  ** The burst read in resync() also read the result registers, which clears any pending data    **
+  ** ready flags. Turn off self-timed measurements so that the parameters may be written, then   **
+  ** write the image. Only blocks that differ from the shadow copy are actually written          **
+  *************************************************************************************************/
+  writeRegister(REGISTER_CMD, 0);
+  writeRegisters(REGISTER_PROXIMITY_RATE, image.parameters, sizeof(image.parameters));
+  writeRegisters(REGISTER_INTERRUPT, image.thresholds, sizeof(image.thresholds));
+  writeRegister(REGISTER_CMD, image.command);
+  _ContinuousAmbient   = image.command & _BV(BIT_ALS_EN);
+  _ContinuousProximity = image.command & _BV(BIT_PROX_EN);
   /********************************************
   ** Now trigger one reading for both values **
   ********************************************/
-  writeByte(REGISTER_CMD, _BV(BIT_ALS_OD) | _BV(BIT_PROX_OD));
+  _dirty    = 0;  // No queued parameter changes
+  _fresh    = 0;  // No readings
+  _inFlight = 0;  // and no measurements in progress
+  startMeasurement();
   return true;
 }  // of method begin()
+bool VCNL4010::begin(const uint8_t deviceAddress, const uint32_t &i2CSpeed) {
+  /*!
+    @brief     Starts the I2C communications with the VCNL4010 (overloaded)
+    @details   Sets everything to the default values of VCNL4010Profile<>, which are triggered
+               readings, 2 proximity readings/s, 20mA, 2 ambient light samples/s with 32 averaged,
+               390.625kHz proximity modulation and no interrupts
+    @param[in] deviceAddress I2C device address
+    @param[in] i2CSpeed Speed of the I2C bus in Herz
+    @return    "true" when device has been detected, otherwise false
+  */
+  return begin(VCNL4010Profile<>(), deviceAddress, i2CSpeed);
+}  // of overloaded method begin()
 bool VCNL4010::begin(void) {
   /*!
     @brief     Starts the I2C communications with the VCNL4010 (overloaded)
@@ -87,47 +119,354 @@ bool VCNL4010::begin(const uint32_t &i2CSpeed) {
 uint8_t VCNL4010::readByte(const uint8_t addr) const {
   /*!
     @brief     reads 1 byte from the specified address
-    @details   Delays VCNL4010_I2C_MS_DELAY after reading
+    @details   See readBlock() for the timing and error handling
     @param[in] addr Address of the I2C device
-    @return    single unsigned integer value with the byte value read from I2C
-  */
-  Wire.beginTransmission(_I2Caddress);        // Address the I2C device
-  Wire.write(addr);                           // Send the register address to read
-  Wire.endTransmission();                     // Close transmission
-  delayMicroseconds(VCNL4010_I2C_MS_DELAY);   // Introduce slight delay
-  Wire.requestFrom(_I2Caddress, (uint8_t)1);  // Request 1 byte of data
-  return Wire.read();                         // read it and return it
+    @return    single unsigned integer value with the byte value read from I2C, 0 on error
+  */
+  uint8_t returnData{0};            // Store return value
+  readBlock(addr, &returnData, 1);  // Read a single byte
+  return returnData;
 }  // of method readByte()
 uint16_t VCNL4010::readWord(const uint8_t addr) const {
   /*!
     @brief     reads 2 bytes from the specified address
-    @details   Delays VCNL4010_I2C_MS_DELAY after reading
+    @details   See readBlock() for the timing and error handling
     @param[in] addr Address of the I2C device
-    @return    Unsigned integer 16 value with the 2 bytes read from I2C
-  */
-  uint16_t returnData;                        // Store return value
-  Wire.beginTransmission(_I2Caddress);        // Address the I2C device
-  Wire.write(addr);                           // Send the register address to read
-  Wire.endTransmission();                     // Close transmission
-  delayMicroseconds(VCNL4010_I2C_MS_DELAY);   // Introduce slight delay
-  Wire.requestFrom(_I2Caddress, (uint8_t)2);  // Request 2 consecutive bytes
-  returnData = Wire.read();                   // Read the msb
-  returnData = returnData << 8;               // shift the data over
-  returnData |= Wire.read();                  // Read the lsb
-  return returnData;
+    @return    Unsigned integer 16 value with the 2 bytes read from I2C, 0 on error
+  */
+  uint8_t buffer[2] = {0, 0};               // Store return values
+  readBlock(addr, buffer, sizeof(buffer));  // Read msb and lsb
+  return (uint16_t)buffer[0] << 8 | buffer[1];
 }  // of method readWord()
+uint8_t VCNL4010::readBlock(const uint8_t addr, uint8_t *buffer, const uint8_t length) const {
+  /*!
+    @brief     reads "length" consecutive registers starting at the specified address
+    @details   The VCNL4010 auto-increments the register pointer on reads, so a block of registers
+               can be retrieved with a single I2C transaction. After addressing the register the
+               delay set by setI2CDelay() is applied by the bus transport. On an error the bus is
+               given the legacy VCNL4010_I2C_MS_DELAY to recover and the read is retried once.
+               The bus lock hooks are called around each attempt, see VCNL4010Bus::setLock()
+    @param[in] addr Address of the first register to read
+    @param[out] buffer Buffer of at least "length" bytes to store the register values
+    @param[in] length Number of bytes to read, limited by the bus transport (32 for Wire)
+    @return    Number of bytes read, 0 on error
+  */
+  for (uint8_t attempt = 0; attempt < 2; ++attempt) {
+    _bus->lock();  // Other users of the bus wait
+#if VCNL4010_STATS
+    const uint32_t start = _bus->micros();
+#endif
+    _i2cStatus = _bus->read(_I2Caddress, addr, buffer, length);  // Burst read from device
+#if VCNL4010_STATS
+    _stats.addTransaction(VCNL4010_OP_READ, length, _bus->micros() - start, _i2cStatus);
+#endif
+    _bus->unlock();
+    if (_i2cStatus == VCNL4010_I2C_OK) return length;
+    ++_i2cErrors;                                     // Count the failure
+    _bus->delayMicroseconds(VCNL4010_I2C_MS_DELAY);  // and give the bus time to recover
+  }                                                   // for-next each attempt
+  return 0;
+}  // of method readBlock()
+bool VCNL4010::writeBlock(const uint8_t addr, const uint8_t *data, const uint8_t length) const {
+  /*!
+    @brief     Writes "length" bytes to consecutive registers starting at the specified address
+    @details   The VCNL4010 auto-increments the register pointer on writes, so a block of registers
+               can be written with a single I2C transaction. The write is retried once after the
+               legacy VCNL4010_I2C_MS_DELAY if it failed. Shadowed registers written this way must
+               be reloaded with resync()
+    @param[in] addr Address of the first register to write
+    @param[in] data Bytes to write
+    @param[in] length Number of bytes to write
+    @return    "true" if the write succeeded
+  */
+  for (uint8_t attempt = 0; attempt < 2; ++attempt) {
+    _bus->lock();  // Other users of the bus wait
+#if VCNL4010_STATS
+    const uint32_t start = _bus->micros();
+#endif
+    _i2cStatus = _bus->write(_I2Caddress, addr, data, length);  // Burst write to device
+#if VCNL4010_STATS
+    _stats.addTransaction(VCNL4010_OP_WRITE, length, _bus->micros() - start, _i2cStatus);
+#endif
+    _bus->unlock();
+    if (_i2cStatus == VCNL4010_I2C_OK) return true;
+    ++_i2cErrors;                                     // Count the failure
+    _bus->delayMicroseconds(VCNL4010_I2C_MS_DELAY);  // and give the bus time to recover
+  }                                                   // for-next each attempt
+  return false;
+}  // of method writeBlock()
 void VCNL4010::writeByte(const uint8_t addr, const uint8_t data) const {
   /*!
     @brief     Write 1 byte to the specified address
+    @details   See writeBlock() for the timing and error handling
     @param[in] addr Address of the I2C device
     @param[in] data Single byte to write
   */
-  Wire.beginTransmission(_I2Caddress);       // Address the I2C device
-  Wire.write(addr);                          // Send the register address to write
-  Wire.write(data);                          // Send the data to write
-  Wire.endTransmission();                    // Close transmission
-  delayMicroseconds(VCNL4010_I2C_MS_DELAY);  // Introduce slight delay
+  writeBlock(addr, &data, 1);
 }  // of method writeByte()
+void VCNL4010::setI2CDelay(const VCNL4010DelayPolicy policy) {
+  /*!
+    @brief     Sets the delay applied after each I2C register access
+    @details   VCNL4010_DELAY_NONE removes the delay, VCNL4010_DELAY_LEGACY always uses
+               VCNL4010_I2C_MS_DELAY microseconds as older versions of the library did and
+               VCNL4010_DELAY_SCALED scales that delay to the bus speed given in begin(), so that
+               it is VCNL4010_I2C_MS_DELAY at I2C_STANDARD_MODE and shorter at higher speeds. The
+               default is set with VCNL4010_DELAY_POLICY at compile time. Bus errors are detected
+               from the I2C status regardless of the policy, see getI2CStatus()
+    @param[in] policy Delay policy to use
+  */
+  uint16_t delay{VCNL4010_I2C_MS_DELAY};  // Legacy delay
+  _i2cPolicy = policy;
+  switch (policy) {
+    case VCNL4010_DELAY_NONE: delay = 0; break;
+    case VCNL4010_DELAY_SCALED:
+      delay = (uint32_t)VCNL4010_I2C_MS_DELAY * I2C_STANDARD_MODE / _i2cSpeed;
+      break;
+    default: break;
+  }                              // of switch policy
+  _bus->setSettleDelay(delay);  // The bus transport applies the delay
+}  // of method setI2CDelay()
+uint8_t VCNL4010::getI2CStatus() const {
+  /*!
+    @brief     Returns the status of the last I2C transaction
+    @return    0 for success, the Wire endTransmission() error code (1-5) or VCNL4010_I2C_SHORT_READ
+               if fewer bytes were returned than requested
+  */
+  return _i2cStatus;
+}  // of method getI2CStatus()
+uint16_t VCNL4010::getI2CErrors() const {
+  /*!
+    @brief     Returns the number of failed I2C transactions since begin()
+    @details   Every failed attempt is counted, including ones that succeeded when retried
+    @return    Number of errors
+  */
+  return _i2cErrors;
+}  // of method getI2CErrors()
+static uint8_t shadowIndex(const uint8_t addr) {
+  /*!
+    @brief     Returns the index into the shadow register array for a register address
+    @details   Only the writable configuration registers are shadowed, these are REGISTER_CMD,
+               REGISTER_PROXIMITY_RATE through REGISTER_AMBIENT_PARAM, REGISTER_INTERRUPT through
+               REGISTER_HIGH_THRESH_LSB and REGISTER_PROXIMITY_TIMING
+    @param[in] addr Register address
+    @return    Index into the shadow array or VCNL4010_SHADOW_REGISTERS if not shadowed
+  */
+  if (addr == REGISTER_CMD) return 0;
+  if (addr >= REGISTER_PROXIMITY_RATE && addr <= REGISTER_AMBIENT_PARAM) {
+    return addr - REGISTER_PROXIMITY_RATE + 1;  // Indices 1-3
+  }
+  if (addr >= REGISTER_INTERRUPT && addr <= REGISTER_HIGH_THRESH_LSB) {
+    return addr - REGISTER_INTERRUPT + 4;  // Indices 4-8
+  }
+  if (addr == REGISTER_PROXIMITY_TIMING) return 9;
+  return VCNL4010_SHADOW_REGISTERS;
+}  // of function shadowIndex()
+void VCNL4010::writeRegister(const uint8_t addr, const uint8_t data) {
+  /*!
+    @brief     Writes a shadowed configuration register, but only if the value has changed
+    @details   The value is compared against the in-memory shadow copy and the I2C write is skipped
+               if it is the same. For REGISTER_CMD only the 3 enable bits are kept in the shadow,
+               the on-demand bits are self-clearing and the data ready bits are read-only.
+               Registers which are not shadowed are always written
+    @param[in] addr Register address
+    @param[in] data Value to write
+  */
+  const uint8_t index = shadowIndex(addr);
+  if (index == VCNL4010_SHADOW_REGISTERS) {
+    writeByte(addr, data);  // Not shadowed, so always write
+    return;
+  }  // if-then not a shadowed register
+  const uint8_t value = (index == 0) ? data & 0b00000111 : data;  // Only enable bits are kept
+  if (_shadow[index] == value) return;                            // Nothing changed, no bus write
+  writeByte(addr, value);                                         // Write the new value
+  _shadow[index] = value;                                         // and remember it
+}  // of method writeRegister()
+bool VCNL4010::writeRegisters(const uint8_t addr, const uint8_t *data, const uint8_t length) {
+  /*!
+    @brief     Writes consecutive registers in one burst, but only if a shadowed value has changed
+    @details   Registers in the range which are not shadowed are written along with the others but
+               are not compared, REGISTER_CMD must not be part of the range
+    @param[in] addr Address of the first register
+    @param[in] data Values to write
+    @param[in] length Number of registers
+    @return    "true" if the registers were written, "false" if unchanged or on an I2C error
+  */
+  bool changed{false};
+  for (uint8_t i = 0; i < length && !changed; ++i) {
+    const uint8_t index = shadowIndex(addr + i);
+    changed             = index != VCNL4010_SHADOW_REGISTERS && _shadow[index] != data[i];
+  }  // for-next each register until a change is found
+  if (!changed || !writeBlock(addr, data, length)) return false;
+  for (uint8_t i = 0; i < length; ++i) {
+    const uint8_t index = shadowIndex(addr + i);
+    if (index != VCNL4010_SHADOW_REGISTERS) _shadow[index] = data[i];  // Remember value written
+  }  // for-next each register
+  return true;
+}  // of method writeRegisters()
+bool VCNL4010::resync() {
+  /*!
+    @brief     Reloads the shadow copy of the configuration registers from the device
+    @details   All registers from REGISTER_CMD through REGISTER_PROXIMITY_TIMING are read in one
+               burst transaction. Call this if the device might have been reset or if registers
+               have been changed using writeByte() directly. Note that the burst also reads the
+               result registers, which clears the device's data ready flags
+    @return    "true" if the registers were read and the product ID matches, otherwise "false"
+  */
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_CONFIG);
+  uint8_t buffer[REGISTER_PROXIMITY_TIMING + 1 - REGISTER_CMD];  // Registers 0x80 through 0x8F
+  if (readBlock(REGISTER_CMD, buffer, sizeof(buffer)) != sizeof(buffer) ||
+      buffer[REGISTER_PRODUCT - REGISTER_CMD] != VCNL4010_PRODUCT_VERSION) {
+    return false;  // Device not found or not a VCNL4010
+  }                // if-then read failed
+  for (uint8_t i = 0; i < sizeof(buffer); ++i) {
+    const uint8_t index = shadowIndex(REGISTER_CMD + i);
+    if (index != VCNL4010_SHADOW_REGISTERS) _shadow[index] = buffer[i];
+  }                         // for-next each register
+  _shadow[0] &= 0b00000111;  // Only keep the enable bits of REGISTER_CMD
+  return true;
+}  // of method resync()
+/***************************************************************************************************
+** The proximity and ambient light parameter registers may only be written while no on-demand    **
+** measurement for that sensor is in progress. Writes are queued in "_pending" and flagged in    **
+** "_dirty", then written by flushRegisters() once the sensor is idle                             **
+***************************************************************************************************/
+static const uint8_t idleRegister[VCNL4010_IDLE_REGISTERS] = {
+    REGISTER_PROXIMITY_RATE, REGISTER_AMBIENT_PARAM, REGISTER_PROXIMITY_TIMING};  ///< Registers
+static const uint8_t idleOnDemandBit[VCNL4010_IDLE_REGISTERS] = {
+    BIT_PROX_OD, BIT_ALS_OD, BIT_PROX_OD};  ///< On-demand bit for each of the idleRegister[]
+uint8_t VCNL4010::idleValue(const uint8_t index) const {
+  /*!
+    @brief     Returns the value a measurement parameter register will have once written
+    @param[in] index Index into the idleRegister[] array
+    @return    The pending value if a write is queued, otherwise the shadow register value
+  */
+  if (_dirty & _BV(index)) return _pending[index];
+  return _shadow[shadowIndex(idleRegister[index])];
+}  // of method idleValue()
+void VCNL4010::setIdleRegister(const uint8_t index, const uint8_t data) {
+  /*!
+    @brief     Queues a write to a measurement parameter register which may only be changed while
+               the sensor is idle
+    @details   The write is performed immediately if possible, otherwise it is left pending and
+               written by a later service() call. This never waits for the device
+    @param[in] index Index into the idleRegister[] array
+    @param[in] data Value to write
+  */
+  _pending[index] = data;
+  if (_shadow[shadowIndex(idleRegister[index])] == data) {
+    _dirty &= ~_BV(index);  // Device already has this value
+    return;
+  }  // if-then no change
+  _dirty |= _BV(index);
+  flushRegisters((_shadow[0] & _BV(BIT_SELFTIMED_EN)) ? 0 : readByte(REGISTER_CMD));
+}  // of method setIdleRegister()
+void VCNL4010::flushRegisters(const uint8_t status) {
+  /*!
+    @brief     Writes any queued measurement parameter registers whose sensor is idle
+    @details   In self-timed mode BIT_SELFTIMED_EN is turned off while the registers are written and
+               then turned back on, otherwise a register is only written if the on-demand bit for
+               its sensor is clear in the "status" value
+    @param[in] status Current contents of REGISTER_CMD
+  */
+  if (!_dirty) return;  // Nothing queued
+  const uint8_t commandRegister = _shadow[0];
+  const bool    selfTimed       = commandRegister & _BV(BIT_SELFTIMED_EN);
+  uint8_t       writable{0};  // Queued registers which can be written now
+  for (uint8_t i = 0; i < VCNL4010_IDLE_REGISTERS; ++i) {
+    if ((_dirty & _BV(i)) && (selfTimed || !(status & _BV(idleOnDemandBit[i])))) {
+      writable |= _BV(i);
+    }  // if-then register can be written
+  }    // for-next each queued register
+  if (!writable) return;
+  if (selfTimed) writeRegister(REGISTER_CMD, commandRegister & ~_BV(BIT_SELFTIMED_EN));
+  for (uint8_t i = 0; i < VCNL4010_IDLE_REGISTERS; ++i) {
+    if (writable & _BV(i)) writeRegister(idleRegister[i], _pending[i]);
+  }                                              // for-next each register to write
+  _dirty &= ~writable;                           // Clear the written registers
+  writeRegister(REGISTER_CMD, commandRegister);  // switch continuous back on if it was set
+}  // of method flushRegisters()
+void VCNL4010::flush() {
+  /*!
+    @brief     Waits until all queued measurement parameter changes have been written
+    @details   This is a blocking call for programs that need the new settings to be active before
+               continuing; service() will write the changes without blocking. It waits at most
+               VCNL4010_TIMEOUT microseconds, see flush(timeoutMicros)
+  */
+  flush(VCNL4010_TIMEOUT);
+}  // of method flush()
+uint8_t VCNL4010::flush(const uint32_t timeoutMicros) {
+  /*!
+    @brief     Waits until all queued measurement parameter changes have been written or the
+               timeout has expired
+    @details   See waitFor() for the error handling
+    @param[in] timeoutMicros Longest time to wait in microseconds
+    @return    VCNL4010_I2C_OK, VCNL4010_DEADLINE or the status of the failed bus transaction
+  */
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_CONFIG);
+  return waitFor(0, timeoutMicros);
+}  // of method flush()
+uint8_t VCNL4010::waitFor(const uint8_t ready, const uint32_t timeoutMicros) {
+  /*!
+    @brief     Runs service() until a reading is available or all queued settings are written
+    @details   A failed bus transaction is followed by one recover() per call, after which the wait
+               continues. The timeout is checked before each service() step, so the call returns
+               at most one service() step and one recover() after the timeout has expired
+    @param[in] ready Ready bits of the readings to wait for, 0 to wait for the queued settings
+    @param[in] timeoutMicros Longest time to wait in microseconds
+    @return    VCNL4010_I2C_OK, VCNL4010_DEADLINE or the status of the failed bus transaction
+  */
+  const uint32_t start = _bus->micros();
+  bool           recovered{false};  // Set after the first recovery attempt
+  while (ready ? !(_fresh & ready) : _dirty) {
+    if (_bus->micros() - start >= timeoutMicros) return VCNL4010_DEADLINE;
+    VCNL4010_STATS_SPIN();
+    service();
+    if (_i2cStatus == VCNL4010_I2C_OK) continue;
+    const uint8_t status = _i2cStatus;
+    if (recovered || recover() != VCNL4010_I2C_OK) return status;
+    recovered = true;
+  }  // while-loop not ready
+  return VCNL4010_I2C_OK;
+}  // of method waitFor()
+uint8_t VCNL4010::recover() {
+  /*!
+    @brief     Recovers from a bus or device failure
+    @details   The bus transport's recover() is called, for VCNL4010WireBus this clocks out a stuck
+               bus and restarts the Wire library. Then the product ID is checked and the complete
+               configuration, including queued settings, is written from the shadow registers in
+               case the device has been reset. Measurements in progress are restarted. The time
+               taken is available from getRecoveryMicros()
+    @return    VCNL4010_I2C_OK if the device was found and configured, otherwise the failed status
+  */
+  const uint32_t start = _bus->micros();
+  ++_recoveries;
+  _bus->lock();
+  _bus->recover();  // Not all bus transports support recovery, so the result is not checked
+  _bus->unlock();
+  uint8_t status{VCNL4010_I2C_OK};
+  if (readByte(REGISTER_PRODUCT) != VCNL4010_PRODUCT_VERSION) {
+    status = _i2cStatus != VCNL4010_I2C_OK ? _i2cStatus : VCNL4010_I2C_OTHER;  // Wrong device
+  }  // if-then device not found
+  if (status == VCNL4010_I2C_OK) {
+    for (uint8_t i = 0; i < VCNL4010_IDLE_REGISTERS; ++i) {
+      if (_dirty & _BV(i)) _shadow[shadowIndex(idleRegister[i])] = _pending[i];
+    }  // for-next each queued setting
+    _dirty    = 0;
+    _inFlight = 0;
+    const uint8_t idle{0};        // REGISTER_CMD value to stop self-timed measurements
+    const uint8_t clear{0b1111};  // REGISTER_INTERRUPT_STATUS value to clear all bits
+    if (writeBlock(REGISTER_CMD, &idle, 1) && writeBlock(REGISTER_PROXIMITY_RATE, &_shadow[1], 3) &&
+        writeBlock(REGISTER_INTERRUPT, &_shadow[4], 5) &&
+        writeBlock(REGISTER_INTERRUPT_STATUS, &clear, 1) &&
+        writeBlock(REGISTER_PROXIMITY_TIMING, &_shadow[9], 1) &&
+        writeBlock(REGISTER_CMD, &_shadow[0], 1)) {
+      startMeasurement();  // Restart on-demand measurements
+    }                      // if-then configuration written
+    status = _i2cStatus;
+  }  // if-then device found
+  _recoveryMicros = _bus->micros() - start;
+  return status;
+}  // of method recover()
 void VCNL4010::setProximityHz(const uint8_t Hz) {
   /*!
     @brief     set the frequency with which the proximity sensor pulses are sent/read
@@ -146,45 +485,18 @@ void VCNL4010::setProximityHz(const uint8_t Hz) {
                These roughly equate to Hz (2,4,8,16,32,64,128 and 256)
     @param[in] Hz Herz code value, described in details
   */
-  uint8_t setValue{0};  // temp variable for sampling rate
-  if (Hz > 250)
-    setValue = 7;
-  else if (Hz >= 128)
-    setValue = 6;
-  else if (Hz >= 64)
-    setValue = 5;
-  else if (Hz >= 32)
-    setValue = 4;
-  else if (Hz >= 16)
-    setValue = 3;
-  else if (Hz >= 8)
-    setValue = 2;
-  else if (Hz >= 4)
-    setValue = 1;
-  /*************************************************************************************************
-  ** Can only be changed if BIT_SELFTIMED_EN is turned off and the BIT_PROX_OD is switched off by **
-  ** the device upon getting a reading                                                            **
-  *************************************************************************************************/
-  bool commandRegister = readByte(REGISTER_CMD);  // store current setting
-  if (commandRegister & _BV(BIT_SELFTIMED_EN)) {
-    writeByte(REGISTER_CMD, commandRegister & ~_BV(BIT_SELFTIMED_EN));
-  } else {
-    while (readByte(REGISTER_CMD) & _BV(BIT_PROX_OD)) {
-    }                                            // loop until the bit is cleared
-  }                                              // if-then-else continuous
-  writeByte(REGISTER_PROXIMITY_RATE, setValue);  // Write new value to register
-  if (commandRegister & _BV(BIT_SELFTIMED_EN)) {
-    writeByte(REGISTER_CMD, readByte(REGISTER_CMD) & _BV(BIT_SELFTIMED_EN));
-  }  // if-then switch continuous back on
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_CONFIG);
+  setIdleRegister(0, VCNL4010Encode::proximityRate(Hz));  // Write or queue new value
 }  // of method setProximityHz()
-void VCNL4010::setLEDmA(const uint8_t mA) const {
+void VCNL4010::setLEDmA(const uint8_t mA) {
   /*!
     @brief     sets the IR LED current output in milliamps
     @details   Range is between 0mA and 200mA, internally set in steps of 10mA with input values
-    being truncated down to the next lower value. No range checking is performed
+    being truncated down to the next lower value. Values above 200mA are limited to 200mA
     @param[in] mA Milliamps
   */
-  writeByte(REGISTER_LED_CURRENT, (uint8_t)(mA / 10));  // Divide by 10 and write register
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_CONFIG);
+  writeRegister(REGISTER_LED_CURRENT, VCNL4010Encode::ledCurrent(mA));  // Write register
 }  // of method setLEDmA()
 void VCNL4010::setProximityFreq(const uint8_t value) {
   /*!
@@ -196,108 +508,403 @@ void VCNL4010::setProximityFreq(const uint8_t value) {
     11 =   3.125  MHz
     @param[in] value 0-3 see details for encoded values
   */
-  uint8_t registerSetting = readByte(REGISTER_PROXIMITY_TIMING);  // Get the register settings
-  registerSetting &= B11100111;                                   // Mask the 2 timing bits
-  registerSetting |= (value & B00000011) << 3;                    // Add in 2 bits from value
-  /**********************************************************************************************
-  ** Can only be changed if BIT_SELFTIMED_EN is turned off and the            **
-  ** BIT_PROX_OD is switched off by the device upon getting a reading         **
-  **********************************************************************************************/
-  bool commandRegister = readByte(REGISTER_CMD);  // store current setting
-  if (commandRegister & _BV(BIT_SELFTIMED_EN)) {
-    writeByte(REGISTER_CMD, commandRegister & ~_BV(BIT_SELFTIMED_EN));
-  } else {
-    while (readByte(REGISTER_CMD) & _BV(BIT_PROX_OD)) {
-    }                                                     // loop until the bit is cleared
-  }                                                       // if-then-else continuous
-  writeByte(REGISTER_PROXIMITY_TIMING, registerSetting);  // Write new buffer back to register
-  if (commandRegister & _BV(BIT_SELFTIMED_EN)) {
-    writeByte(REGISTER_CMD, readByte(REGISTER_CMD) & _BV(BIT_SELFTIMED_EN));
-  }  // if-then switch continuous back on
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_CONFIG);
+  uint8_t registerSetting = idleValue(2);        // Get the register settings
+  registerSetting &= 0b11100111;                 // Mask the 2 timing bits
+  registerSetting |= (value & 0b00000011) << 3;  // Add in 2 bits from value
+  setIdleRegister(2, registerSetting);           // Write or queue new value
 }  // of method setProximityFreq()
-void VCNL4010::setAmbientLight(const uint8_t sample, const uint8_t avg) const {
+void VCNL4010::setAmbientLight(const uint8_t sample, const uint8_t avg) {
   /*!
     @brief     Number of samples to take per second and the number of samples averaged for a reading
     @details   each reading takes 300microseconds and the default period for a measurement is 100ms
     @param[in] sample Samples to take per second
     @param[in] avg    Averages to take per reading (0-128, rounded to nearest correct value)
   */
-  uint8_t workAvg{0};               // work variable
-  uint8_t workSample = sample - 1;  // subtract one for offset
-  if (workSample == 6)
-    workSample = 5;
-  else if (workSample == 8)
-    workSample = 6;
-  else if (workSample > 7)
-    workSample = 7;
-
-  if (avg >= 128)
-    workAvg = B111;
-  else if (avg >= 64)
-    workAvg = B110;
-  else if (avg >= 32)
-    workAvg = B101;
-  else if (avg >= 16)
-    workAvg = B100;
-  else if (avg >= 8)
-    workAvg = B011;
-  else if (avg >= 4)
-    workAvg = B010;
-  else if (avg >= 2)
-    workAvg = B001;
-  uint8_t registerValue = readByte(REGISTER_AMBIENT_PARAM);  // retrieve current settings
-  registerValue &= B10001000;                                // Mask current settings
-  registerValue |= workSample << 4;                          // Set bits 4,5,6
-  registerValue |= workAvg;                                  // Set bits 0,1,2
-  /**********************************************************************************************
-  ** Can only be changed if BIT_SELFTIMED_EN is turned off and the            **
-  ** BIT_ALS_OD is switched off by the device upon getting a reading         **
-  **********************************************************************************************/
-  bool commandRegister = readByte(REGISTER_CMD);  // store current setting
-  if (commandRegister & _BV(BIT_SELFTIMED_EN)) {
-    writeByte(REGISTER_CMD, commandRegister & ~_BV(BIT_SELFTIMED_EN));
-  } else {
-    while (readByte(REGISTER_CMD) & _BV(BIT_ALS_OD)) {
-    }                                                // loop until the bit is cleared
-  }                                                  // if-then-else continuous
-  writeByte(REGISTER_AMBIENT_PARAM, registerValue);  // Write new values to buffer
-  if (commandRegister & _BV(BIT_SELFTIMED_EN)) {
-    writeByte(REGISTER_CMD, readByte(REGISTER_CMD) & _BV(BIT_SELFTIMED_EN));
-  }  // if-then switch continuous back on
-
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_CONFIG);
+  uint8_t registerValue = idleValue(1);                    // retrieve current settings
+  registerValue &= 0b10001000;                             // Mask current settings
+  registerValue |= VCNL4010Encode::ambientRate(sample);    // Set bits 4,5,6
+  registerValue |= VCNL4010Encode::ambientAveraging(avg);  // Set bits 0,1,2
+  setIdleRegister(1, registerValue);                       // Write or queue new value
 }  // of method setAmbientLight()
-uint16_t VCNL4010::getAmbientLight() const {
+void VCNL4010::service() {
+  /*!
+    @brief     Cooperative state machine step, call regularly from the main program loop
+    @details   The command register and the new results are read with readResults(). New
+               readings are stored and can be retrieved with tryGetProximity() and
+               tryGetAmbientLight(). Then any queued parameter changes are written if the sensor
+               is idle, and a new on-demand measurement is started for each sensor in triggered
+               mode which is not already measuring. This call never waits for the device. In
+               streaming mode serviceStream() is called instead, see beginStream()
+  */
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_SERVICE);
+  if (_streamRing) {
+    serviceStream();  // Streaming reads the status first
+    return;
+  }  // if-then streaming
+  if (_interruptTriggered) {
+    handleInterrupt();  // Reads the results along with the interrupt status
+    return;
+  }  // if-then an interrupt is waiting to be handled
+  uint8_t buffer[REGISTER_PROXIMITY + 2 - REGISTER_CMD];  // Registers 0x80 through 0x88
+  if (readResults(buffer)) storeResults(buffer);
+}  // of method service()
+bool VCNL4010::readResults(uint8_t *buffer) {
+  /*!
+    @brief     Reads REGISTER_CMD and the results whose data ready bit is set
+    @details   REGISTER_CMD is read on its own and then only the results flagged as ready. In a
+               burst read starting at REGISTER_CMD, a measurement finished after the status byte
+               was read would have its data ready bit cleared by the read of its MSB without being
+               seen, and the reading would be lost. A result which is not read keeps its data ready
+               bit for the next call. When both results are ready they are read in one burst
+    @param[out] buffer Registers REGISTER_CMD through REGISTER_PROXIMITY+1, the results which were
+               not ready are left unchanged
+    @return    "true" if all reads succeeded
+  */
+  if (readBlock(REGISTER_CMD, buffer, 1) != 1) return false;
+  const bool    ambient   = buffer[0] & _BV(BIT_ALS_DATA_RDY);
+  const bool    proximity = buffer[0] & _BV(BIT_PROX_DATA_RDY);
+  const uint8_t first     = ambient ? REGISTER_AMBIENT_LIGHT : REGISTER_PROXIMITY;
+  const uint8_t length    = (ambient && proximity) ? 4 : 2;
+  if (!ambient && !proximity) return true;  // No new results
+  return readBlock(first, buffer + first - REGISTER_CMD, length) == length;
+}  // of method readResults()
+void VCNL4010::storeResults(const uint8_t *buffer) {
+  /*!
+    @brief     Stores the results read by readResults() and starts the next step
+    @details   Common code for service() and handleInterrupt(). New readings are stored, queued
+               parameter changes are written and on-demand measurements are re-triggered
+    @param[in] buffer Contents of registers REGISTER_CMD through at least REGISTER_PROXIMITY+1
+  */
+  const uint8_t status = buffer[0];
+  if (status & _BV(BIT_ALS_DATA_RDY)) {
+    _sample.ambient = (uint16_t)buffer[REGISTER_AMBIENT_LIGHT - REGISTER_CMD] << 8 |
+                      buffer[REGISTER_AMBIENT_LIGHT + 1 - REGISTER_CMD];
+    if (_ambientFilter) _sample.ambient = _ambientFilter->filter(_sample.ambient);
+  }  // if-then new ALS reading
+  if (status & _BV(BIT_PROX_DATA_RDY)) {
+    _sample.proximity = (uint16_t)buffer[REGISTER_PROXIMITY - REGISTER_CMD] << 8 |
+                        buffer[REGISTER_PROXIMITY + 1 - REGISTER_CMD];
+    if (_proximityFilter) _sample.proximity = _proximityFilter->filter(_sample.proximity);
+  }  // if-then new PROX reading
+  _sample.status = status;
+  _fresh |= status & (_BV(BIT_ALS_DATA_RDY) | _BV(BIT_PROX_DATA_RDY));
+  _inFlight = status & (_BV(BIT_ALS_OD) | _BV(BIT_PROX_OD));
+  flushRegisters(status);  // Write queued parameters for idle sensors
+  startMeasurement();      // and start the next readings
+}  // of method storeResults()
+void VCNL4010::serviceStream() {
+  /*!
+    @brief     service() step in streaming mode
+    @details   REGISTER_CMD is read on its own, because in a burst read starting at REGISTER_CMD a
+               reading finished after the status byte was read would be cleared without being
+               seen. New results are then read. A proximity result which could have been replaced
+               by the next measurement while it was read is checked by reading its MSB again,
+               which is repeated up to VCNL4010_STREAM_RETRIES times. The device always holds the
+               latest measurement, so the reading is timestamped with the last measurement time
+               before it was read, counted in measurement periods from the previous reading and
+               limited to the time since the previous status read. The measurements in between
+               are counted as dropped
+  */
+  const uint32_t polled = _bus->micros();
+  const uint8_t  status = readByte(REGISTER_CMD);
+  if (_i2cStatus != VCNL4010_I2C_OK) return;
+  uint8_t buffer[2];  // Result MSB and LSB
+  if ((status & _BV(BIT_ALS_DATA_RDY)) && readBlock(REGISTER_AMBIENT_LIGHT, buffer, 2) == 2) {
+    _sample.ambient = (uint16_t)buffer[0] << 8 | buffer[1];
+    if (_ambientFilter) _sample.ambient = _ambientFilter->filter(_sample.ambient);
+    _fresh |= _BV(BIT_ALS_DATA_RDY);
+  }  // if-then new ALS reading
+  if ((status & _BV(BIT_PROX_DATA_RDY)) && readBlock(REGISTER_PROXIMITY, buffer, 2) == 2) {
+    const uint32_t period = VCNL4010Encode::proximityPeriod(_shadow[1] & 0b111);
+    if (!_streamSynced || _bus->micros() - _streamPoll >= period - period / 8) {
+      for (uint8_t retry = 0; retry < VCNL4010_STREAM_RETRIES; ++retry) {
+        const uint8_t msb = readByte(REGISTER_PROXIMITY);
+        if (_i2cStatus != VCNL4010_I2C_OK || msb == buffer[0]) break;
+        ++_streamRetries;  // A new measurement replaced the result while it was read
+        if (readBlock(REGISTER_PROXIMITY, buffer, 2) != 2) break;
+      }  // for-next each read of the MSB
+    }    // if-then the next measurement could have finished during the read
+    const uint32_t seen = _bus->micros();
+    uint32_t       time = seen;
+    if (_streamSynced) {
+      uint32_t steps = (seen - _streamLast) / period;  // Measurements since the last reading
+      if (steps == 0) steps = 1;
+      if ((int32_t)(_streamLast + steps * period - seen) < 0) time = _streamLast + steps * period;
+      if ((int32_t)(time - _streamPoll) < 0) time = _streamPoll;  // Device slower than nominal
+      _streamDropped += steps - 1;
+      _streamSequence += steps - 1;
+    }  // if-then previous reading known
+    uint16_t value = (uint16_t)buffer[0] << 8 | buffer[1];
+    if (_proximityFilter) value = _proximityFilter->filter(value);
+    _streamLast       = time;
+    _streamSynced     = true;
+    _sample.proximity = value;
+    _fresh |= _BV(BIT_PROX_DATA_RDY);
+    _streamRing->push({time, value, ++_streamSequence});
+  }  // if-then new PROX reading
+  _streamPoll    = polled;
+  _sample.status = status;
+  _inFlight      = status & (_BV(BIT_ALS_OD) | _BV(BIT_PROX_OD));
+  const uint8_t dirty = _dirty;
+  flushRegisters(status);
+  if (_dirty != dirty) _streamSynced = false;  // Measurements restart with the new settings
+  startMeasurement();
+}  // of method serviceStream()
+void VCNL4010::startMeasurement() {
+  /*!
+    @brief     Starts an on-demand measurement for each sensor in triggered mode
+    @details   Sensors in continuous mode and sensors which are already measuring are skipped, so
+               at most one write to REGISTER_CMD is made and none if nothing needs to be started.
+               Only the new on-demand bits are written, writing the bit of a measurement which has
+               just finished would start another one
+  */
+  uint8_t trigger{0};  // On-demand bits to set
+  if (!_ContinuousAmbient && !(_inFlight & _BV(BIT_ALS_OD))) trigger |= _BV(BIT_ALS_OD);
+  if (!_ContinuousProximity && !(_inFlight & _BV(BIT_PROX_OD))) trigger |= _BV(BIT_PROX_OD);
+  if (!trigger) return;
+  _inFlight |= trigger;
+  writeByte(REGISTER_CMD, _shadow[0] | trigger);  // 0 bits do not stop running measurements
+}  // of method startMeasurement()
+VCNL4010State VCNL4010::poll() {
+  /*!
+    @brief     Runs one service() step and reports whether a new reading is available
+    @return    VCNL4010_READY if a new ambient or proximity reading is waiting to be retrieved,
+               otherwise VCNL4010_PENDING
+  */
+  service();
+  return _fresh ? VCNL4010_READY : VCNL4010_PENDING;
+}  // of method poll()
+bool VCNL4010::tryGetAmbientLight(uint16_t &value) {
+  /*!
+    @brief     Retrieves a new ambient light reading if one is available
+    @details   Does not access the device, readings are collected by service()
+    @param[out] value Reading, only changed if a new reading is available
+    @return    "true" if a new reading was returned, otherwise "false"
+  */
+  if (!(_fresh & _BV(BIT_ALS_DATA_RDY))) return false;
+  _fresh &= ~_BV(BIT_ALS_DATA_RDY);
+  value = _sample.ambient;
+  return true;
+}  // of method tryGetAmbientLight()
+bool VCNL4010::tryGetProximity(uint16_t &value) {
+  /*!
+    @brief     Retrieves a new proximity reading if one is available
+    @details   Does not access the device, readings are collected by service()
+    @param[out] value Reading, only changed if a new reading is available
+    @return    "true" if a new reading was returned, otherwise "false"
+  */
+  if (!(_fresh & _BV(BIT_PROX_DATA_RDY))) return false;
+  _fresh &= ~_BV(BIT_PROX_DATA_RDY);
+  value = _sample.proximity;
+  return true;
+}  // of method tryGetProximity()
+uint16_t VCNL4010::getAmbientLight() {
   /*!
     @brief     retrieves the 16 bit ambient light value.
     @details   Since we always send a request for another reading after retrieving the previous
-    results we just need to wait for a result to come back.
-    @return unsigned integer 16 measurement value
+    results we just need to wait for a result to come back. This call waits at most VCNL4010_TIMEOUT
+    microseconds for a reading, use tryGetAmbientLight() together with service() to avoid waiting
+    @return unsigned integer 16 measurement value, the previous one if no reading was available
   */
-  while ((readByte(REGISTER_CMD) & _BV(BIT_ALS_DATA_RDY)) == 0) {  // Loop until bit is set
-  }
-  uint16_t returnValue = readWord(REGISTER_AMBIENT_LIGHT);  // retrieve the reading
-  if (!_ContinuousAmbient)                                  // Only trigger if not continuous
-  {
-    writeByte(REGISTER_CMD, readByte(REGISTER_CMD) | _BV(BIT_ALS_OD));  // Trigger for next reading
-  }  // of if-then Continuous mode turned on
+  uint16_t returnValue{_sample.ambient};
+  getAmbientLight(returnValue, VCNL4010_TIMEOUT);
   return returnValue;
 }  // of method getAmbientLight()
-uint16_t VCNL4010::getProximity() const {
+uint8_t VCNL4010::getAmbientLight(uint16_t &value, const uint32_t timeoutMicros) {
+  /*!
+    @brief     retrieves the 16 bit ambient light value within a timeout
+    @details   See waitFor() for the error handling
+    @param[out] value Reading, only changed if a new reading is available
+    @param[in] timeoutMicros Longest time to wait in microseconds
+    @return    VCNL4010_I2C_OK, VCNL4010_DEADLINE or the status of the failed bus transaction
+  */
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_AMBIENT);
+  const uint8_t status = waitFor(_BV(BIT_ALS_DATA_RDY), timeoutMicros);
+  if (status == VCNL4010_I2C_OK) tryGetAmbientLight(value);
+  return status;
+}  // of method getAmbientLight()
+uint16_t VCNL4010::getProximity() {
   /*!
     @brief     retrieves the 16 bit proximity value.
     @details   Since we always send a request for another reading after retrieving the previous
-    results we just need to wait for a result to come back.
-    @return unsigned integer 16 measurement value
+    results we just need to wait for a result to come back. This call waits at most VCNL4010_TIMEOUT
+    microseconds for a reading, use tryGetProximity() together with service() to avoid waiting
+    @return unsigned integer 16 measurement value, the previous one if no reading was available
   */
-  while ((readByte(REGISTER_CMD) & _BV(BIT_PROX_DATA_RDY)) == 0) {  // Loop until bit is set
-  }
-  uint16_t returnValue = readWord(REGISTER_PROXIMITY);  // retrieve the reading
-  if (!_ContinuousProximity)                            // Only trigger if not continuous
-  {
-    writeByte(REGISTER_CMD, readByte(REGISTER_CMD) | _BV(BIT_PROX_OD));  // Trigger for next reading
-  }  // of if-then Continuous mode turned on
+  uint16_t returnValue{_sample.proximity};
+  getProximity(returnValue, VCNL4010_TIMEOUT);
   return returnValue;
 }  // of method getProximity()
+uint8_t VCNL4010::getProximity(uint16_t &value, const uint32_t timeoutMicros) {
+  /*!
+    @brief     retrieves the 16 bit proximity value within a timeout
+    @details   See waitFor() for the error handling
+    @param[out] value Reading, only changed if a new reading is available
+    @param[in] timeoutMicros Longest time to wait in microseconds
+    @return    VCNL4010_I2C_OK, VCNL4010_DEADLINE or the status of the failed bus transaction
+  */
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_PROXIMITY);
+  const uint8_t status = waitFor(_BV(BIT_PROX_DATA_RDY), timeoutMicros);
+  if (status == VCNL4010_I2C_OK) tryGetProximity(value);
+  return status;
+}  // of method getProximity()
+VCNL4010Sample VCNL4010::getAll() {
+  /*!
+    @brief     retrieves both the ambient light and proximity values in one I2C burst
+    @details   Performs one service() step, which reads the command register, then the result
+               bytes of the new readings in one auto-increment transaction, and re-triggers both
+               on-demand measurements with one write. This call does not wait for results; the
+               returned ready flags show which values are new readings that have not been
+               retrieved before
+    @return    VCNL4010Sample structure with both values and the command register status
+  */
+  service();
+  VCNL4010Sample sample = _sample;
+  sample.status &= ~(_BV(BIT_ALS_DATA_RDY) | _BV(BIT_PROX_DATA_RDY));  // Ready flags are
+  sample.status |= _fresh;                                             // set for new values
+  _fresh = 0;                                                          // which are now consumed
+  return sample;
+}  // of method getAll()
+void VCNL4010::onInterrupt() {
+  /*!
+    @brief     Flags that the VCNL4010 has raised its INT pin, call this from the interrupt routine
+    @details   This is safe to call from an ISR as it only records the time and sets a flag, the
+               device is read later by handleInterrupt() or service(). If the previous interrupt
+               has not been handled yet, the two are handled as one and counted as coalesced
+  */
+  if (_interruptTriggered) ++_coalesced;  // Previous one not yet handled
+  _interruptMicros    = _bus->micros();
+  _interruptTriggered = true;
+}  // of method onInterrupt()
+bool VCNL4010::handleInterrupt() {
+  /*!
+    @brief     Deferred interrupt handler, reads the device after onInterrupt() has been called
+    @details   REGISTER_CMD and the new results are read with readResults(), followed by
+               REGISTER_INTERRUPT_STATUS. The readings are stored as in service() and, if
+               capturing, pushed into the capture ring together with the interrupt time. The
+               interrupt bits that were set are then cleared. Call this from the main program
+               loop; service() also calls it when an interrupt is pending
+    @return    "true" if an interrupt was handled, "false" if none was pending
+  */
+  if (!_interruptTriggered) return false;
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_INTERRUPT);
+  uint8_t buffer[REGISTER_INTERRUPT_STATUS + 1 - REGISTER_CMD];  // 0x80 through 0x8E
+  noInterrupts();  // Take time and clear flag atomically
+  const uint32_t interruptMicros = _interruptMicros;
+  _interruptTriggered            = false;
+  interrupts();
+  if (!readResults(buffer)) return true;
+  buffer[REGISTER_INTERRUPT_STATUS - REGISTER_CMD] = readByte(REGISTER_INTERRUPT_STATUS);
+  if (_i2cStatus != VCNL4010_I2C_OK) return true;
+  const uint8_t intStatus = buffer[REGISTER_INTERRUPT_STATUS - REGISTER_CMD] & 0b00001111;
+  if (intStatus) writeByte(REGISTER_INTERRUPT_STATUS, intStatus);  // Write 1 to clear bits
+  _interrupts |= intStatus;
+  storeResults(buffer);
+  VCNL4010CaptureRing *ring = _captureRing;
+  if (ring) {
+    VCNL4010TimedSample sample;
+    sample.micros     = interruptMicros;
+    sample.ambient    = _sample.ambient;
+    sample.proximity  = _sample.proximity;
+    sample.status     = buffer[0];
+    sample.interrupts = intStatus;
+    ring->push(sample);  // Counted as overflow in the ring if it is full
+  }                      // if-then capturing
+  return true;
+}  // of method handleInterrupt()
+void VCNL4010::beginCapture(VCNL4010CaptureRing &ring) {
+  /*!
+    @brief     Starts capturing a timestamped sample into "ring" for each handled interrupt
+    @details   The interrupts themselves are configured with setInterrupt(), e.g. on proximity
+               ready in continuous mode. The INT pin interrupt routine must call onInterrupt() and
+               the main program must call handleInterrupt() or service() regularly. Samples are
+               then removed from the ring by the program, which can take them in batches
+    @param[in] ring Ring buffer to receive the samples, must remain valid until endCapture()
+  */
+  _captureRing = &ring;
+}  // of method beginCapture()
+void VCNL4010::endCapture() {
+  /*!
+    @brief     Stops capturing samples, samples already in the ring are kept
+  */
+  _captureRing = nullptr;
+}  // of method endCapture()
+uint16_t VCNL4010::getCoalescedInterrupts() const {
+  /*!
+    @brief     Returns the number of interrupts that arrived before the previous one was handled
+    @details   These interrupts were handled together, so samples may have been lost before they
+               could be pushed into the capture ring. Samples lost because the ring was full are
+               counted by the ring's overflows() counter
+    @return    Number of coalesced interrupts
+  */
+  noInterrupts();
+  const uint16_t count = _coalesced;
+  interrupts();
+  return count;
+}  // of method getCoalescedInterrupts()
+bool VCNL4010::tryGetInterrupts(uint8_t &bits) {
+  /*!
+    @brief     Retrieves the REGISTER_INTERRUPT_STATUS bits handled by handleInterrupt() since the
+               last call, e.g. to tell a threshold interrupt from a data ready interrupt
+    @details   Does not access the device, the bits are collected by handleInterrupt()
+    @param[out] bits Interrupt status bits, only changed if any were handled
+    @return    "true" if interrupt bits were returned, otherwise "false"
+  */
+  if (!_interrupts) return false;
+  bits        = _interrupts;
+  _interrupts = 0;
+  return true;
+}  // of method tryGetInterrupts()
+void VCNL4010::beginStream(VCNL4010StreamRing &ring) {
+  /*!
+    @brief     Starts streaming every proximity reading into "ring"
+    @details   Proximity measurement is switched to continuous mode at the rate set with
+               setProximityHz(). The main program must call service() more often than the
+               readings are made, each new reading is then pushed into the ring with its estimated
+               time and measurement number, and the program removes them in batches. Readings which
+               were replaced in the device before they could be read are counted by
+               getStreamDropped(), readings lost because the ring was full by the ring's
+               overflows() counter. The INT pin is not handled while streaming
+    @param[in] ring Ring buffer to receive the readings, must remain valid until endStream()
+  */
+  setProximityContinuous(true);
+  flush();
+  _streamDropped  = 0;
+  _streamRetries  = 0;
+  _streamSequence = 0;
+  _streamSynced   = false;
+  _streamPoll     = _bus->micros();
+  _streamRing     = &ring;
+}  // of method beginStream()
+void VCNL4010::endStream() {
+  /*!
+    @brief     Stops streaming, readings already in the ring are kept. The proximity sensor stays
+               in continuous mode
+  */
+  _streamRing = nullptr;
+}  // of method endStream()
+void VCNL4010::setProximityFilter(VCNL4010Filter *filter) {
+  /*!
+    @brief     Sets the filter applied to each new proximity reading
+    @details   The filter runs once for each reading as it is read from the device, so all of the
+               calls returning proximity values, including the captured samples, return filtered
+               values. The filter is reset when it is set
+    @param[in] filter Filter, e.g. a VCNL4010Chain, or nullptr for unfiltered readings
+  */
+  if (filter) filter->reset();
+  _proximityFilter = filter;
+}  // of method setProximityFilter()
+void VCNL4010::setAmbientFilter(VCNL4010Filter *filter) {
+  /*!
+    @brief     Sets the filter applied to each new ambient light reading
+    @details   See setProximityFilter()
+    @param[in] filter Filter, e.g. a VCNL4010Chain, or nullptr for unfiltered readings
+  */
+  if (filter) filter->reset();
+  _ambientFilter = filter;
+}  // of method setAmbientFilter()
 uint8_t VCNL4010::getInterrupt() const {
   /*!
     @brief     retrieves the 4 bits denoting which, if any, interrupts have been triggered
@@ -307,7 +914,7 @@ uint8_t VCNL4010::getInterrupt() const {
                Bit 0 - high threshold interrupt\n
     @return unsigned integer 8, only 4 LSB bits are set
   */
-  return readByte(REGISTER_INTERRUPT_STATUS) & B0001111;  // get register and mask unused bits
+  return readByte(REGISTER_INTERRUPT_STATUS) & 0b0001111;  // get register and mask unused bits
 }  // of method getInterrupt()
 void VCNL4010::clearInterrupt(const uint8_t intVal) const {
   /*!
@@ -321,12 +928,11 @@ void VCNL4010::clearInterrupt(const uint8_t intVal) const {
     value
    @param[in] intVal Use the 4 lsb bit to set the interrupt values
   */
-  writeByte(REGISTER_INTERRUPT_STATUS,
-            (readByte(REGISTER_INTERRUPT_STATUS) & 0xF0) | (~intVal & 0xF));
+  writeByte(REGISTER_INTERRUPT_STATUS, ~intVal & 0xF);  // Upper 4 bits are unused
 }  // of method clearInterrupt()
 void VCNL4010::setInterrupt(const uint8_t count, const bool ProxReady, const bool ALSReady,
                             const bool ProxThreshold, const bool ALSThreshold,
-                            const uint16_t lowThreshold, const uint16_t highThreshold) const {
+                            const uint16_t lowThreshold, const uint16_t highThreshold) {
   /*!
     @brief     sets the interrupts used
     @details   The count is the number of consecutive readings needed in order to trigger an
@@ -343,35 +949,33 @@ void VCNL4010::setInterrupt(const uint8_t count, const bool ProxReady, const boo
     @param[in] lowThreshold
     @param[in] highThreshold
   */
-  uint8_t registerValue = 0;  // Default to 1 count
-  if (count >= 128)
-    registerValue = B111;
-  else if (count >= 64)
-    registerValue = B110;
-  else if (count >= 32)
-    registerValue = B101;
-  else if (count >= 16)
-    registerValue = B100;
-  else if (count >= 8)
-    registerValue = B011;
-  else if (count >= 4)
-    registerValue = B010;
-  else if (count >= 2)
-    registerValue = B001;
-  registerValue = registerValue << 5;         // Move value to position
-  if (ProxReady) registerValue |= B00001000;  // Set Proximity Ready flag
-  if (ALSReady) registerValue |= B00000100;   // Set ALS Ready flag
-  if (ProxThreshold || ALSThreshold)          // If we are setting a threshold
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_CONFIG);
+  uint8_t registerValue = VCNL4010Encode::interruptCount(count);  // Count in bits 5-7
+  if (ProxReady) registerValue |= VCNL4010_INT_PROX_READY;        // Set Proximity Ready flag
+  if (ALSReady) registerValue |= VCNL4010_INT_ALS_READY;          // Set ALS Ready flag
+  if (ProxThreshold || ALSThreshold)                              // If we are setting a threshold
   {
-    registerValue |= B00000010;                                        // Set the flag for threshold
-    if (ALSThreshold) registerValue += 1;                              // Set the flag for ALS
-    writeByte(REGISTER_LOW_THRESH_MSB, (uint8_t)(lowThreshold >> 8));  // Write the MSB
-    writeByte(REGISTER_LOW_THRESH_LSB, (uint8_t)lowThreshold);         // Write the LSB
-    writeByte(REGISTER_HIGH_THRESH_MSB, (uint8_t)(highThreshold >> 8));  // Write the MSB
-    writeByte(REGISTER_HIGH_THRESH_LSB, (uint8_t)highThreshold);         // Write the LSB
+    registerValue |= 0b00000010;                 // Set threshold flag
+    if (ALSThreshold) registerValue += 1;        // Set the flag for ALS
+    setThresholds(lowThreshold, highThreshold);  // Write all 4 bytes in one burst
   }  // of if-then we have threshold interrupts to set
-  writeByte(REGISTER_INTERRUPT, registerValue);
-}  // of method setLEDmA()
+  writeRegister(REGISTER_INTERRUPT, registerValue);
+}  // of method setInterrupt()
+bool VCNL4010::setThresholds(const uint16_t lowThreshold, const uint16_t highThreshold) {
+  /*!
+    @brief     Sets the low and high interrupt threshold values
+    @details   The 4 registers REGISTER_LOW_THRESH_MSB through REGISTER_HIGH_THRESH_LSB are written
+               in one burst transaction, and only if at least one of them has changed. The
+               threshold interrupts themselves are enabled with setInterrupt()
+    @param[in] lowThreshold Low threshold value
+    @param[in] highThreshold High threshold value
+    @return    "true" if the registers were written, "false" if unchanged or on an I2C error
+  */
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_CONFIG);
+  const uint8_t data[4] = {(uint8_t)(lowThreshold >> 8), (uint8_t)lowThreshold,
+                           (uint8_t)(highThreshold >> 8), (uint8_t)highThreshold};
+  return writeRegisters(REGISTER_LOW_THRESH_MSB, data, sizeof(data));
+}  // of method setThresholds()
 void VCNL4010::setAmbientContinuous(const bool ContinuousMode) {
   /*!
     @brief     sets or unsets the continuous measurement mode for the ambient light sensor
@@ -382,7 +986,8 @@ void VCNL4010::setAmbientContinuous(const bool ContinuousMode) {
                continuous.
     @param[in] ContinuousMode "true" for continuous mode, "false" for triggered measurements
   */
-  uint8_t cmdBuf = readByte(REGISTER_CMD) & ~(_BV(BIT_SELFTIMED_EN) | _BV(BIT_ALS_EN));
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_CONFIG);
+  uint8_t cmdBuf = _shadow[0] & ~(_BV(BIT_SELFTIMED_EN) | _BV(BIT_ALS_EN));
   if (ContinuousMode == true)  // If we are turning on
   {
     cmdBuf |= _BV(BIT_SELFTIMED_EN) | _BV(BIT_ALS_EN);          // set bits
@@ -391,7 +996,7 @@ void VCNL4010::setAmbientContinuous(const bool ContinuousMode) {
     if (_ContinuousProximity) cmdBuf |= _BV(BIT_SELFTIMED_EN);  // turned on, set continuous
     _ContinuousAmbient = false;                                 // and set the flag
   }                                                             // of if-then-else we are turning on
-  writeByte(REGISTER_CMD, cmdBuf);                              // Write value back to register
+  writeRegister(REGISTER_CMD, cmdBuf);                          // Write value if it changed
 }  // of method setAmbientContinuous()
 void VCNL4010::setProximityContinuous(const bool ContinuousMode) {
   /*!
@@ -403,7 +1008,8 @@ void VCNL4010::setProximityContinuous(const bool ContinuousMode) {
                continuous.
     @param[in] ContinuousMode "true" for continuous mode, "false" for triggered measurements
   */
-  uint8_t cmdBuf = readByte(REGISTER_CMD) & ~(_BV(BIT_SELFTIMED_EN) | _BV(BIT_PROX_EN));
+  VCNL4010_STATS_SCOPE(VCNL4010_OP_CONFIG);
+  uint8_t cmdBuf = _shadow[0] & ~(_BV(BIT_SELFTIMED_EN) | _BV(BIT_PROX_EN));
   if (ContinuousMode == true)  // If we are turning on
   {
     cmdBuf |= _BV(BIT_SELFTIMED_EN) | _BV(BIT_PROX_EN);       // then set bits
@@ -412,5 +1018,5 @@ void VCNL4010::setProximityContinuous(const bool ContinuousMode) {
     if (_ContinuousAmbient) cmdBuf |= _BV(BIT_SELFTIMED_EN);  // turn on the continuous mode
     _ContinuousProximity = false;                             // set flag
   }                                                           // of if-then-else we are turning on
-  writeByte(REGISTER_CMD, cmdBuf);                            // Write value back to register
+  writeRegister(REGISTER_CMD, cmdBuf);                        // Write value if it changed
 }  // of method setProximityContinuous()
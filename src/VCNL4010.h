@@ -53,6 +53,28 @@ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
 
 | Version| Date       | Developer  | Comments                                                      |
 | ------ | ---------- | ---------- | ------------------------------------------------------------- |
+| 1.2.21 | 2026-10-17 | SV-Zanshin | Added Linux daemon publishing into a shared memory ring       |
+| 1.2.20 | 2026-10-17 | SV-Zanshin | Added VCNL4010Publisher seqlock and bus lock hooks            |
+| 1.2.19 | 2026-10-17 | SV-Zanshin | Added beginStream() streaming of every proximity reading      |
+| 1.2.18 | 2026-10-17 | SV-Zanshin | Added VCNL4010Queue with merged writes and callbacks          |
+| 1.2.17 | 2026-10-17 | SV-Zanshin | Added VCNL4010Recorder and VCNL4010Replay stream recording    |
+| 1.2.16 | 2026-10-17 | SV-Zanshin | Added VCNL4010Power LED current and rate duty cycling         |
+| 1.2.15 | 2026-10-17 | SV-Zanshin | Host benchmark of achieved sample rates in extras/benchmark   |
+| 1.2.14 | 2026-10-17 | SV-Zanshin | Timeouts with status codes, bus recovery and reconfiguration  |
+| 1.2.13 | 2026-10-17 | SV-Zanshin | Compile-time VCNL4010_STATS transaction and latency counters  |
+| 1.2.12 | 2026-10-17 | SV-Zanshin | Ambient light auto-ranging and fixed point lux output         |
+| 1.2.11 | 2026-10-17 | SV-Zanshin | Proximity to distance calibration table, getDistanceMm()      |
+| 1.2.10 | 2026-10-17 | SV-Zanshin | Fixed-point streaming filters, setProximityFilter()           |
+| 1.2.9  | 2026-10-17 | SV-Zanshin | Compile-time VCNL4010Profile register images, shared encoders |
+| 1.2.8  | 2026-10-17 | SV-Zanshin | Adaptive threshold tracking, burst write of thresholds        |
+| 1.2.7  | 2026-10-17 | SV-Zanshin | Added VCNL4010Array for sensors behind I2C multiplexers       |
+| 1.2.6  | 2026-10-17 | SV-Zanshin | Added VCNL4010Sim simulated device on a virtual clock         |
+| 1.2.5  | 2026-10-17 | SV-Zanshin | Pluggable bus transport with Wire, Linux i2c-dev and fake bus |
+| 1.2.4  | 2026-10-17 | SV-Zanshin | Selectable I2C delay policy and bus error detection           |
+| 1.2.3  | 2026-10-17 | SV-Zanshin | Interrupt driven capture of samples into a ring buffer        |
+| 1.2.2  | 2026-10-17 | SV-Zanshin | Non-blocking service()/poll() state machine and tryGet calls  |
+| 1.2.1  | 2026-10-17 | SV-Zanshin | Shadow copy of the configuration registers, added resync()    |
+| 1.2.0  | 2026-10-17 | SV-Zanshin | Added getAll() burst read of both results and readBlock()     |
 | 1.1.0  | 2020-12-25 | SV-Zanshin | Issue #14 - Corrected I2C reads, cleaned up examples          |
 | 1.0.8  | 2019-01-24 | SV-Zanshin | Issue  #9 - Doxygen Documentation and Travis-CI changes       |
 | 1.0.8  | 2018-07-22 | SV-Zanshin | Corrected I2C Datatypes                                       |
@@ -71,8 +93,14 @@ Written by Arnd <Arnd@Zanduino.Com> at https://www.github.com/SV-Zanshin
 | 1.0.b1 | 2016-12-30 | SV-Zanshin | Created class                                                 |
 */
 // clang-format on
+#if defined(ARDUINO)
 #include "Arduino.h"  // Arduino data type definitions
-#include <Wire.h>     // Standard I2C "Wire" library
+#endif
+#include "VCNL4010Bus.h"      // Bus transport used to access the device
+#include "VCNL4010Filter.h"   // Streaming filters for the readings
+#include "VCNL4010Profile.h"  // Register encoders and compile-time configuration profiles
+#include "VCNL4010Ring.h"     // Lock-free ring buffer used for interrupt capture
+#include "VCNL4010Stats.h"    // Optional instrumentation counters
 #ifndef VCNL4010_h    // Guard code definition
 /*! @brief Guard code definition for the VCNL4010 Library */
 #define VCNL4010_h  // Define the name inside guard code
@@ -93,6 +121,23 @@ const uint32_t I2C_HIGH_SPEED_MODE{3400000};      ///< Turbo mode
 const uint8_t VCNL4010_I2C_ADDRESS{0x13};       ///< Device address, fixed value
 const uint8_t VCNL4010_PRODUCT_VERSION{0x21};   ///< Current product ID
 const uint8_t VCNL4010_I2C_MS_DELAY{200};       ///< I2C Delay in communications
+const uint8_t VCNL4010_SHADOW_REGISTERS{10};    ///< Number of shadowed configuration registers
+const uint8_t VCNL4010_IDLE_REGISTERS{3};       ///< Registers only writable when sensor is idle
+const uint8_t VCNL4010_DEADLINE{9};             ///< Status when a timeout expired, see flush()
+#ifndef VCNL4010_TIMEOUT
+/*! @brief Timeout in microseconds of getProximity(), getAmbientLight() and flush() without a
+ *         timeout parameter. Can be overridden */
+#define VCNL4010_TIMEOUT 2000000UL
+#endif
+#ifndef VCNL4010_CAPTURE_SIZE
+/*! @brief Number of samples in VCNL4010CaptureRing, a power of 2 up to 128. Can be overridden */
+#define VCNL4010_CAPTURE_SIZE 16
+#endif
+#ifndef VCNL4010_STREAM_SIZE
+/*! @brief Number of samples in VCNL4010StreamRing, a power of 2 up to 128. Can be overridden */
+#define VCNL4010_STREAM_SIZE 32
+#endif
+const uint8_t VCNL4010_STREAM_RETRIES{3};       ///< Re-reads of a torn proximity result
 const uint8_t REGISTER_CMD{0x80};               ///< Register containing commands
 const uint8_t REGISTER_PRODUCT{0x81};           ///< Register containing product ID
 const uint8_t REGISTER_PROXIMITY_RATE{0x82};    ///< Register containing sampling rate
@@ -115,41 +160,183 @@ const uint8_t BIT_ALS_EN{2};                    ///< enable periodic ALS reading
 const uint8_t BIT_PROX_EN{1};                   ///< enable periodic PROX reading bit
 const uint8_t BIT_SELFTIMED_EN{0};              ///< enable periodic (self-timed) reading bit
 
+struct VCNL4010Sample {
+  /*!
+   * @struct VCNL4010Sample
+   * @brief  Packed result of one combined ambient light and proximity reading as returned by
+   *         getAll(). The "status" byte is the REGISTER_CMD value read in the same burst, so the
+   *         data ready bits indicate which of the two values are new readings
+   */
+  uint16_t ambient;    ///< Ambient light reading, see ambientReady()
+  uint16_t proximity;  ///< Proximity reading, see proximityReady()
+  uint8_t  status;     ///< REGISTER_CMD contents at the time the results were read
+  bool     ambientReady() const { return status & _BV(BIT_ALS_DATA_RDY); }     ///< New ALS value
+  bool     proximityReady() const { return status & _BV(BIT_PROX_DATA_RDY); }  ///< New PROX value
+};  // of struct VCNL4010Sample
+struct VCNL4010TimedSample {
+  /*!
+   * @struct VCNL4010TimedSample
+   * @brief  Sample captured by handleInterrupt(), with the time of the interrupt and the contents
+   *         of REGISTER_INTERRUPT_STATUS showing which interrupt(s) caused it
+   */
+  uint32_t micros;      ///< micros() value when onInterrupt() was called
+  uint16_t ambient;     ///< Ambient light reading
+  uint16_t proximity;   ///< Proximity reading
+  uint8_t  status;      ///< REGISTER_CMD contents, the data ready bits show which values are new
+  uint8_t  interrupts;  ///< Lower 4 bits of REGISTER_INTERRUPT_STATUS, see getInterrupt()
+};  // of struct VCNL4010TimedSample
+/*! @brief Ring buffer type used for interrupt driven sample capture */
+typedef VCNL4010Ring<VCNL4010TimedSample, VCNL4010_CAPTURE_SIZE> VCNL4010CaptureRing;
+struct VCNL4010StreamSample {
+  /*!
+   * @struct VCNL4010StreamSample
+   * @brief  Proximity reading delivered in streaming mode, see beginStream(). The sequence number
+   *         counts the measurements made by the device, so a gap shows dropped readings
+   */
+  uint32_t micros;     ///< Estimated micros() value when the device finished the measurement
+  uint16_t proximity;  ///< Proximity reading
+  uint16_t sequence;   ///< Measurement number
+};  // of struct VCNL4010StreamSample
+/*! @brief Ring buffer type used for streaming proximity readings */
+typedef VCNL4010Ring<VCNL4010StreamSample, VCNL4010_STREAM_SIZE> VCNL4010StreamRing;
+/*! @brief Delay applied after each I2C register access, see setI2CDelay() */
+enum VCNL4010DelayPolicy : uint8_t {
+  VCNL4010_DELAY_NONE   = 0,  ///< No delay
+  VCNL4010_DELAY_SCALED = 1,  ///< VCNL4010_I2C_MS_DELAY at 100KHz, scaled down for faster buses
+  VCNL4010_DELAY_LEGACY = 2   ///< Always VCNL4010_I2C_MS_DELAY, as in library versions up to 1.2.3
+};
+#ifndef VCNL4010_DELAY_POLICY
+/*! @brief Default I2C delay policy, can be overridden at compile time */
+#define VCNL4010_DELAY_POLICY VCNL4010_DELAY_SCALED
+#endif
+/*! @brief Result of poll() */
+enum VCNL4010State : uint8_t {
+  VCNL4010_PENDING = 0,  ///< No new reading available yet
+  VCNL4010_READY   = 1   ///< A new reading can be retrieved with tryGetProximity() or similar
+};
+
 class VCNL4010 {
  public:
   /*!
    * @class VCNL4010
    * @brief Main class definition
    */
-  VCNL4010();
+#if defined(ARDUINO)
+  VCNL4010();  // Uses the default "Wire" bus
+#endif
+  explicit VCNL4010(VCNL4010Bus &bus);  // Uses the given bus transport
   ~VCNL4010();
   bool     begin(void);                                     // Overloaded just device address
   bool     begin(const uint8_t deviceAddress);              // Overloaded just device address
   bool     begin(const uint32_t &i2CSpeed);                 // Overloaded just speed
   bool     begin(const uint8_t   deviceAddress,             // Start I2C communications
                  const uint32_t &i2CSpeed);                 // specifying both parameters
+  bool     begin(const VCNL4010Image &image,                // Start I2C communications and
+                 const uint8_t   deviceAddress = VCNL4010_I2C_ADDRESS,  // write a register image
+                 const uint32_t &i2CSpeed      = I2C_STANDARD_MODE);
   void     setProximityHz(const uint8_t Hz = 2);            // Set proximity Hz sampling rate
-  void     setLEDmA(const uint8_t mA = 20) const;           // Set milliamperes used by IR LED
+  void     setLEDmA(const uint8_t mA = 20);                 // Set milliamperes used by IR LED
   void     setProximityFreq(const uint8_t value = 0);       // Set Frequency value from list
-  uint16_t getAmbientLight() const;                         // Retrieve ambient light reading
-  uint16_t getProximity() const;                            // Retrieve proximity reading
+  uint16_t getAmbientLight();                               // Retrieve ambient light reading
+  uint16_t getProximity();                                  // Retrieve proximity reading
+  uint8_t  getAmbientLight(uint16_t      &value,
+                           const uint32_t timeoutMicros);  // Reading within a timeout
+  uint8_t  getProximity(uint16_t &value, const uint32_t timeoutMicros);  // Reading within timeout
+  VCNL4010Sample getAll();                                  // Retrieve both readings in one burst
+  void           service();                                 // Non-blocking state machine step
+  void           startMeasurement();                        // Trigger on-demand readings
+  VCNL4010State  poll();                                    // service() and check for readings
+  bool           tryGetAmbientLight(uint16_t &value);       // Get ALS reading if available
+  bool           tryGetProximity(uint16_t &value);          // Get PROX reading if available
+  void           flush();                                   // Wait for queued settings written
+  uint8_t        flush(const uint32_t timeoutMicros);       // Same, within a timeout
+  uint8_t        recover();                                 // Recover bus and reapply settings
+  uint32_t       getRecoveryMicros() const { return _recoveryMicros; }  ///< Last recover() time
+  uint16_t       getRecoveries() const { return _recoveries; }  ///< Number of recover() calls
+  uint32_t       getMicros() const { return _bus->micros(); }  ///< Time of the bus transport
+  void           onInterrupt();                             // Call from the INT pin ISR
+  bool           handleInterrupt();                         // Deferred interrupt handling
+  void           beginCapture(VCNL4010CaptureRing &ring);   // Capture samples on interrupts
+  void           endCapture();                              // Stop capturing samples
+  uint16_t       getCoalescedInterrupts() const;            // Interrupts handled as one
+  bool           tryGetInterrupts(uint8_t &bits);           // Interrupt bits handled if any
+  void           beginStream(VCNL4010StreamRing &ring);     // Stream every proximity reading
+  void           endStream();                               // Stop streaming readings
+  uint32_t       getStreamDropped() const { return _streamDropped; }  ///< Readings missed
+  uint16_t       getStreamRetries() const { return _streamRetries; }  ///< Torn reads repeated
+  void           setProximityFilter(VCNL4010Filter *filter);  // Filter new proximity readings
+  void           setAmbientFilter(VCNL4010Filter *filter);    // Filter new ambient readings
   uint8_t  getInterrupt() const;                            // Retrieve Interrupt bits
   void     clearInterrupt(const uint8_t intVal = 0) const;  // Clear Interrupt bits
   uint8_t  readByte(const uint8_t addr) const;              // Read a single byte from device
   uint16_t readWord(const uint8_t addr) const;              // Read two bytes from device
+  uint8_t  readBlock(const uint8_t addr, uint8_t *buffer,
+                     const uint8_t length) const;  // Read consecutive registers from device
   void     writeByte(const uint8_t addr, const uint8_t data) const;  // Write a byte to device
+  bool     writeBlock(const uint8_t addr, const uint8_t *data,
+                      const uint8_t length) const;  // Write consecutive registers to device
+  bool     resync();                                        // Reload shadow registers from device
+  void     setI2CDelay(const VCNL4010DelayPolicy policy);   // Set I2C delay policy
+  uint8_t  getI2CStatus() const;                            // Status of last I2C transaction
+  uint16_t getI2CErrors() const;                            // Count of failed I2C transactions
   void     setAmbientLight(const uint8_t sample = 2,
-                           const uint8_t avg    = 32) const;           // Set samples and avg
+                           const uint8_t avg    = 32);                 // Set samples and avg
   void     setAmbientContinuous(const bool ContinuousMode = true);  // Cont. Ambient sampling on/off
   void     setProximityContinuous(const bool ContinuousMode = true);  // Cont. Prox sampling on/off
   void     setInterrupt(const uint8_t count = 1, const bool ProxReady = false,
                         const bool ALSReady = false, const bool ProxThreshold = false,
                         const bool ALSThreshold = false, const uint16_t lowThreshold = 0,
-                        const uint16_t highThreshold = UINT16_MAX) const;
+                        const uint16_t highThreshold = UINT16_MAX);
+  bool     setThresholds(const uint16_t lowThreshold,
+                         const uint16_t highThreshold);  // Burst write of threshold registers
+#if VCNL4010_STATS
+  const VCNL4010Stats &getStats() const { return _stats; }  ///< Instrumentation counters
+  void                 resetStats() { _stats.reset(); }     ///< Set all counters to 0
+#endif
 
  private:
+  void    writeRegister(const uint8_t addr, const uint8_t data);  // Write if shadow differs
+  bool    writeRegisters(const uint8_t addr, const uint8_t *data,
+                         const uint8_t length);  // Burst write if shadow differs
+  uint8_t idleValue(const uint8_t index) const;                    // Pending or current value
+  void    setIdleRegister(const uint8_t index, const uint8_t data);  // Queue parameter write
+  void    flushRegisters(const uint8_t status);                      // Write queued parameters
+  bool    readResults(uint8_t *buffer);                              // Read status and results
+  void    storeResults(const uint8_t *buffer);                       // Store burst read results
+  void    serviceStream();                                           // service() when streaming
+  uint8_t waitFor(const uint8_t ready, const uint32_t timeoutMicros);  // Wait for bits or flush
+  uint8_t _shadow[VCNL4010_SHADOW_REGISTERS] = {0};  // Copy of writable config registers
+  uint8_t _pending[VCNL4010_IDLE_REGISTERS]  = {0};  // Queued parameter register values
+  uint8_t _dirty                             = 0;    // Bitmask of queued parameter registers
+  uint8_t _fresh                             = 0;    // Ready bits of readings not yet retrieved
+  uint8_t _inFlight                          = 0;    // On-demand bits of running measurements
+  uint8_t _interrupts                        = 0;    // Interrupt bits handled, not yet retrieved
+  VCNL4010Sample _sample                     = {0, 0, 0};  // Last readings
+  VCNL4010CaptureRing *volatile _captureRing        = nullptr;  // Capture destination
+  volatile uint32_t             _interruptMicros    = 0;        // Time of the last interrupt
+  volatile uint16_t             _coalesced          = 0;        // Interrupts handled as one
+  volatile bool                 _interruptTriggered = false;    // Set by onInterrupt()
+  VCNL4010StreamRing *_streamRing     = nullptr;  // Streaming destination
+  uint32_t            _streamLast     = 0;        // Estimated time of the last streamed reading
+  uint32_t            _streamPoll     = 0;        // Time of the previous status read
+  uint32_t            _streamDropped  = 0;        // Readings replaced before they were read
+  uint16_t            _streamSequence = 0;        // Measurement number of the last reading
+  uint16_t            _streamRetries  = 0;        // Result reads repeated because they changed
+  bool                _streamSynced   = false;    // "_streamLast" is valid
+  VCNL4010Bus *_bus;                                   // Bus transport
+  VCNL4010Filter *_proximityFilter = nullptr;          // Filter for proximity readings
+  VCNL4010Filter *_ambientFilter   = nullptr;          // Filter for ambient light readings
   bool    _ContinuousAmbient   = false;                 // If mode turned on for Ambient readings
   bool    _ContinuousProximity = false;                 // If mode turned on for Proximity readings
   uint8_t _I2Caddress          = VCNL4010_I2C_ADDRESS;  // Default to standard I2C address
+  uint32_t            _i2cSpeed       = I2C_STANDARD_MODE;      // I2C speed set in begin()
+  VCNL4010DelayPolicy _i2cPolicy      = VCNL4010_DELAY_POLICY;  // I2C delay policy
+  mutable uint8_t     _i2cStatus      = 0;                      // Status of last I2C transaction
+  mutable uint16_t    _i2cErrors      = 0;                      // Count of failed transactions
+  uint32_t            _recoveryMicros = 0;                      // Time of the last recover()
+  uint16_t            _recoveries     = 0;                      // Number of recover() calls
+#if VCNL4010_STATS
+  mutable VCNL4010Stats _stats;  // Instrumentation counters
+#endif
 };                                                      // of VCNL4010 class definition
 #endif
@@ -0,0 +1,156 @@
+/*! @file VCNL4010Array.cpp
+ @section VCNL4010Array_cpp_intro_section Description
+
+I2C multiplexer support for the VCNL4010 library\n\n
+See VCNL4010Array.h for details
+*/
+#include "VCNL4010Array.h"  // Include the header definition
+
+/***************************************************************************************************
+** VCNL4010Mux                                                                                    **
+***************************************************************************************************/
+VCNL4010Mux::VCNL4010Mux(VCNL4010Bus &bus, const uint8_t address, const uint8_t count)
+    : _bus(&bus), _address(address), _count(count) {
+  /*!
+   * @brief   Class constructor
+   * @param[in] bus Bus transport the multiplexers are connected to
+   * @param[in] address Address of the first multiplexer
+   * @param[in] count Number of multiplexers at consecutive addresses
+   */
+}
+bool VCNL4010Mux::begin(const uint32_t speed) {
+  /*!
+    @brief     Starts the bus and disconnects the channels of all multiplexers
+    @param[in] speed Speed of the I2C bus in Herz
+    @return    "true" if the bus was started and all multiplexers acknowledged
+  */
+  if (!_bus->begin(speed)) return false;
+  bool found{true};
+  for (uint8_t i = 0; i < _count; ++i) {
+    ++_selects;
+    if (_bus->write(_address + i, 0, nullptr, 0) != VCNL4010_I2C_OK) found = false;
+  }  // for-next each multiplexer
+  _channel = VCNL4010_MUX_NONE;
+  return found;
+}  // of method begin()
+uint8_t VCNL4010Mux::select(const uint8_t channel) {
+  /*!
+    @brief     Connects the given channel to the bus
+    @details   Nothing is written if the channel is already selected. When the channel is on a
+               different multiplexer than the selected one, that multiplexer is disconnected first
+    @param[in] channel Channel number, multiplexer number * 8 + port
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  if (channel == _channel) return VCNL4010_I2C_OK;
+  const uint8_t mux = channel / VCNL4010_MUX_CHANNELS;
+  if (mux >= _count) return VCNL4010_I2C_OTHER;
+  if (_channel != VCNL4010_MUX_NONE && _channel / VCNL4010_MUX_CHANNELS != mux) {
+    uint8_t status = deselect();  // Disconnect the other multiplexer
+    if (status != VCNL4010_I2C_OK) return status;
+  }  // if-then switching multiplexers
+  ++_selects;
+  uint8_t status = _bus->write(_address + mux, _BV(channel % VCNL4010_MUX_CHANNELS), nullptr, 0);
+  _channel       = (status == VCNL4010_I2C_OK) ? channel : VCNL4010_MUX_NONE;
+  return status;
+}  // of method select()
+uint8_t VCNL4010Mux::deselect() {
+  /*!
+    @brief     Disconnects the selected channel from the bus
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  if (_channel == VCNL4010_MUX_NONE) return VCNL4010_I2C_OK;
+  ++_selects;
+  uint8_t status = _bus->write(_address + _channel / VCNL4010_MUX_CHANNELS, 0, nullptr, 0);
+  _channel       = VCNL4010_MUX_NONE;  // State is unknown on error, so select again next time
+  return status;
+}  // of method deselect()
+
+/***************************************************************************************************
+** VCNL4010MuxChannel                                                                             **
+***************************************************************************************************/
+VCNL4010MuxChannel::VCNL4010MuxChannel(VCNL4010Mux &mux, const uint8_t channel) {
+  /*!
+   * @brief   Class constructor
+   * @param[in] mux Multiplexer the channel is on
+   * @param[in] channel Channel number
+   */
+  attach(mux, channel);
+}
+void VCNL4010MuxChannel::attach(VCNL4010Mux &mux, const uint8_t channel) {
+  /*!
+    @brief     Sets the multiplexer and channel used
+    @param[in] mux Multiplexer the channel is on
+    @param[in] channel Channel number
+  */
+  _mux     = &mux;
+  _channel = channel;
+}  // of method attach()
+bool VCNL4010MuxChannel::begin(const uint32_t speed) {
+  /*!
+    @brief     Starts the upstream bus
+    @param[in] speed Speed of the I2C bus in Herz
+    @return    "true" if the bus was started
+  */
+  return _mux && _mux->bus().begin(speed);
+}  // of method begin()
+uint8_t VCNL4010MuxChannel::read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                                 const uint8_t length) {
+  /*!
+    @brief     Selects the channel and reads "length" consecutive registers starting at "reg"
+    @param[in] device I2C device address
+    @param[in] reg First register to read
+    @param[out] data Buffer for the register values
+    @param[in] length Number of bytes to read
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  if (!_mux) return VCNL4010_I2C_OTHER;
+  uint8_t status = _mux->select(_channel);
+  if (status != VCNL4010_I2C_OK) return status;
+  return _mux->bus().read(device, reg, data, length);
+}  // of method read()
+uint8_t VCNL4010MuxChannel::write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                                  const uint8_t length) {
+  /*!
+    @brief     Selects the channel and writes "length" bytes starting at register "reg"
+    @param[in] device I2C device address
+    @param[in] reg First register to write
+    @param[in] data Bytes to write
+    @param[in] length Number of bytes to write
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  if (!_mux) return VCNL4010_I2C_OTHER;
+  uint8_t status = _mux->select(_channel);
+  if (status != VCNL4010_I2C_OK) return status;
+  return _mux->bus().write(device, reg, data, length);
+}  // of method write()
+uint32_t VCNL4010MuxChannel::micros() {
+  /*!
+    @brief     Returns the time of the upstream bus
+    @return    Microseconds
+  */
+  return _mux ? _mux->bus().micros() : 0;
+}  // of method micros()
+void VCNL4010MuxChannel::delayMicroseconds(const uint32_t us) {
+  /*!
+    @brief     Waits using the upstream bus
+    @param[in] us Microseconds to wait
+  */
+  if (_mux) _mux->bus().delayMicroseconds(us);
+}  // of method delayMicroseconds()
+bool VCNL4010MuxChannel::recover() {
+  /*!
+    @brief     Tries to recover the upstream bus, the channel is selected again afterwards
+    @return    "true" if the upstream bus was recovered
+  */
+  if (!_mux || !_mux->bus().recover()) return false;
+  _mux->deselect();
+  return true;
+}  // of method recover()
+void VCNL4010MuxChannel::setSettleDelay(const uint16_t us) {
+  /*!
+    @brief     Sets the settle delay of the upstream bus, which is shared by all channels
+    @param[in] us Delay in microseconds
+  */
+  _settleMicros = us;
+  if (_mux) _mux->bus().setSettleDelay(us);
+}  // of method setSettleDelay()
@@ -0,0 +1,226 @@
+/*! @file VCNL4010Array.h
+
+@section VCNL4010Array_intro_section Description
+
+Support for several VCNL4010 sensors on one I2C bus. The VCNL4010 has the fixed I2C address 0x13,
+so more than one sensor per bus needs an I2C multiplexer such as the TCA9548A, which connects the
+bus to any of its 8 downstream channels. Up to 8 multiplexers at consecutive addresses can be used,
+so channel "n" is port n%8 of the multiplexer at address VCNL4010_MUX_ADDRESS + n/8.\n
+\n
+- VCNL4010Mux keeps track of the currently selected channel and only writes to a multiplexer when
+  the channel actually changes. When switching to a channel on another multiplexer the previous
+  multiplexer is first disconnected, so that two sensors are never on the bus at the same time
+- VCNL4010MuxChannel is a VCNL4010Bus which selects its channel before each transaction, so a
+  normal VCNL4010 object can be used on a multiplexer channel
+- VCNL4010Array is a template managing N sensors on channels 0 to N-1:\n
+    VCNL4010Array<8>         sensors(bus);\n
+    VCNL4010ArrayReadings<8> readings;\n
+    sensors.begin(I2C_FAST_MODE);\n
+    sensors.collect(readings);\n
+\n
+The sensors measure in parallel. Each collect() pass reads all sensors once with service(), which
+stores any finished reading and immediately starts the next on-demand measurement, so no pass
+waits on any single sensor and the aggregate sample rate grows with the number of sensors. The
+passes alternate in direction, so the channel selected at the end of one pass is the first one
+used in the next and each pass needs one multiplexer write less.
+
+See main library header file for details
+*/
+#ifndef VCNL4010Array_h
+/*! @brief Guard code definition for the VCNL4010Array header */
+#define VCNL4010Array_h
+#include "VCNL4010.h"  // Sensor class
+
+const uint8_t VCNL4010_MUX_ADDRESS{0x70};  ///< Default address of the first TCA9548A multiplexer
+const uint8_t VCNL4010_MUX_CHANNELS{8};    ///< Number of channels on each multiplexer
+const uint8_t VCNL4010_MUX_NONE{0xFF};     ///< Channel number when no channel is selected
+
+class VCNL4010Mux {
+  /*!
+   * @class VCNL4010Mux
+   * @brief Channel selection on one or more I2C multiplexers at consecutive addresses
+   */
+ public:
+  explicit VCNL4010Mux(VCNL4010Bus &bus, const uint8_t address = VCNL4010_MUX_ADDRESS,
+                       const uint8_t count = 1);
+  bool         begin(const uint32_t speed);    // Start bus and disconnect all channels
+  uint8_t      select(const uint8_t channel);  // Select channel if not already selected
+  uint8_t      deselect();                     // Disconnect the selected channel
+  uint8_t      getChannel() const { return _channel; }  ///< Selected channel or MUX_NONE
+  uint32_t     getSelects() const { return _selects; }  ///< Number of multiplexer writes made
+  VCNL4010Bus &bus() const { return *_bus; }            ///< Upstream bus transport
+
+ private:
+  VCNL4010Bus *_bus;                         // Upstream bus transport
+  uint8_t      _address;                     // Address of the first multiplexer
+  uint8_t      _count;                       // Number of multiplexers
+  uint8_t      _channel{VCNL4010_MUX_NONE};  // Currently selected channel
+  uint32_t     _selects{0};                  // Number of multiplexer writes made
+};                                           // of class VCNL4010Mux
+
+class VCNL4010MuxChannel : public VCNL4010Bus {
+  /*!
+   * @class VCNL4010MuxChannel
+   * @brief VCNL4010Bus for one multiplexer channel, selects the channel before each transaction
+   */
+ public:
+  VCNL4010MuxChannel() {}
+  VCNL4010MuxChannel(VCNL4010Mux &mux, const uint8_t channel);
+  void     attach(VCNL4010Mux &mux, const uint8_t channel);  // Set multiplexer and channel
+  bool     begin(const uint32_t speed) override;
+  uint8_t  read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                const uint8_t length) override;
+  uint8_t  write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                 const uint8_t length) override;
+  uint32_t micros() override;
+  void     delayMicroseconds(const uint32_t us) override;
+  bool     recover() override;
+  void     setSettleDelay(const uint16_t us) override;
+
+ private:
+  VCNL4010Mux *_mux{nullptr};                // Multiplexer the channel is on
+  uint8_t      _channel{VCNL4010_MUX_NONE};  // Channel number
+};                                           // of class VCNL4010MuxChannel
+
+struct VCNL4010ArraySlot : public VCNL4010MuxChannel {
+  /*!
+   * @struct VCNL4010ArraySlot
+   * @brief  One sensor of a VCNL4010Array together with the multiplexer channel it uses. The
+   *         channel base class is constructed before the sensor, so the sensor can be given a
+   *         reference to it and arrays of slots can be default constructed
+   */
+  VCNL4010ArraySlot() : sensor(*this) {}
+  VCNL4010 sensor;  ///< Sensor on this channel
+};                  // of struct VCNL4010ArraySlot
+
+template <uint8_t N>
+struct VCNL4010ArrayReadings {
+  /*!
+   * @struct VCNL4010ArrayReadings
+   * @brief  Readings of all sensors of a VCNL4010Array, stored as one array per value. Bit "n" of
+   *         the ready masks is set when sensor "n" returned a new value, values of the sensors
+   *         without a new reading are left unchanged
+   */
+  uint16_t proximity[N];    ///< Proximity reading of each sensor
+  uint16_t ambient[N];      ///< Ambient light reading of each sensor
+  uint32_t proximityReady;  ///< Bitmask of sensors with a new proximity reading
+  uint32_t ambientReady;    ///< Bitmask of sensors with a new ambient light reading
+};                          // of struct VCNL4010ArrayReadings
+
+template <uint8_t N>
+class VCNL4010Array {
+  /*!
+   * @class VCNL4010Array
+   * @brief N VCNL4010 sensors on channels 0 to N-1 of one or more I2C multiplexers
+   * @details The sensors are accessed with operator[] for configuration. Sensors not found by
+   *          begin() are skipped by trigger() and collect()
+   */
+  static_assert(N >= 1 && N <= 32, "VCNL4010Array supports 1 to 32 sensors");
+
+ public:
+  explicit VCNL4010Array(VCNL4010Bus &bus, const uint8_t muxAddress = VCNL4010_MUX_ADDRESS)
+      : _mux(bus, muxAddress, (N + VCNL4010_MUX_CHANNELS - 1) / VCNL4010_MUX_CHANNELS) {
+    /*!
+     * @brief   Class constructor
+     * @param[in] bus Bus transport the multiplexers are connected to
+     * @param[in] muxAddress Address of the first multiplexer
+     */
+    for (uint8_t i = 0; i < N; ++i) _slots[i].attach(_mux, i);
+  }  // of constructor
+  uint32_t begin(const uint32_t speed = I2C_STANDARD_MODE) {
+    /*!
+      @brief     Starts the bus and initializes all sensors
+      @param[in] speed Speed of the I2C bus in Herz
+      @return    Bitmask of the sensors found
+    */
+    _present = 0;
+    if (!_mux.begin(speed)) return 0;
+    for (uint8_t i = 0; i < N; ++i) {
+      if (_slots[i].sensor.begin(speed)) _present |= (uint32_t)1 << i;
+    }  // for-next each sensor
+    _reverse = true;  // Continue from the last channel
+    return _present;
+  }  // of method begin()
+  VCNL4010 &operator[](const uint8_t index) {
+    /*!
+      @brief     Returns one of the sensors, e.g. for configuration
+      @param[in] index Sensor number, which is also its multiplexer channel
+      @return    Sensor object
+    */
+    return _slots[index].sensor;
+  }  // of method operator[]()
+  uint32_t     getPresent() const { return _present; }  ///< Bitmask of sensors found by begin()
+  VCNL4010Mux &mux() { return _mux; }                  ///< Multiplexer channel selection
+  void         trigger() {
+    /*!
+      @brief     Starts on-demand measurements on all sensors which are not already measuring
+      @details   Only needed after changing the continuous mode settings, since begin() and
+                 collect() start the next measurements themselves
+    */
+    for (uint8_t n = 0; n < N; ++n) {
+      const uint8_t i = next(n);
+      if (_present & ((uint32_t)1 << i)) _slots[i].sensor.startMeasurement();
+    }  // for-next each sensor
+    _reverse = !_reverse;
+  }  // of method trigger()
+  uint32_t collect(VCNL4010ArrayReadings<N> &readings) {
+    /*!
+      @brief     Reads each sensor once and stores the new readings, never waits for the sensors
+      @details   Each sensor gets one service() step, i.e. a status read, a read of its new
+                 results and, for sensors in triggered mode which finished a measurement, one
+                 write to start the next one
+      @param[out] readings New readings and the ready masks of this pass
+      @return    Bitmask of sensors with a new proximity reading
+    */
+    readings.proximityReady = 0;
+    readings.ambientReady   = 0;
+    for (uint8_t n = 0; n < N; ++n) {
+      const uint8_t  i   = next(n);
+      const uint32_t bit = (uint32_t)1 << i;
+      if (!(_present & bit)) continue;
+      VCNL4010 &sensor = _slots[i].sensor;
+      sensor.service();
+      if (sensor.tryGetProximity(readings.proximity[i])) readings.proximityReady |= bit;
+      if (sensor.tryGetAmbientLight(readings.ambient[i])) readings.ambientReady |= bit;
+    }  // for-next each sensor
+    _reverse = !_reverse;
+    return readings.proximityReady;
+  }  // of method collect()
+  uint32_t read(VCNL4010ArrayReadings<N> &readings,
+                const uint32_t            timeoutMicros = VCNL4010_TIMEOUT) {
+    /*!
+      @brief     Blocking read of a new proximity reading from every sensor found by begin()
+      @details   Repeats collect() passes until every sensor has returned a proximity reading or
+                 the timeout has expired, e.g. because a sensor no longer answers. The ready masks
+                 returned accumulate over all of the passes, so the sensors without a reading are
+                 those of getPresent() missing from the result
+      @param[out] readings New readings of all sensors
+      @param[in] timeoutMicros Longest time to wait in microseconds
+      @return    Bitmask of sensors with a new proximity reading
+    */
+    uint32_t       proximity{0}, ambient{0};
+    const uint32_t start = _mux.bus().micros();
+    while (proximity != _present && _mux.bus().micros() - start < timeoutMicros) {
+      proximity |= collect(readings);
+      ambient |= readings.ambientReady;
+    }  // while-loop until all sensors have a reading or the time is up
+    readings.proximityReady = proximity;
+    readings.ambientReady   = ambient;
+    return proximity;
+  }  // of method read()
+
+ private:
+  uint8_t next(const uint8_t n) const {
+    /*!
+      @brief     Returns the sensor to access at position "n" of the current pass
+      @param[in] n Position in the pass
+      @return    Sensor number
+    */
+    return _reverse ? N - 1 - n : n;
+  }  // of method next()
+  VCNL4010Mux       _mux;             // Multiplexer channel selection
+  VCNL4010ArraySlot _slots[N];        // Channel bus and sensor for each channel
+  uint32_t          _present{0};      // Bitmask of sensors found by begin()
+  bool              _reverse{false};  // Direction of the next pass
+};                                    // of class VCNL4010Array
+#endif
@@ -0,0 +1,125 @@
+/*! @file VCNL4010AutoRange.cpp
+ @section VCNL4010AutoRange_cpp_intro_section Description
+
+Auto-ranging of the ambient light measurement for the VCNL4010 library\n\n
+See VCNL4010AutoRange.h for details
+*/
+#include "VCNL4010AutoRange.h"  // Include the header definition
+
+VCNL4010AutoRange::VCNL4010AutoRange(VCNL4010 &sensor) : _sensor(&sensor) {
+  /*!
+   * @brief   Class constructor
+   * @param[in] sensor Sensor to range, begin() must have been called for it
+   */
+}
+void VCNL4010AutoRange::begin(const uint8_t noisePerMille, const uint16_t budget,
+                              const uint8_t maxRate) {
+  /*!
+    @brief     Sets the noise target and starts ranging with 32 conversions per reading
+    @details   The rate only applies in continuous mode, see VCNL4010::setAmbientContinuous()
+    @param[in] noisePerMille Noise target as standard deviation in 1/1000 of the light level. The
+               target is never below 1 count
+    @param[in] budget Highest number of conversions per second, limits the rate
+    @param[in] maxRate Highest number of readings per second, 1 to 10
+  */
+  _target  = noisePerMille;
+  _budget  = budget;
+  _maxRate = maxRate;
+  _noise   = 0;
+  _samples = 0;
+  apply(32);
+  _changes = 0;
+}  // of method begin()
+bool VCNL4010AutoRange::update(const uint16_t counts) {
+  /*!
+    @brief     Processes one ambient light reading
+    @details   The level is an exponential moving average over 8 readings, the noise estimate
+               the mean absolute deviation from it, averaged over all readings since the last step
+               change and then over 32 readings. After 32 readings with the same settings the
+               noise, as standard deviation, is compared to the target. If it is above the target
+               the averaging is doubled until the predicted noise meets the target, if it is below
+               half the target the averaging is halved as long as the predicted noise stays below
+               that. A reading more than 8 times the noise and 4 counts away from the level is a
+               step change, the level is set to it and the noise estimate starts over
+    @param[in] counts Ambient light reading
+    @return    "true" if the averaging and rate were changed
+  */
+  _counts              = counts;
+  const uint32_t value = (uint32_t)counts << 4;
+  if (_readings == 0) {
+    _level    = value;  // First reading with new settings
+    _readings = 1;
+    return false;
+  }  // if-then first reading
+  const uint32_t deviation = value > _level ? value - _level : _level - value;
+  if (_readings >= 4 && deviation > 8 * _noise + (4 << 4)) {
+    _level    = value;  // Step change, start over at the new level
+    _readings = 1;
+    _samples  = 0;
+    return false;
+  }  // if-then step change
+  if (value > _level) {
+    _level += (value - _level) >> 3;
+  } else {
+    _level -= (_level - value) >> 3;
+  }  // if-then-else reading above level
+  if (_samples < 32) ++_samples;
+  if (deviation > _noise) {
+    _noise += (deviation - _noise) / _samples;
+  } else {
+    _noise -= (_noise - deviation) / _samples;
+  }  // if-then-else deviation above noise
+  if (_readings < UINT8_MAX) ++_readings;
+  if (_readings < 32) return false;
+  uint32_t sigma  = _noise * 321 >> 8;  // Standard deviation is 1.25 mean deviation
+  uint32_t target = _level * _target / 1000;
+  uint8_t  averaging{_averaging};
+  if (target < (1 << 4)) target = 1 << 4;  // At least 1 count
+  if (sigma > target) {
+    while (sigma > target && averaging < 128) {
+      averaging <<= 1;
+      sigma = sigma * 181 >> 8;  // Divide by sqrt(2)
+    }  // while-loop too noisy
+  } else {
+    while (averaging > 1 && sigma * 2 <= target) {
+      averaging >>= 1;
+      sigma = sigma * 362 >> 8;  // Multiply by sqrt(2)
+    }  // while-loop less averaging meets the target
+  }    // if-then-else above target
+  if (averaging == _averaging) return false;
+  _noise = sigma * 256 / 321;  // Predicted noise with the new settings
+  apply(averaging);
+  return true;
+}  // of method update()
+bool VCNL4010AutoRange::service() {
+  /*!
+    @brief     Runs one VCNL4010::service() step and processes the ambient light reading, if any
+    @return    "true" if there was a new reading
+  */
+  uint16_t counts;
+  _sensor->service();
+  if (!_sensor->tryGetAmbientLight(counts)) return false;
+  update(counts);
+  return true;
+}  // of method service()
+void VCNL4010AutoRange::apply(const uint8_t averaging) {
+  /*!
+    @brief     Sets the averaging and the highest rate within the maximum and the budget
+    @details   The settings are queued by VCNL4010::setAmbientLight() until the ambient light
+               sensor is idle. The first reading afterwards only sets the level, as it may still
+               have been measured with the old settings
+    @param[in] averaging Conversions per reading, 1, 2, 4 to 128
+  */
+  _rate = 1;
+  for (uint8_t code = 8; code-- > 0;) {
+    const uint8_t Hz = VCNL4010Encode::ambientHz(code);
+    if (Hz <= _maxRate && (uint16_t)Hz * averaging <= _budget) {
+      _rate = Hz;
+      break;
+    }  // if-then rate fits
+  }    // for-next each rate, highest first
+  _averaging = averaging;
+  _readings  = 0;
+  ++_changes;
+  _sensor->setAmbientLight(_rate, _averaging);
+}  // of method apply()
@@ -0,0 +1,68 @@
+/*! @file VCNL4010AutoRange.h
+
+@section VCNL4010AutoRange_intro_section Description
+
+Auto-ranging of the ambient light measurement for the VCNL4010 library. Each ambient light reading
+is the average of 1 to 128 conversions, more conversions reduce the noise by the square root of
+their number but make each reading take longer. The VCNL4010AutoRange class follows the level of
+the readings and the noise, estimated from the differences between consecutive readings, and
+chooses the fewest conversions which keep the noise within a target given relative to the level:\n
+- In bright, stable light few conversions are needed, so readings are available sooner
+- In dim light the relative noise is higher and more conversions are averaged\n
+\n
+The rate of readings in continuous mode is then chosen as the highest rate at which the total
+number of conversions per second stays within a budget, so the power used for measuring stays
+roughly the same. Settings are changed through VCNL4010::setAmbientLight(), which writes them while
+the ambient light sensor is idle. A step change in the light level is recognised as such and does
+not count as noise.\n
+\n
+getLux() converts readings with the datasheet scale of 0.25 lux per count into fixed point lux
+with VCNL4010_LUX_FRACTION_BITS fractional bits, without floating point math.
+
+See main library header file for details
+*/
+#ifndef VCNL4010AutoRange_h
+/*! @brief Guard code definition for the VCNL4010AutoRange header */
+#define VCNL4010AutoRange_h
+#include "VCNL4010.h"  // Sensor class
+
+const uint8_t VCNL4010_LUX_FRACTION_BITS{8};  ///< getLux() returns lux * 2^8
+
+class VCNL4010AutoRange {
+  /*!
+   * @class VCNL4010AutoRange
+   * @brief Chooses the ambient light averaging and rate of a VCNL4010 from light level and noise
+   */
+ public:
+  explicit VCNL4010AutoRange(VCNL4010 &sensor);
+  void     begin(const uint8_t noisePerMille = 10, const uint16_t budget = 160,
+                 const uint8_t maxRate = 10);  // Set target and start ranging
+  bool     update(const uint16_t counts);      // Process a reading
+  bool     service();                          // Process a reading if available
+  uint32_t getLux() const { return countsToLux(_counts); }  ///< Last reading as fixed point lux
+  uint16_t getCounts() const { return _counts; }            ///< Last reading in counts
+  uint16_t getNoise() const { return (uint16_t)(_noise >> 4); }  ///< Mean deviation in counts
+  uint8_t  getAveraging() const { return _averaging; }          ///< Conversions per reading
+  uint8_t  getRate() const { return _rate; }                    ///< Readings per second
+  uint32_t getChanges() const { return _changes; }              ///< Number of setting changes
+  static constexpr uint32_t countsToLux(const uint16_t counts) {
+    /*! @brief Converts counts to lux with VCNL4010_LUX_FRACTION_BITS fractional bits */
+    return (uint32_t)counts << (VCNL4010_LUX_FRACTION_BITS - 2);  // 0.25 lux per count
+  }
+
+ private:
+  void      apply(const uint8_t averaging);  // Set averaging and the matching rate
+  VCNL4010 *_sensor;                         // Sensor being ranged
+  uint32_t  _level{0};                       // Average level in counts, 4 fractional bits
+  uint32_t  _noise{0};                       // Noise estimate in counts, 4 fractional bits
+  uint32_t  _changes{0};                     // Number of setting changes
+  uint16_t  _counts{0};                      // Last reading
+  uint16_t  _budget{160};                    // Conversions per second
+  uint8_t   _target{10};                     // Noise target in 1/1000 of the level
+  uint8_t   _maxRate{10};                    // Highest readings per second
+  uint8_t   _averaging{32};                  // Conversions per reading
+  uint8_t   _rate{2};                        // Readings per second
+  uint8_t   _readings{0};                    // Readings since the last change
+  uint8_t   _samples{0};                     // Readings in the noise estimate, at most 32
+};                                           // of class VCNL4010AutoRange
+#endif
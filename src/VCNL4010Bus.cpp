@@ -0,0 +1,372 @@
+/*! @file VCNL4010Bus.cpp
+ @section VCNL4010Bus_cpp_intro_section Description
+
+Bus transport implementations for the VCNL4010 library\n\n
+See VCNL4010Bus.h for details
+*/
+#include "VCNL4010Bus.h"  // Include the header definition
+#include <string.h>        // memset()
+#if defined(__linux__) && !defined(ARDUINO)
+#include <errno.h>          // errno, ENXIO, EREMOTEIO, ETIMEDOUT
+#include <fcntl.h>          // open()
+#include <linux/i2c-dev.h>  // I2C_RDWR
+#include <linux/i2c.h>      // struct i2c_msg
+#include <sys/ioctl.h>      // ioctl()
+#include <time.h>           // clock_gettime(), nanosleep()
+#include <unistd.h>         // close()
+#endif
+
+#if defined(ARDUINO)
+/***************************************************************************************************
+** VCNL4010WireBus                                                                                **
+***************************************************************************************************/
+VCNL4010WireBus::VCNL4010WireBus(TwoWire &wire, const uint8_t sdaPin, const uint8_t sclPin)
+    : _wire(wire), _sdaPin(sdaPin), _sclPin(sclPin) {
+  /*!
+   * @brief   Class constructor
+   * @param[in] wire TwoWire object to use, defaults to "Wire"
+   * @param[in] sdaPin Pin of the SDA line of "wire", only used by recover()
+   * @param[in] sclPin Pin of the SCL line of "wire", only used by recover()
+   */
+}
+bool VCNL4010WireBus::begin(const uint32_t speed) {
+  /*!
+    @brief     Starts the I2C bus as master
+    @param[in] speed Speed of the I2C bus in Herz
+    @return    Always "true"
+  */
+  _speed = speed;         // Remember speed for recover()
+  _wire.begin();          // Start I2C as master device
+  _wire.setClock(speed);  // Set the I2C speed
+  return true;
+}  // of method begin()
+uint8_t VCNL4010WireBus::read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                              const uint8_t length) {
+  /*!
+    @brief     Reads "length" consecutive registers starting at "reg"
+    @details   The register address is written and the transmission closed before the bytes are
+               requested, with the settle delay between the two
+    @param[in] device I2C device address
+    @param[in] reg First register to read
+    @param[out] data Buffer for the register values
+    @param[in] length Number of bytes to read, limited by the size of the Wire library buffer
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  _wire.beginTransmission(device);           // Address the I2C device
+  _wire.write(reg);                          // Send the register address
+  uint8_t status = _wire.endTransmission();  // Close transmission
+  if (status != VCNL4010_I2C_OK) return status;
+  if (_settleMicros) ::delayMicroseconds(_settleMicros);  // Introduce slight delay
+  uint8_t bytesRead = _wire.requestFrom(device, length);  // Request consecutive bytes
+  for (uint8_t i = 0; i < bytesRead; ++i) {
+    data[i] = _wire.read();  // Read each byte into the buffer
+  }                          // for-next each byte returned
+  return (bytesRead == length) ? VCNL4010_I2C_OK : VCNL4010_I2C_SHORT_READ;
+}  // of method read()
+uint8_t VCNL4010WireBus::write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                               const uint8_t length) {
+  /*!
+    @brief     Writes "length" bytes starting at register "reg"
+    @details   With a length of 0 only the "reg" byte is sent, which is used to address devices
+               without registers such as I2C multiplexers
+    @param[in] device I2C device address
+    @param[in] reg First register to write
+    @param[in] data Bytes to write
+    @param[in] length Number of bytes to write
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  _wire.beginTransmission(device);  // Address the I2C device
+  _wire.write(reg);                 // Send the register address to write
+  for (uint8_t i = 0; i < length; ++i) {
+    _wire.write(data[i]);  // Send the data to write
+  }                        // for-next each byte
+  uint8_t status = _wire.endTransmission();  // Close transmission
+  if (status == VCNL4010_I2C_OK && _settleMicros) ::delayMicroseconds(_settleMicros);
+  return status;
+}  // of method write()
+uint32_t VCNL4010WireBus::micros() {
+  /*!
+    @brief     Returns the Arduino micros() value
+    @return    Microseconds since startup
+  */
+  return ::micros();
+}  // of method micros()
+void VCNL4010WireBus::delayMicroseconds(const uint32_t us) {
+  /*!
+    @brief     Waits using the Arduino delayMicroseconds() function
+    @param[in] us Microseconds to wait
+  */
+  ::delayMicroseconds(us);
+}  // of method delayMicroseconds()
+bool VCNL4010WireBus::recover() {
+  /*!
+    @brief     Frees a bus held low by a device and restarts the Wire library
+    @details   A device that was interrupted in the middle of sending a byte keeps SDA low until it
+               gets the remaining clock pulses. With the Wire library stopped, SCL is pulsed up to 9
+               times at about 100kHz until SDA is released, then a STOP condition is generated and
+               the Wire library is started again at the speed given in begin(). The lines are only
+               ever pulled low or released to the pull-up resistors
+    @return    "true" if both lines were released
+  */
+  _wire.end();  // Release the pins
+  pinMode(_sdaPin, INPUT_PULLUP);
+  pinMode(_sclPin, INPUT_PULLUP);
+  ::delayMicroseconds(5);
+  for (uint8_t i = 0; i < 9 && digitalRead(_sdaPin) == LOW; ++i) {
+    digitalWrite(_sclPin, LOW);  // Pull SCL low
+    pinMode(_sclPin, OUTPUT);
+    ::delayMicroseconds(5);
+    pinMode(_sclPin, INPUT_PULLUP);  // and release it again
+    ::delayMicroseconds(5);
+  }  // for-next each clock pulse while SDA is held low
+  digitalWrite(_sdaPin, LOW);  // STOP condition: SDA low while SCL is high
+  pinMode(_sdaPin, OUTPUT);
+  ::delayMicroseconds(5);
+  pinMode(_sdaPin, INPUT_PULLUP);  // then released
+  ::delayMicroseconds(5);
+  const bool released = digitalRead(_sdaPin) == HIGH && digitalRead(_sclPin) == HIGH;
+  begin(_speed);  // Restart the Wire library
+  return released;
+}  // of method recover()
+#endif
+
+#if defined(__linux__) && !defined(ARDUINO)
+/***************************************************************************************************
+** VCNL4010LinuxBus                                                                               **
+***************************************************************************************************/
+VCNL4010LinuxBus::VCNL4010LinuxBus(const char *device) : _device(device) {
+  /*!
+   * @brief   Class constructor
+   * @param[in] device Path of the i2c-dev character device, e.g. "/dev/i2c-1"
+   */
+}
+VCNL4010LinuxBus::~VCNL4010LinuxBus() {
+  /*!
+   * @brief   Class destructor, closes the device
+   */
+  if (_fd >= 0) close(_fd);
+}
+bool VCNL4010LinuxBus::begin(const uint32_t speed) {
+  /*!
+    @brief     Opens the i2c-dev device
+    @param[in] speed Ignored, the Linux bus speed is set by the kernel
+    @return    "true" if the device could be opened
+  */
+  (void)speed;
+  if (_fd < 0) _fd = open(_device, O_RDWR);
+  return _fd >= 0;
+}  // of method begin()
+static uint8_t transferStatus(const int result, const int messages) {
+  /*!
+    @brief     Maps the result of an ioctl(I2C_RDWR) call to a bus status
+    @details   I2C adapter drivers report a missing acknowledge with ENXIO or EREMOTEIO and a bus
+               that does not complete the transfer in time with ETIMEDOUT
+    @param[in] result Return value of ioctl()
+    @param[in] messages Number of messages in the transfer
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  if (result == messages) return VCNL4010_I2C_OK;
+  if (result >= 0) return VCNL4010_I2C_OTHER;  // Only part of the messages transferred
+  if (errno == ENXIO || errno == EREMOTEIO) return VCNL4010_I2C_NACK_ADDR;
+  if (errno == ETIMEDOUT) return VCNL4010_I2C_TIMEOUT;
+  return VCNL4010_I2C_OTHER;
+}  // of function transferStatus()
+uint8_t VCNL4010LinuxBus::read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                               const uint8_t length) {
+  /*!
+    @brief     Reads "length" consecutive registers starting at "reg"
+    @details   Both the register address write and the data read are done in one ioctl(I2C_RDWR)
+               call, joined with a repeated start condition
+    @param[in] device I2C device address
+    @param[in] reg First register to read
+    @param[out] data Buffer for the register values
+    @param[in] length Number of bytes to read
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  uint8_t                    address = reg;
+  struct i2c_msg             messages[2];
+  struct i2c_rdwr_ioctl_data transfer;
+  messages[0].addr  = device;
+  messages[0].flags = 0;
+  messages[0].len   = 1;
+  messages[0].buf   = &address;
+  messages[1].addr  = device;
+  messages[1].flags = I2C_M_RD;
+  messages[1].len   = length;
+  messages[1].buf   = data;
+  transfer.msgs     = messages;
+  transfer.nmsgs    = 2;
+  if (_fd < 0) return VCNL4010_I2C_OTHER;
+  return transferStatus(ioctl(_fd, I2C_RDWR, &transfer), 2);
+}  // of method read()
+uint8_t VCNL4010LinuxBus::write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                                const uint8_t length) {
+  /*!
+    @brief     Writes "length" bytes starting at register "reg" in one ioctl(I2C_RDWR) call
+    @param[in] device I2C device address
+    @param[in] reg First register to write
+    @param[in] data Bytes to write
+    @param[in] length Number of bytes to write
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  uint8_t                    buffer[256];
+  struct i2c_msg             message;
+  struct i2c_rdwr_ioctl_data transfer;
+  buffer[0] = reg;
+  memcpy(buffer + 1, data, length);
+  message.addr   = device;
+  message.flags  = 0;
+  message.len    = length + 1;
+  message.buf    = buffer;
+  transfer.msgs  = &message;
+  transfer.nmsgs = 1;
+  if (_fd < 0) return VCNL4010_I2C_OTHER;
+  const uint8_t status = transferStatus(ioctl(_fd, I2C_RDWR, &transfer), 1);
+  if (status != VCNL4010_I2C_OK) return status;
+  if (_settleMicros) delayMicroseconds(_settleMicros);
+  return VCNL4010_I2C_OK;
+}  // of method write()
+uint32_t VCNL4010LinuxBus::micros() {
+  /*!
+    @brief     Returns the monotonic clock in microseconds
+    @return    Microseconds, wrapping around like the Arduino micros()
+  */
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)((uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000);
+}  // of method micros()
+void VCNL4010LinuxBus::delayMicroseconds(const uint32_t us) {
+  /*!
+    @brief     Sleeps for the given time
+    @param[in] us Microseconds to wait
+  */
+  struct timespec wait;
+  wait.tv_sec  = us / 1000000;
+  wait.tv_nsec = (long)(us % 1000000) * 1000;
+  while (nanosleep(&wait, &wait) != 0) {
+  }  // Continue sleeping if interrupted by a signal
+}  // of method delayMicroseconds()
+bool VCNL4010LinuxBus::recover() {
+  /*!
+    @brief     Closes and reopens the i2c-dev device
+    @details   Clocking out a stuck bus is done by the kernel's I2C adapter driver, if it supports
+               it, when a transfer times out. Reopening the device gives a clean file descriptor
+    @return    "true" if the device could be opened again
+  */
+  if (_fd >= 0) close(_fd);
+  _fd = -1;
+  return begin(0);
+}  // of method recover()
+#endif
+
+/***************************************************************************************************
+** VCNL4010FakeBus                                                                                **
+***************************************************************************************************/
+VCNL4010FakeBus::VCNL4010FakeBus(const uint8_t address) : _address(address) {
+  /*!
+   * @brief   Class constructor
+   * @details The registers are set to the VCNL4010 power-on defaults
+   * @param[in] address I2C address the fake device answers on
+   */
+  memset(_registers, 0, sizeof(_registers));
+  _registers[0x81] = 0x21;  // Product ID and revision
+  _registers[0x83] = 0x02;  // 20mA LED current
+  _registers[0x84] = 0x1D;  // Ambient light parameters
+  _registers[0x8F] = 0x01;  // Proximity modulator timing
+}
+bool VCNL4010FakeBus::begin(const uint32_t speed) {
+  /*!
+    @brief     Records the bus speed
+    @param[in] speed Speed of the I2C bus in Herz
+    @return    Always "true"
+  */
+  _speed = speed;
+  return true;
+}  // of method begin()
+uint8_t VCNL4010FakeBus::read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                              const uint8_t length) {
+  /*!
+    @brief     Reads "length" consecutive registers through readRegister()
+    @param[in] device I2C device address, anything but the fake device's address is not acked
+    @param[in] reg First register to read
+    @param[out] data Buffer for the register values
+    @param[in] length Number of bytes to read
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  ++_transactions;
+  if (_failStatus) return _failStatus;
+  if (device != _address) return VCNL4010_I2C_NACK_ADDR;
+  if (_settleMicros) advance(_settleMicros);
+  for (uint8_t i = 0; i < length; ++i) {
+    data[i] = readRegister((uint8_t)(reg + i));  // Register pointer auto-increments
+  }                                              // for-next each byte
+  _bytes += 1 + length;
+  return VCNL4010_I2C_OK;
+}  // of method read()
+uint8_t VCNL4010FakeBus::write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                               const uint8_t length) {
+  /*!
+    @brief     Writes "length" consecutive registers through writeRegister()
+    @param[in] device I2C device address, anything but the fake device's address is not acked
+    @param[in] reg First register to write
+    @param[in] data Bytes to write
+    @param[in] length Number of bytes to write
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  ++_transactions;
+  if (_failStatus) return _failStatus;
+  if (device != _address) return VCNL4010_I2C_NACK_ADDR;
+  for (uint8_t i = 0; i < length; ++i) {
+    writeRegister((uint8_t)(reg + i), data[i]);  // Register pointer auto-increments
+  }                                              // for-next each byte
+  _bytes += 1 + length;
+  if (_settleMicros) advance(_settleMicros);
+  return VCNL4010_I2C_OK;
+}  // of method write()
+uint32_t VCNL4010FakeBus::micros() {
+  /*!
+    @brief     Returns the virtual clock
+    @return    Virtual time in microseconds
+  */
+  return _now;
+}  // of method micros()
+void VCNL4010FakeBus::delayMicroseconds(const uint32_t us) {
+  /*!
+    @brief     Advances the virtual clock instead of waiting
+    @param[in] us Microseconds to advance
+  */
+  advance(us);
+}  // of method delayMicroseconds()
+bool VCNL4010FakeBus::recover() {
+  /*!
+    @brief     Counts the recovery and advances the virtual clock by the time 9 clock pulses and a
+               STOP condition take at 100kHz
+    @return    "true" unless transactions are set to fail with setFail()
+  */
+  ++_recoveries;
+  advance(100);
+  return _failStatus == VCNL4010_I2C_OK;
+}  // of method recover()
+void VCNL4010FakeBus::advance(const uint32_t us) {
+  /*!
+    @brief     Advances the virtual clock
+    @param[in] us Microseconds to advance
+  */
+  _now += us;
+}  // of method advance()
+uint8_t VCNL4010FakeBus::readRegister(const uint8_t reg) {
+  /*!
+    @brief     Returns a register value for a bus read
+    @param[in] reg Register address
+    @return    Register value
+  */
+  return _registers[reg];
+}  // of method readRegister()
+void VCNL4010FakeBus::writeRegister(const uint8_t reg, const uint8_t value) {
+  /*!
+    @brief     Stores a register value for a bus write
+    @param[in] reg Register address
+    @param[in] value Value written
+  */
+  _registers[reg] = value;
+}  // of method writeRegister()
@@ -0,0 +1,179 @@
+/*! @file VCNL4010Bus.h
+
+@section VCNL4010Bus_intro_section Description
+
+Bus transport classes for the VCNL4010 library. The VCNL4010 class accesses the device only
+through the abstract VCNL4010Bus interface, which provides register block reads and writes as well
+as the time functions. Three implementations are provided:\n
+- VCNL4010WireBus uses an Arduino "TwoWire" object, by default the global "Wire" object. It is
+  only compiled on Arduino platforms and is used by the VCNL4010 default constructor
+- VCNL4010LinuxBus uses the Linux "/dev/i2c-N" character device. A register read is a single
+  ioctl(I2C_RDWR) call with a write message and a read message joined by a repeated start. It is
+  only compiled on Linux when not building for Arduino
+- VCNL4010FakeBus is an in-memory register file with a virtual clock, used for host-side testing
+\n
+When other tasks or threads share the bus with the VCNL4010, setLock() installs hooks which the
+VCNL4010 class calls around each transaction, e.g. to take and give a FreeRTOS mutex on the ESP32
+or to lock a std::mutex on Linux.
+
+See main library header file for details
+*/
+#ifndef VCNL4010Bus_h
+/*! @brief Guard code definition for the VCNL4010Bus header */
+#define VCNL4010Bus_h
+#if defined(ARDUINO)
+#include "Arduino.h"  // Arduino data type definitions
+#include <Wire.h>     // Standard I2C "Wire" library
+#else
+#include <stddef.h>  // size_t
+#include <stdint.h>  // Fixed width integer types
+#endif
+
+/*******************************************************
+** Status codes returned by the VCNL4010Bus functions **
+*******************************************************/
+const uint8_t VCNL4010_I2C_OK{0};          ///< Transaction succeeded
+const uint8_t VCNL4010_I2C_NACK_ADDR{2};   ///< Device address not acknowledged
+const uint8_t VCNL4010_I2C_NACK_DATA{3};   ///< Data byte not acknowledged
+const uint8_t VCNL4010_I2C_OTHER{4};       ///< Other bus error
+const uint8_t VCNL4010_I2C_TIMEOUT{5};     ///< Bus timeout
+const uint8_t VCNL4010_I2C_SHORT_READ{8};  ///< Fewer bytes were read than requested
+
+/*! @brief Lock hook called around each bus transaction, see VCNL4010Bus::setLock() */
+typedef void (*VCNL4010LockHook)(void *context);
+
+class VCNL4010Bus {
+  /*!
+   * @class VCNL4010Bus
+   * @brief Abstract bus transport used by the VCNL4010 class
+   * @details The status codes returned match the Arduino Wire endTransmission() values, with the
+   *          additional VCNL4010_I2C_SHORT_READ code. The settle delay is the time to wait after
+   *          addressing a register and after a write, see VCNL4010::setI2CDelay()
+   */
+ public:
+  virtual ~VCNL4010Bus() {}
+  virtual bool     begin(const uint32_t speed) = 0;  ///< Start the bus at the given speed in Hz
+  virtual uint8_t  read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                        const uint8_t length) = 0;  ///< Read "length" registers starting at "reg"
+  virtual uint8_t  write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                         const uint8_t length) = 0;  ///< Write "length" bytes starting at "reg"
+  virtual uint32_t micros() = 0;                      ///< Current time in microseconds
+  virtual void     delayMicroseconds(const uint32_t us) = 0;  ///< Wait "us" microseconds
+  virtual bool     recover() { return false; }  ///< Try to recover a stuck bus, if supported
+  virtual void     setSettleDelay(const uint16_t us) { _settleMicros = us; }  ///< Set delay
+  uint16_t         getSettleDelay() const { return _settleMicros; }  ///< Return settle delay
+  void             setLock(VCNL4010LockHook lock, VCNL4010LockHook unlock,
+                           void *context = nullptr) {
+    _lock        = lock;
+    _unlock      = unlock;
+    _lockContext = context;
+  }  ///< Set the hooks called before and after each transaction, nullptr for none
+  void lock() {
+    if (_lock) _lock(_lockContext);
+  }  ///< Call the lock hook
+  void unlock() {
+    if (_unlock) _unlock(_lockContext);
+  }  ///< Call the unlock hook
+
+ protected:
+  uint16_t         _settleMicros{0};      ///< Delay after addressing a register and after writes
+  VCNL4010LockHook _lock{nullptr};        ///< Called before each transaction
+  VCNL4010LockHook _unlock{nullptr};      ///< Called after each transaction
+  void            *_lockContext{nullptr};  ///< Passed to the lock hooks
+};                                         // of class VCNL4010Bus
+
+#if defined(ARDUINO)
+class VCNL4010WireBus : public VCNL4010Bus {
+  /*!
+   * @class VCNL4010WireBus
+   * @brief VCNL4010Bus implementation using an Arduino TwoWire object
+   */
+ public:
+  explicit VCNL4010WireBus(TwoWire &wire = Wire, const uint8_t sdaPin = SDA,
+                           const uint8_t sclPin = SCL);
+  bool     begin(const uint32_t speed) override;
+  uint8_t  read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                const uint8_t length) override;
+  uint8_t  write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                 const uint8_t length) override;
+  uint32_t micros() override;
+  void     delayMicroseconds(const uint32_t us) override;
+  bool     recover() override;
+
+ private:
+  TwoWire &_wire;           // Wire object used for communications
+  uint32_t _speed{100000};  // Speed passed to begin()
+  uint8_t  _sdaPin;         // Pin of the SDA line
+  uint8_t  _sclPin;         // Pin of the SCL line
+};                          // of class VCNL4010WireBus
+#endif
+
+#if defined(__linux__) && !defined(ARDUINO)
+class VCNL4010LinuxBus : public VCNL4010Bus {
+  /*!
+   * @class VCNL4010LinuxBus
+   * @brief VCNL4010Bus implementation using the Linux i2c-dev interface
+   * @details The bus speed is set by the kernel driver or device tree and cannot be changed
+   *          here, the speed passed to begin() is ignored
+   */
+ public:
+  explicit VCNL4010LinuxBus(const char *device = "/dev/i2c-1");
+  ~VCNL4010LinuxBus() override;
+  bool     begin(const uint32_t speed) override;
+  uint8_t  read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                const uint8_t length) override;
+  uint8_t  write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                 const uint8_t length) override;
+  uint32_t micros() override;
+  void     delayMicroseconds(const uint32_t us) override;
+  bool     recover() override;
+
+ private:
+  const char *_device;  // Path of the i2c-dev character device
+  int         _fd{-1};  // File descriptor, -1 when not open
+};                      // of class VCNL4010LinuxBus
+#endif
+
+class VCNL4010FakeBus : public VCNL4010Bus {
+  /*!
+   * @class VCNL4010FakeBus
+   * @brief In-memory VCNL4010Bus implementation with a virtual clock
+   * @details The fake device answers on one I2C address and has 256 registers with the register
+   *          pointer auto-incrementing on both reads and writes. Time only advances through
+   *          delayMicroseconds() or advance(). Derived classes can model device behaviour by
+   *          overriding readRegister() and writeRegister()
+   */
+ public:
+  explicit VCNL4010FakeBus(const uint8_t address = 0x13);
+  bool     begin(const uint32_t speed) override;
+  uint8_t  read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                const uint8_t length) override;
+  uint8_t  write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                 const uint8_t length) override;
+  uint32_t micros() override;
+  void     delayMicroseconds(const uint32_t us) override;
+  bool     recover() override;
+  virtual void advance(const uint32_t us);  ///< Advance the virtual clock
+  uint8_t      getRegister(const uint8_t reg) const { return _registers[reg]; }  ///< Peek
+  void         setRegister(const uint8_t reg, const uint8_t value) {
+    _registers[reg] = value;
+  }  ///< Poke a register value without any side effects
+  uint32_t getTransactions() const { return _transactions; }  ///< Number of bus transactions
+  uint32_t getBytes() const { return _bytes; }                ///< Number of bytes transferred
+  uint32_t getSpeed() const { return _speed; }                ///< Speed passed to begin()
+  uint32_t getRecoveries() const { return _recoveries; }      ///< Number of recover() calls
+  void     setFail(const uint8_t status) { _failStatus = status; }  ///< Fail all transactions
+
+ protected:
+  virtual uint8_t readRegister(const uint8_t reg);  ///< Device side of a register read
+  virtual void    writeRegister(const uint8_t reg, const uint8_t value);  ///< Device side write
+  uint8_t  _registers[256];      ///< Register file
+  uint8_t  _address;             ///< I2C address the fake device answers on
+  uint8_t  _failStatus{0};       ///< Status returned for every transaction when not 0
+  uint32_t _now{0};              ///< Virtual clock in microseconds
+  uint32_t _speed{100000};       ///< Bus speed in Hz
+  uint32_t _transactions{0};     ///< Transaction counter
+  uint32_t _bytes{0};            ///< Byte counter, not counting the address bytes
+  uint32_t _recoveries{0};       ///< Number of recover() calls
+};                               // of class VCNL4010FakeBus
+#endif
@@ -0,0 +1,226 @@
+/*! @file VCNL4010Calibration.cpp
+ @section VCNL4010Calibration_cpp_intro_section Description
+
+Proximity to distance calibration for the VCNL4010 library\n\n
+See VCNL4010Calibration.h for details
+*/
+#include "VCNL4010Calibration.h"  // Include the header definition
+#include <stddef.h>                // offsetof()
+#include <string.h>                // memcpy()
+#if defined(__AVR__)
+#include <avr/pgmspace.h>  // memcpy_P()
+#endif
+
+static uint16_t poolMean(const uint32_t sum, const uint8_t weight) {
+  /*!
+    @brief     Mean of a pool of calibration points, rounded to the nearest integer
+    @param[in] sum Sum of the values in the pool
+    @param[in] weight Number of points in the pool
+    @return    Rounded mean
+  */
+  return (uint16_t)((sum + weight / 2) / weight);
+}  // of function poolMean()
+
+VCNL4010Calibration::VCNL4010Calibration(VCNL4010 &sensor) : _sensor(&sensor) {
+  /*!
+   * @brief   Class constructor
+   * @param[in] sensor Sensor to calibrate, begin() must have been called for it
+   */
+}
+void VCNL4010Calibration::clear() {
+  /*!
+    @brief     Removes all recorded points
+  */
+  _count = 0;
+}  // of method clear()
+bool VCNL4010Calibration::addPoint(const uint16_t distanceMm, const uint8_t readings) {
+  /*!
+    @brief     Measures a calibration point with a target at the given distance
+    @details   Blocks until the given number of proximity readings have been averaged. The first
+               reading is discarded, as it may have been started before the target was in place.
+               The sensor must be set up with the LED current and modulator frequency that will be
+               used later
+    @param[in] distanceMm Distance of the target from the sensor in mm
+    @param[in] readings Number of readings to average
+    @return    "false" if all points are already in use or a reading failed, see
+               VCNL4010::getProximity(value, timeoutMicros), nothing is recorded then
+  */
+  if (_count == VCNL4010_CALIBRATION_POINTS || readings == 0) return false;
+  uint16_t value;
+  if (_sensor->getProximity(value, VCNL4010_TIMEOUT) != VCNL4010_I2C_OK) return false;  // Discard
+  uint32_t total{0};
+  for (uint8_t i = 0; i < readings; ++i) {
+    if (_sensor->getProximity(value, VCNL4010_TIMEOUT) != VCNL4010_I2C_OK) return false;
+    total += value;
+  }  // for-next each reading
+  return addReading(distanceMm, (uint16_t)((total + readings / 2) / readings));
+}  // of method addPoint()
+bool VCNL4010Calibration::addReading(const uint16_t distanceMm, const uint16_t proximity) {
+  /*!
+    @brief     Adds a calibration point with a known proximity reading
+    @param[in] distanceMm Distance in mm
+    @param[in] proximity Proximity reading at that distance
+    @return    "false" if all points are already in use
+  */
+  if (_count == VCNL4010_CALIBRATION_POINTS) return false;
+  _distance[_count]  = distanceMm;
+  _proximity[_count] = proximity;
+  ++_count;
+  return true;
+}  // of method addReading()
+bool VCNL4010Calibration::build(VCNL4010DistanceTable &table) {
+  /*!
+    @brief     Builds a calibration table from the recorded points
+    @details   The points are sorted by distance. The readings must fall with distance, so runs of
+               points where they do not are merged into one point at their average distance and
+               reading (pool adjacent violators). The pooled readings are compared after rounding,
+               so that near the noise floor, where readings flatten out, pools whose readings round
+               to the same value are merged as well. The slope of each segment is then computed as
+               mm per count in 16.16 fixed point, the sensor's LED current and modulator timing
+               are stored and the checksum is set
+    @param[out] table Table to build
+    @return    "true" if the table has at least 2 points, otherwise the table is not valid
+  */
+  for (uint8_t i = 1; i < _count; ++i) {
+    const uint16_t distance  = _distance[i];
+    const uint16_t proximity = _proximity[i];
+    uint8_t        j         = i;
+    while (j > 0 && _distance[j - 1] > distance) {
+      _distance[j]  = _distance[j - 1];  // Insertion sort by distance
+      _proximity[j] = _proximity[j - 1];
+      --j;
+    }  // while-loop moving larger distances up
+    _distance[j]  = distance;
+    _proximity[j] = proximity;
+  }  // for-next each point
+  uint32_t sumDistance[VCNL4010_CALIBRATION_POINTS];   // Pooled distances
+  uint32_t sumProximity[VCNL4010_CALIBRATION_POINTS];  // Pooled readings
+  uint8_t  weight[VCNL4010_CALIBRATION_POINTS];        // Points in each pool
+  uint8_t  pools{0};
+  for (uint8_t i = 0; i < _count; ++i) {
+    sumDistance[pools]  = _distance[i];
+    sumProximity[pools] = _proximity[i];
+    weight[pools]       = 1;
+    ++pools;
+    while (pools > 1 && poolMean(sumProximity[pools - 1], weight[pools - 1]) >=
+                            poolMean(sumProximity[pools - 2], weight[pools - 2])) {
+      sumDistance[pools - 2] += sumDistance[pools - 1];  // Reading did not fall, merge pools
+      sumProximity[pools - 2] += sumProximity[pools - 1];
+      weight[pools - 2] += weight[pools - 1];
+      --pools;
+    }  // while-loop last pool violates the order
+  }    // for-next each point
+  table.magic      = VCNL4010_CALIBRATION_MAGIC;
+  table.ledCurrent = _sensor->readByte(REGISTER_LED_CURRENT);
+  table.timing     = _sensor->readByte(REGISTER_PROXIMITY_TIMING);
+  table.count      = 0;
+  for (uint8_t i = 0; i < pools; ++i) {
+    const uint16_t distance = poolMean(sumDistance[i], weight[i]);
+    if (table.count && distance <= table.distance[table.count - 1]) continue;  // Same distance
+    table.distance[table.count]  = distance;
+    table.proximity[table.count] = poolMean(sumProximity[i], weight[i]);
+    ++table.count;
+  }  // for-next each pool
+  for (uint8_t i = 0; i < VCNL4010_CALIBRATION_POINTS; ++i) {
+    table.slope[i] = 0;
+    if (i + 1 < table.count) {
+      table.slope[i] = ((uint32_t)(table.distance[i + 1] - table.distance[i]) << 16) /
+                       (table.proximity[i] - table.proximity[i + 1]);
+    } else if (i >= table.count) {
+      table.proximity[i] = 0;  // Clear unused entries so the checksum is reproducible
+      table.distance[i]  = 0;
+    }  // if-then-else segment or unused entry
+  }    // for-next each entry
+  table.checksum = checksum(table);
+  return table.count >= 2;
+}  // of method build()
+bool VCNL4010Calibration::begin(const VCNL4010DistanceTable &table) {
+  /*!
+    @brief     Sets the table used by getDistanceMm()
+    @details   The table must remain valid while it is used. It is only accepted if it is valid and
+               was calibrated with the LED current and modulator timing the sensor now uses
+    @param[in] table Calibration table
+    @return    "true" if the table is used, otherwise "false"
+  */
+  if (!isValid(table) || table.ledCurrent != _sensor->readByte(REGISTER_LED_CURRENT) ||
+      table.timing != _sensor->readByte(REGISTER_PROXIMITY_TIMING)) {
+    return false;
+  }  // if-then table does not fit the sensor
+  _table = &table;
+  return true;
+}  // of method begin()
+uint16_t VCNL4010Calibration::getDistanceMm() {
+  /*!
+    @brief     Takes a proximity reading and converts it to a distance
+    @details   Blocks until a reading is available or VCNL4010_TIMEOUT has passed, see
+               VCNL4010::getProximity(value, timeoutMicros)
+    @return    Distance in mm, 0 if no table has been set with begin() or the reading failed
+  */
+  uint16_t proximity;
+  if (!_table || _sensor->getProximity(proximity, VCNL4010_TIMEOUT) != VCNL4010_I2C_OK) return 0;
+  return toDistanceMm(*_table, proximity);
+}  // of method getDistanceMm()
+uint16_t VCNL4010Calibration::toDistanceMm(const VCNL4010DistanceTable &table,
+                                           const uint16_t               proximity) {
+  /*!
+    @brief     Converts a proximity reading to a distance
+    @details   Finds the segment with a binary search and interpolates with its 16.16 slope.
+               Readings above the first point return the shortest distance and readings below the
+               last point the longest distance in the table
+    @param[in] table Valid calibration table
+    @param[in] proximity Proximity reading
+    @return    Distance in mm
+  */
+  if (table.count == 0) return 0;
+  if (proximity >= table.proximity[0]) return table.distance[0];
+  if (proximity <= table.proximity[table.count - 1]) return table.distance[table.count - 1];
+  uint8_t low{0}, high = table.count - 1;  // proximity[low] > proximity > proximity[high]
+  while (high - low > 1) {
+    const uint8_t middle = (low + high) / 2;
+    if (table.proximity[middle] > proximity) {
+      low = middle;
+    } else {
+      high = middle;
+    }  // if-then-else which half
+  }    // while-loop segment not found
+  return table.distance[low] +
+         (uint16_t)((table.slope[low] * (uint32_t)(table.proximity[low] - proximity) + 0x8000) >>
+                    16);
+}  // of method toDistanceMm()
+bool VCNL4010Calibration::isValid(const VCNL4010DistanceTable &table) {
+  /*!
+    @brief     Checks a table, e.g. after reading it from EEPROM
+    @param[in] table Calibration table
+    @return    "true" if the magic byte, number of points and checksum are correct
+  */
+  return table.magic == VCNL4010_CALIBRATION_MAGIC && table.count >= 2 &&
+         table.count <= VCNL4010_CALIBRATION_POINTS && table.checksum == checksum(table);
+}  // of method isValid()
+void VCNL4010Calibration::load(VCNL4010DistanceTable &table, const void *source) {
+  /*!
+    @brief     Copies a table from program memory
+    @details   On AVR processors tables declared with PROGMEM must be copied to RAM before use, on
+               other processors this is a plain copy
+    @param[out] table Table to fill
+    @param[in] source Address of the table in program memory
+  */
+#if defined(__AVR__)
+  memcpy_P(&table, source, sizeof(table));
+#else
+  memcpy(&table, source, sizeof(table));
+#endif
+}  // of method load()
+uint16_t VCNL4010Calibration::checksum(const VCNL4010DistanceTable &table) {
+  /*!
+    @brief     Computes the Fletcher-16 checksum of all bytes of the table before the checksum
+    @param[in] table Calibration table
+    @return    Checksum
+  */
+  const uint8_t *bytes = (const uint8_t *)&table;
+  uint16_t       sum1{0}, sum2{0};
+  for (size_t i = 0; i < offsetof(VCNL4010DistanceTable, checksum); ++i) {
+    sum1 = (sum1 + bytes[i]) % 255;
+    sum2 = (sum2 + sum1) % 255;
+  }  // for-next each byte
+  return (uint16_t)(sum2 << 8 | sum1);
+}  // of method checksum()
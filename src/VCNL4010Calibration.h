@@ -0,0 +1,80 @@
+/*! @file VCNL4010Calibration.h
+
+@section VCNL4010Calibration_intro_section Description
+
+Conversion of proximity readings to distances for the VCNL4010 library. The proximity reading falls
+off nonlinearly with distance and also depends on the LED current and the proximity modulator
+frequency, so the conversion is calibrated for the sensor setup used:\n
+    VCNL4010Calibration   calibration(sensor);\n
+    VCNL4010DistanceTable table;\n
+    calibration.addPoint(10);  // with a target at 10mm from the sensor\n
+    calibration.addPoint(20);  // and so on for a few more distances\n
+    calibration.build(table);\n
+\n
+build() sorts the points by distance, merges points which would make the table non-monotone and
+stores each segment's slope as a 16.16 fixed point value. The VCNL4010DistanceTable is a plain
+structure with a checksum, so it can be written to EEPROM with EEPROM.put(), placed in PROGMEM
+and copied with load(), or copied to other devices using the same LED current and modulator
+frequency. The table stores the values in the processor's byte order, all supported processors
+are little-endian.\n
+\n
+getDistanceMm() then converts a reading with a binary search and one multiplication, without any
+floating point math.
+
+See main library header file for details
+*/
+#ifndef VCNL4010Calibration_h
+/*! @brief Guard code definition for the VCNL4010Calibration header */
+#define VCNL4010Calibration_h
+#include "VCNL4010.h"  // Sensor class
+
+#ifndef VCNL4010_CALIBRATION_POINTS
+/*! @brief Maximum number of points in a VCNL4010DistanceTable, can be overridden */
+#define VCNL4010_CALIBRATION_POINTS 16
+#endif
+const uint8_t VCNL4010_CALIBRATION_MAGIC{0xD1};  ///< First byte of a valid VCNL4010DistanceTable
+
+struct VCNL4010DistanceTable {
+  /*!
+   * @struct VCNL4010DistanceTable
+   * @brief  Calibration table built by VCNL4010Calibration::build(). The proximity readings are
+   *         strictly decreasing and the distances strictly increasing
+   */
+  uint8_t  magic;                                   ///< VCNL4010_CALIBRATION_MAGIC
+  uint8_t  ledCurrent;                              ///< REGISTER_LED_CURRENT when calibrated
+  uint8_t  timing;                                  ///< REGISTER_PROXIMITY_TIMING when calibrated
+  uint8_t  count;                                   ///< Number of points used
+  uint16_t proximity[VCNL4010_CALIBRATION_POINTS];  ///< Proximity reading of each point
+  uint16_t distance[VCNL4010_CALIBRATION_POINTS];   ///< Distance in mm of each point
+  uint32_t slope[VCNL4010_CALIBRATION_POINTS];      ///< mm per count to the next point, 16.16
+  uint16_t checksum;                                ///< Fletcher-16 of all preceding bytes
+};                                                  // of struct VCNL4010DistanceTable
+
+class VCNL4010Calibration {
+  /*!
+   * @class VCNL4010Calibration
+   * @brief Records calibration points and converts proximity readings to distances
+   */
+ public:
+  explicit VCNL4010Calibration(VCNL4010 &sensor);
+  void     clear();                                                    // Remove all points
+  bool     addPoint(const uint16_t distanceMm, const uint8_t readings = 16);  // Measure a point
+  bool     addReading(const uint16_t distanceMm, const uint16_t proximity);  // Add a known point
+  uint8_t  getPoints() const { return _count; }  ///< Number of points recorded
+  bool     build(VCNL4010DistanceTable &table);  // Build table from the points
+  bool     begin(const VCNL4010DistanceTable &table);  // Use table for getDistanceMm()
+  uint16_t getDistanceMm();                             // Distance from a new proximity reading
+  static uint16_t toDistanceMm(const VCNL4010DistanceTable &table,
+                               const uint16_t              proximity);  // Convert a reading
+  static bool     isValid(const VCNL4010DistanceTable &table);  // Check the magic and checksum
+  static void     load(VCNL4010DistanceTable &table, const void *source);  // Copy from PROGMEM
+
+ private:
+  static uint16_t checksum(const VCNL4010DistanceTable &table);  // Fletcher-16 of the table
+  VCNL4010                    *_sensor;                          // Sensor being calibrated
+  const VCNL4010DistanceTable *_table{nullptr};                  // Table used by getDistanceMm()
+  uint16_t _proximity[VCNL4010_CALIBRATION_POINTS];              // Recorded proximity readings
+  uint16_t _distance[VCNL4010_CALIBRATION_POINTS];               // Recorded distances
+  uint8_t  _count{0};                                            // Number of recorded points
+};                                                               // of class VCNL4010Calibration
+#endif
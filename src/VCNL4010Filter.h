@@ -0,0 +1,332 @@
+/*! @file VCNL4010Filter.h
+
+@section VCNL4010Filter_intro_section Description
+
+Streaming filters for the proximity and ambient light readings of the VCNL4010 library. Each filter
+processes one uint16_t reading at a time with integer and fixed point math only, keeps all of its
+state in statically sized members and never allocates memory:\n
+- VCNL4010Ema<Shift>: exponential moving average with a time constant of 2^Shift readings
+- VCNL4010MovingAverage<N>: average of the last N readings, N a power of 2 avoids the division
+- VCNL4010Median<N>: median of the last N readings, N odd
+- VCNL4010Kalman<Q, R>: one dimensional Kalman filter for a constant value with process noise
+  variance Q and measurement noise variance R in counts squared
+- VCNL4010SpikeReject<MaxStep, Count>: ignores readings more than MaxStep away from the last
+  accepted reading, unless Count consecutive readings are that far away\n
+\n
+Filters are combined with VCNL4010Chain, which runs the stages in order. Only the chain is a
+VCNL4010Filter with a virtual function, so the stages are inlined into one another. A chain is
+plugged into the sample path with VCNL4010::setProximityFilter() or setAmbientFilter(), then each
+new reading is filtered once as it is read from the device:\n
+    VCNL4010Chain<VCNL4010SpikeReject<500, 3>, VCNL4010Median<5>, VCNL4010Ema<2>> filter;\n
+    sensor.setProximityFilter(&filter);\n
+\n
+Filters can also be used on their own by calling update() with each reading.
+
+See main library header file for details
+*/
+#ifndef VCNL4010Filter_h
+/*! @brief Guard code definition for the VCNL4010Filter header */
+#define VCNL4010Filter_h
+#include <stdint.h>
+
+class VCNL4010Filter {
+  /*!
+   * @class VCNL4010Filter
+   * @brief Interface of the filters that can be attached to a VCNL4010, see VCNL4010Chain
+   */
+ public:
+  virtual ~VCNL4010Filter() {}
+  virtual uint16_t filter(const uint16_t value) = 0;  ///< Process a reading, return filtered value
+  virtual void     reset()                      = 0;  ///< Forget all previous readings
+};                                                    // of class VCNL4010Filter
+
+template <uint8_t Shift>
+class VCNL4010Ema {
+  /*!
+   * @class VCNL4010Ema
+   * @brief Exponential moving average, each reading has a weight of 1/2^Shift
+   * @details The average is kept with 8 fractional bits and starts at the first reading
+   */
+  static_assert(Shift <= 8, "Shift must be 0 to 8");
+
+ public:
+  uint16_t update(const uint16_t value) {
+    /*!
+      @brief     Adds a reading to the average
+      @param[in] value Reading
+      @return    Average rounded to the nearest count
+    */
+    const uint32_t scaled = (uint32_t)value << 8;
+    if (!_started) {
+      _average = scaled;
+      _started = true;
+    } else if (scaled > _average) {
+      _average += (scaled - _average) >> Shift;
+    } else {
+      _average -= (_average - scaled) >> Shift;
+    }  // if-then-else first reading
+    return (uint16_t)((_average + 0x80) >> 8);
+  }  // of method update()
+  void reset() { _started = false; }  ///< Forget all previous readings
+
+ private:
+  uint32_t _average{0};      // Average with 8 fractional bits
+  bool     _started{false};  // Set after the first reading
+};                           // of class VCNL4010Ema
+
+template <uint8_t N>
+class VCNL4010MovingAverage {
+  /*!
+   * @class VCNL4010MovingAverage
+   * @brief Average of the last N readings, or of all readings while there are fewer than N
+   */
+  static_assert(N >= 1, "N must be at least 1");
+
+ public:
+  uint16_t update(const uint16_t value) {
+    /*!
+      @brief     Adds a reading to the window
+      @param[in] value Reading
+      @return    Average of the readings in the window
+    */
+    if (_count == N) {
+      _sum -= _window[_next];  // Drop the oldest reading
+    } else {
+      ++_count;
+    }  // if-then-else window is full
+    _sum += value;
+    _window[_next] = value;
+    if (++_next == N) _next = 0;
+    if (_count == N && (N & (N - 1)) == 0) {
+      return (uint16_t)(_sum >> log2Of(N));  // Shift instead of dividing
+    }                                        // if-then power of 2 window
+    return (uint16_t)(_sum / _count);
+  }  // of method update()
+  void reset() {
+    /*!
+      @brief     Forgets all previous readings
+    */
+    _sum   = 0;
+    _count = 0;
+    _next  = 0;
+  }  // of method reset()
+
+ private:
+  static constexpr uint8_t log2Of(const uint8_t value) {
+    /*! @brief Integer logarithm base 2 */
+    return value <= 1 ? 0 : 1 + log2Of(value >> 1);
+  }
+  uint16_t _window[N];  // Readings in the window
+  uint32_t _sum{0};     // Sum of the readings in the window
+  uint8_t  _count{0};   // Number of readings in the window
+  uint8_t  _next{0};    // Position of the next reading
+};                      // of class VCNL4010MovingAverage
+
+template <uint8_t N>
+class VCNL4010Median {
+  /*!
+   * @class VCNL4010Median
+   * @brief Median of the last N readings
+   * @details The readings are kept both in arrival order and sorted, each new reading replaces the
+   *          oldest one in the sorted array with one insertion sort pass of at most N steps
+   */
+  static_assert(N >= 1 && N <= 31 && (N & 1), "N must be odd and at most 31");
+
+ public:
+  uint16_t update(const uint16_t value) {
+    /*!
+      @brief     Adds a reading to the window
+      @param[in] value Reading
+      @return    Median of the readings in the window
+    */
+    uint8_t position;
+    if (_count < N) {
+      position = _count++;  // Window not full yet, append
+    } else {
+      const uint16_t oldest = _window[_next];
+      position              = 0;
+      while (_sorted[position] != oldest) ++position;  // Find the oldest reading
+    }                                                   // if-then-else window not full
+    while (position > 0 && _sorted[position - 1] > value) {
+      _sorted[position] = _sorted[position - 1];  // Move larger values up
+      --position;
+    }  // while-loop moving down
+    while (position + 1 < _count && _sorted[position + 1] < value) {
+      _sorted[position] = _sorted[position + 1];  // Move smaller values down
+      ++position;
+    }  // while-loop moving up
+    _sorted[position] = value;
+    _window[_next]    = value;
+    if (++_next == N) _next = 0;
+    return _sorted[_count / 2];
+  }  // of method update()
+  void reset() {
+    /*!
+      @brief     Forgets all previous readings
+    */
+    _count = 0;
+    _next  = 0;
+  }  // of method reset()
+
+ private:
+  uint16_t _window[N];  // Readings in arrival order
+  uint16_t _sorted[N];  // Readings in ascending order
+  uint8_t  _count{0};   // Number of readings in the window
+  uint8_t  _next{0};    // Position of the next reading in _window
+};                      // of class VCNL4010Median
+
+template <uint16_t Q, uint16_t R>
+class VCNL4010Kalman {
+  /*!
+   * @class VCNL4010Kalman
+   * @brief One dimensional Kalman filter for a slowly changing value
+   * @details The estimate is kept with 4 fractional bits and the gain as a 12 bit fraction, so all
+   *          products fit into 32 bits. The gain needs a division, but only until the error
+   *          variance has settled at its steady state value; from then on each reading costs one
+   *          multiplication
+   */
+  static_assert(R > 0, "The measurement noise variance R must not be 0");
+
+ public:
+  uint16_t update(const uint16_t value) {
+    /*!
+      @brief     Adds a reading to the estimate
+      @param[in] value Reading
+      @return    Estimate rounded to the nearest count
+    */
+    const uint32_t scaled = (uint32_t)value << 4;
+    if (!_started) {
+      _estimate = scaled;
+      _variance = R;  // Initial error is that of one measurement
+      _settled  = false;
+      _started  = true;
+      return value;
+    }  // if-then first reading
+    if (!_settled) {
+      const uint32_t prior = _variance + Q;  // Predicted error variance
+      uint32_t       p     = prior;
+      uint32_t       total = prior + R;
+      while (total > UINT16_MAX) {
+        p >>= 1;  // Scale down so the division fits in 32 bits
+        total >>= 1;
+      }  // while-loop too large
+      _gain                    = (uint16_t)((p << 12) / total);  // prior / (prior + R) as 0.12
+      const uint32_t posterior = prior - ((prior * _gain) >> 12);
+      _settled                 = posterior >= _variance;  // Stopped decreasing
+      if (!_settled) _variance = posterior;
+    }  // if-then variance not settled
+    if (scaled > _estimate) {
+      _estimate += ((scaled - _estimate) * _gain) >> 12;
+    } else {
+      _estimate -= ((_estimate - scaled) * _gain) >> 12;
+    }  // if-then-else reading above estimate
+    return (uint16_t)((_estimate + 0x8) >> 4);
+  }  // of method update()
+  void reset() { _started = false; }  ///< Forget all previous readings
+
+ private:
+  uint32_t _estimate{0};     // Estimate with 4 fractional bits
+  uint32_t _variance{R};     // Error variance of the estimate
+  uint16_t _gain{0};         // Kalman gain as 0.12 fraction
+  bool     _settled{false};  // Variance has reached its steady state
+  bool     _started{false};  // Set after the first reading
+};                           // of class VCNL4010Kalman
+
+template <uint16_t MaxStep, uint8_t Count>
+class VCNL4010SpikeReject {
+  /*!
+   * @class VCNL4010SpikeReject
+   * @brief Replaces single outliers with the last accepted reading
+   * @details A reading more than MaxStep away from the last accepted reading is rejected unless
+   *          it is the Count-th such reading in a row, in which case it is taken as a real change
+   */
+  static_assert(Count >= 1, "Count must be at least 1");
+
+ public:
+  uint16_t update(const uint16_t value) {
+    /*!
+      @brief     Checks a reading
+      @param[in] value Reading
+      @return    The reading if accepted, otherwise the last accepted reading
+    */
+    const uint16_t step = value > _last ? value - _last : _last - value;
+    if (!_started || step <= MaxStep || ++_rejected >= Count) {
+      _last     = value;
+      _rejected = 0;
+      _started  = true;
+    } else {
+      ++_total;  // Count the rejected reading
+    }            // if-then-else reading accepted
+    return _last;
+  }  // of method update()
+  void reset() {
+    /*!
+      @brief     Forgets all previous readings
+    */
+    _started  = false;
+    _rejected = 0;
+  }  // of method reset()
+  uint32_t getRejected() const { return _total; }  ///< Number of readings rejected
+
+ private:
+  uint16_t _last{0};         // Last accepted reading
+  uint8_t  _rejected{0};     // Consecutive rejected readings
+  bool     _started{false};  // Set after the first reading
+  uint32_t _total{0};        // Number of readings rejected
+};                           // of class VCNL4010SpikeReject
+
+template <typename... Stages>
+class VCNL4010Stages;
+template <>
+class VCNL4010Stages<> {
+  /*!
+   * @class VCNL4010Stages<>
+   * @brief End of a filter chain, returns the value unchanged
+   */
+ public:
+  uint16_t update(const uint16_t value) { return value; }  ///< Returns the value
+  void     reset() {}                                      ///< Nothing to reset
+};                                                         // of class VCNL4010Stages<>
+template <typename First, typename... Rest>
+class VCNL4010Stages<First, Rest...> {
+  /*!
+   * @class VCNL4010Stages
+   * @brief Filter stages of a VCNL4010Chain, the first stage followed by the others
+   */
+ public:
+  uint16_t update(const uint16_t value) {
+    /*!
+      @brief     Runs the value through all stages
+      @param[in] value Reading
+      @return    Output of the last stage
+    */
+    return _rest.update(_first.update(value));
+  }  // of method update()
+  void reset() {
+    /*!
+      @brief     Resets all stages
+    */
+    _first.reset();
+    _rest.reset();
+  }  // of method reset()
+
+ private:
+  First                   _first;  // This stage
+  VCNL4010Stages<Rest...> _rest;   // Following stages
+};                                 // of class VCNL4010Stages
+
+template <typename... Stages>
+class VCNL4010Chain : public VCNL4010Filter {
+  /*!
+   * @class VCNL4010Chain
+   * @brief Filter stages run in order, can be attached to a VCNL4010
+   */
+ public:
+  uint16_t filter(const uint16_t value) override { return _stages.update(value); }  ///< Run
+  uint16_t update(const uint16_t value) { return _stages.update(value); }  ///< Same as filter()
+  void     reset() override { _stages.reset(); }  ///< Reset all stages
+
+ private:
+  VCNL4010Stages<Stages...> _stages;  // Filter stages
+};                                    // of class VCNL4010Chain
+#endif
@@ -0,0 +1,265 @@
+/*! @file VCNL4010Power.cpp
+ @section VCNL4010Power_cpp_intro_section Description
+
+Energy-aware duty cycling of the proximity measurement for the VCNL4010 library\n\n
+See VCNL4010Power.h for details
+*/
+#include "VCNL4010Power.h"  // Include the header definition
+
+const uint8_t  fastestRate{7};     ///< Rate code for 250 readings per second
+const uint16_t saturation{60000};  ///< Mean reading above which the LED current is halved
+
+static uint16_t squareRoot(uint32_t value) {
+  /*!
+    @brief     Integer square root
+    @param[in] value Value
+    @return    Square root rounded down
+  */
+  uint32_t root{0};
+  for (uint32_t bit = 1UL << 30; bit; bit >>= 2) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }  // if-then-else bit is set
+  }    // for-next each bit pair
+  return (uint16_t)root;
+}  // of function squareRoot()
+
+VCNL4010Power::VCNL4010Power(VCNL4010 &sensor) : _sensor(&sensor) {
+  /*!
+   * @brief   Class constructor
+   * @param[in] sensor Sensor to manage, begin() must have been called for it
+   */
+}
+void VCNL4010Power::begin(const uint8_t snrTarget, const uint8_t minHz, const bool usePin) {
+  /*!
+    @brief     Sets the signal to noise target and starts continuous proximity readings at 250/s
+               with 100mA LED current
+    @details   Interrupt sources set with setInterrupt() are turned off, the threshold interrupt is
+               used while sleeping
+    @param[in] snrTarget Lowest acceptable mean reading divided by its standard deviation
+    @param[in] minHz Lowest proximity rate while active, 2, 4, 8 to 128 or 250 readings/s
+    @param[in] usePin "true" if the INT pin interrupt routine calls VCNL4010::onInterrupt(), then
+               service() only accesses the device after an interrupt while sleeping. Otherwise it
+               reads the interrupt status register on every call while sleeping
+  */
+  _target  = snrTarget;
+  _minCode = VCNL4010Encode::proximityRate(minHz);
+  _usePin  = usePin;
+  _state   = VCNL4010_POWER_ACTIVE;
+  _arming  = false;
+  _level   = 0;
+  _noise   = 0;
+  _wakeups = 0;
+  _mA      = 100;
+  _sensor->setInterrupt(1);
+  _sensor->setLEDmA(_mA);
+  _sensor->setProximityContinuous(true);
+  setRate(fastestRate);
+  restart();
+}  // of method begin()
+VCNL4010PowerEvent VCNL4010Power::update(const uint16_t proximity) {
+  /*!
+    @brief     Processes one proximity reading
+    @details   A reading more than 4 standard deviations and 4 counts away from the level of the
+               last window is motion and sets the rate to 250/s. When the window is full its mean
+               and standard deviation become the new level and noise, the LED current needed for
+               the target is calculated and, if the window was quiet, the rate is halved or the
+               sensor put to sleep. The LED current is raised at once but only lowered by at least
+               20mA, so it does not toggle between two steps
+    @param[in] proximity Proximity reading
+    @return    Event caused by the reading
+  */
+  if (_state == VCNL4010_POWER_SLEEP) return VCNL4010_POWER_NONE;
+  if (_skip) {
+    _skip = false;  // May still have been measured with the old settings
+    return VCNL4010_POWER_NONE;
+  }  // if-then first reading after a change
+  if (_level && !_motion) {
+    const uint16_t deviation = proximity > _level ? proximity - _level : _level - proximity;
+    if (deviation > 4 * (uint32_t)_noise + 4) {
+      _motion = true;
+      if (_code != fastestRate) {
+        setRate(fastestRate);
+        restart();
+        _motion = true;  // The next window is not quiet either
+        return VCNL4010_POWER_MOTION;
+      }  // if-then ramp up
+    }    // if-then motion
+  }      // if-then level known
+  _sum += proximity;
+  _sumSquares += (uint32_t)proximity * proximity;
+  if (++_count < VCNL4010_POWER_WINDOW) return VCNL4010_POWER_NONE;
+  const uint32_t mean     = _sum / VCNL4010_POWER_WINDOW;
+  const uint64_t variance = (_sumSquares - (uint64_t)_sum * _sum / VCNL4010_POWER_WINDOW) /
+                            VCNL4010_POWER_WINDOW;
+  _level = mean ? mean : 1;
+  _noise = squareRoot(variance > UINT32_MAX ? UINT32_MAX : (uint32_t)variance);
+  uint8_t mA{_mA};
+  if (mean > saturation) {
+    mA = _mA > 20 ? _mA / 2 / 10 * 10 : 10;
+  } else {
+    const uint32_t noise  = _noise ? _noise : 1;
+    uint32_t       needed = ((uint32_t)_mA * _target * noise + mean - 1) / mean;  // Rounded up
+    needed                = (needed + 9) / 10 * 10;  // to the next 10mA step
+    if (needed < 10) needed = 10;
+    if (needed > 200) needed = 200;
+    if (needed > _mA || needed + 10 < _mA) mA = needed;
+  }  // if-then-else saturated
+  const bool quiet = !_motion;
+  uint8_t    code{_code};
+  if (quiet && code > _minCode) --code;
+  if (quiet && code == _code && mA == _mA) {
+    sleep();
+    return VCNL4010_POWER_SLEEPING;
+  }  // if-then nothing left to lower
+  if (code == _code && mA == _mA) {
+    restart();
+    _skip = false;  // Nothing changed, the next reading is valid
+    return VCNL4010_POWER_NONE;
+  }  // if-then no change
+  if (mA != _mA) {
+    _level = (uint32_t)_level * mA / _mA;  // The reading scales with the LED current
+    _mA    = mA;
+    _sensor->setLEDmA(_mA);
+  }  // if-then new LED current
+  if (code != _code) setRate(code);
+  restart();
+  return VCNL4010_POWER_TUNED;
+}  // of method update()
+VCNL4010PowerEvent VCNL4010Power::service() {
+  /*!
+    @brief     Processes a proximity reading while active or the threshold interrupt while asleep
+    @details   While active one VCNL4010::service() step is run. After going to sleep the steps
+               continue until the sleep rate is written and the threshold interrupt is armed.
+               Then the results are no longer read, only the interrupt is checked, see begin().
+               No call waits for the device
+    @return    Event caused by the reading or interrupt, VCNL4010_POWER_NONE if there was none
+  */
+  if (_state == VCNL4010_POWER_SLEEP) {
+    if (_arming) {
+      arm();
+      return VCNL4010_POWER_NONE;
+    }  // if-then interrupt not armed yet
+    if (_usePin) {
+      if (!_sensor->handleInterrupt()) return VCNL4010_POWER_NONE;  // Also clears the status
+    } else {
+      const uint8_t status = _sensor->getInterrupt() & 0b00000011;  // Threshold bits
+      if (!status) return VCNL4010_POWER_NONE;
+      _sensor->writeByte(REGISTER_INTERRUPT_STATUS, status);  // Write 1 to clear
+    }                                                         // if-then-else interrupt pin used
+    return wake();
+  }  // if-then sleeping
+  uint16_t proximity;
+  _sensor->service();
+  if (!_sensor->tryGetProximity(proximity)) return VCNL4010_POWER_NONE;
+  return update(proximity);
+}  // of method service()
+VCNL4010PowerEvent VCNL4010Power::wake() {
+  /*!
+    @brief     Leaves sleep, disarms the threshold interrupt and sets the rate to 250/s
+    @details   Called by service() on the threshold interrupt, can also be called by the program
+    @return    VCNL4010_POWER_WAKE, or VCNL4010_POWER_NONE if not sleeping
+  */
+  if (_state != VCNL4010_POWER_SLEEP) return VCNL4010_POWER_NONE;
+  _state  = VCNL4010_POWER_ACTIVE;
+  _arming = false;
+  ++_wakeups;
+  _sensor->setInterrupt(1);
+  setRate(fastestRate);
+  restart();
+  _motion = true;  // The scene changed, the first window is not quiet
+  return VCNL4010_POWER_WAKE;
+}  // of method wake()
+uint32_t VCNL4010Power::getEnergyPerSample() const {
+  /*!
+    @brief     Estimates the energy used for each proximity reading with the current settings
+    @details   The LED current for VCNL4010_LED_ON_MICROS and VCNL4010_ACTIVE_MICROAMPS for
+               VCNL4010_MEASURE_MICROS per measurement, plus VCNL4010_STANDBY_MICROAMPS over the
+               rest of the period, all at VCNL4010_SUPPLY_MILLIVOLTS
+    @return    Energy in nanojoules
+  */
+  const uint32_t period = VCNL4010Encode::proximityPeriod(_code);
+  const uint64_t femtojoules =
+      (uint64_t)VCNL4010_SUPPLY_MILLIVOLTS *
+      ((uint64_t)_mA * 1000 * VCNL4010_LED_ON_MICROS +
+       (uint64_t)VCNL4010_ACTIVE_MICROAMPS * VCNL4010_MEASURE_MICROS +
+       (uint64_t)VCNL4010_STANDBY_MICROAMPS * (period - VCNL4010_MEASURE_MICROS));
+  return (uint32_t)(femtojoules / 1000000);
+}  // of method getEnergyPerSample()
+uint32_t VCNL4010Power::getAverageMicroAmps() const {
+  /*!
+    @brief     Estimates the average supply current with the current settings
+    @details   Uses the same model as getEnergyPerSample()
+    @return    Current in microamperes, rounded up
+  */
+  const uint32_t charge = (uint32_t)_mA * 1000 * VCNL4010_LED_ON_MICROS +
+                          (uint32_t)VCNL4010_ACTIVE_MICROAMPS * VCNL4010_MEASURE_MICROS;
+  const uint32_t period = VCNL4010Encode::proximityPeriod(_code);
+  return (charge + period - 1) / period + VCNL4010_STANDBY_MICROAMPS;
+}  // of method getAverageMicroAmps()
+uint8_t VCNL4010Power::getRateHz() const {
+  /*!
+    @brief     Returns the proximity rate in use
+    @return    Readings per second, 2, 4, 8 to 128 or 250
+  */
+  return VCNL4010Encode::proximityHz(_code);
+}  // of method getRateHz()
+uint16_t VCNL4010Power::getSNR() const {
+  /*!
+    @brief     Returns the signal to noise ratio of the last window
+    @return    Mean reading divided by its standard deviation, 0 if there was no window yet and
+               UINT16_MAX if there was no noise
+  */
+  if (!_noise) return _level ? UINT16_MAX : 0;
+  return _level / _noise;
+}  // of method getSNR()
+void VCNL4010Power::setRate(const uint8_t code) {
+  /*!
+    @brief     Sets the proximity rate
+    @details   The rate is written by VCNL4010::setProximityHz() once the proximity sensor is idle
+    @param[in] code REGISTER_PROXIMITY_RATE code 0 to 7
+  */
+  _code = code;
+  _sensor->setProximityHz(VCNL4010Encode::proximityHz(code));
+}  // of method setRate()
+void VCNL4010Power::restart() {
+  /*!
+    @brief     Starts a new window, discarding the next reading
+  */
+  _sum        = 0;
+  _sumSquares = 0;
+  _count      = 0;
+  _skip       = true;
+  _motion     = false;
+}  // of method restart()
+void VCNL4010Power::sleep() {
+  /*!
+    @brief     Slows the proximity rate to 2/s and prepares the threshold interrupt
+    @details   The threshold window is 6 standard deviations and at least 8 counts around the level.
+               The rate change is queued and the interrupt armed by service() once it is written,
+               so this does not wait for the device
+  */
+  const uint32_t window = 6 * (uint32_t)_noise > 8 ? 6 * (uint32_t)_noise : 8;
+  _low                  = _level > window ? _level - window : 0;
+  _high                 = _level + window > UINT16_MAX ? UINT16_MAX : _level + window;
+  _state                = VCNL4010_POWER_SLEEP;
+  _arming               = true;
+  setRate(0);
+}  // of method sleep()
+bool VCNL4010Power::arm() {
+  /*!
+    @brief     Arms the threshold interrupt once the sleep rate has been written
+    @details   Runs one VCNL4010::service() step, which writes the queued rate when the sensor
+               allows it. Old threshold events are cleared before the interrupt is armed
+    @return    "true" if the interrupt was armed
+  */
+  _sensor->service();
+  if (_sensor->flush(0) != VCNL4010_I2C_OK) return false;  // Rate not written yet
+  _sensor->writeByte(REGISTER_INTERRUPT_STATUS, 0b00000011);
+  _sensor->setInterrupt(1, false, false, true, false, _low, _high);
+  _arming = false;
+  return true;
+}  // of method arm()
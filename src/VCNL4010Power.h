@@ -0,0 +1,99 @@
+/*! @file VCNL4010Power.h
+
+@section VCNL4010Power_intro_section Description
+
+Energy-aware duty cycling of the proximity measurement for the VCNL4010 library. The IR LED pulses
+take most of the power the sensor uses, and their energy grows with the LED current and the
+proximity rate. The VCNL4010Power class runs the proximity sensor in continuous mode and picks the
+lowest settings that still do the job:\n
+- LED current: every VCNL4010_POWER_WINDOW readings the signal to noise ratio, the mean of the
+  readings divided by their standard deviation, is measured. The reading scales with the LED
+  current while the noise does not, so the lowest current in 10mA steps that keeps the ratio above
+  the target is calculated and set
+- Proximity rate: a reading further than 4 standard deviations from the level of the last window
+  is motion, the rate goes up to 250 readings/s at once. Each window without motion halves the
+  rate down to the lowest active rate given to begin()
+- Sleep: after one more quiet window at the lowest active rate the rate drops to 2 readings/s and
+  the following service() calls arm the proximity threshold interrupt with a window around the
+  level. The host then no longer reads the results and is woken by the interrupt, after which it
+  ramps back up to 250/s\n
+\n
+getEnergyPerSample() and getAverageMicroAmps() estimate the power used with the current settings
+from the LED current, the measurement time and the standby current, so battery life can be budgeted.
+The model constants are typical values for a 3.3V supply, the estimate is meant for comparisons.
+
+See main library header file for details
+*/
+#ifndef VCNL4010Power_h
+/*! @brief Guard code definition for the VCNL4010Power header */
+#define VCNL4010Power_h
+#include "VCNL4010.h"  // Sensor class
+
+const uint8_t  VCNL4010_POWER_WINDOW{16};         ///< Readings per noise measurement
+const uint16_t VCNL4010_LED_ON_MICROS{80};        ///< Effective LED on time per measurement
+const uint16_t VCNL4010_MEASURE_MICROS{250};      ///< Time of a proximity measurement
+const uint16_t VCNL4010_ACTIVE_MICROAMPS{2000};   ///< Supply current while measuring
+const uint16_t VCNL4010_STANDBY_MICROAMPS{2};     ///< Supply current between measurements
+const uint16_t VCNL4010_SUPPLY_MILLIVOLTS{3300};  ///< Supply voltage for the energy estimate
+
+/*! @brief Power state of VCNL4010Power */
+enum VCNL4010PowerState : uint8_t {
+  VCNL4010_POWER_ACTIVE = 0,  ///< Reading at a rate chosen by the activity
+  VCNL4010_POWER_SLEEP  = 1   ///< Reading at 2/s, waiting for the threshold interrupt
+};
+/*! @brief Result of VCNL4010Power::update() and VCNL4010Power::service() */
+enum VCNL4010PowerEvent : uint8_t {
+  VCNL4010_POWER_NONE     = 0,  ///< No reading or nothing changed
+  VCNL4010_POWER_TUNED    = 1,  ///< LED current or rate changed after a window
+  VCNL4010_POWER_MOTION   = 2,  ///< Motion detected, rate set to 250/s
+  VCNL4010_POWER_SLEEPING = 3,  ///< Scene static, sleeping, service() arms the threshold interrupt
+  VCNL4010_POWER_WAKE     = 4   ///< Woken by the threshold interrupt, rate set to 250/s
+};
+
+class VCNL4010Power {
+  /*!
+   * @class VCNL4010Power
+   * @brief Chooses the LED current and proximity rate of a VCNL4010 for the lowest power use
+   */
+ public:
+  explicit VCNL4010Power(VCNL4010 &sensor);
+  void begin(const uint8_t snrTarget = 20, const uint8_t minHz = 16,
+             const bool usePin = false);                  // Set target and start at 250/s
+  VCNL4010PowerEvent update(const uint16_t proximity);    // Process a reading
+  VCNL4010PowerEvent service();                           // Process a reading or interrupt
+  VCNL4010PowerEvent wake();                              // Leave sleep, ramp up to 250/s
+  VCNL4010PowerState getState() const { return _state; }  ///< Active or sleeping
+  uint32_t getEnergyPerSample() const;                    // Energy estimate in nJ
+  uint32_t getAverageMicroAmps() const;                   // Supply current estimate
+  uint8_t  getLEDmA() const { return _mA; }               ///< LED current in use
+  uint8_t  getRateHz() const;                             // Proximity rate in use
+  uint16_t getLevel() const { return _level; }            ///< Mean of the last window
+  uint16_t getNoise() const { return _noise; }            ///< Standard deviation of last window
+  uint16_t getSNR() const;                                // Signal to noise ratio
+  uint32_t getWakeups() const { return _wakeups; }        ///< Number of wake-ups from sleep
+
+ private:
+  void setRate(const uint8_t code);                  // Set the proximity rate code
+  void restart();                                    // Start a new window after a change
+  void sleep();                                      // Slow down, prepare the interrupt
+  bool arm();                                        // Arm the threshold interrupt
+  VCNL4010          *_sensor;                        // Sensor being managed
+  uint64_t           _sumSquares{0};                 // Sum of the squared readings in the window
+  uint32_t           _sum{0};                        // Sum of the readings in the window
+  uint32_t           _wakeups{0};                    // Number of wake-ups from sleep
+  uint16_t           _level{0};                      // Mean of the last window, 0 if none yet
+  uint16_t           _noise{0};                      // Standard deviation of the last window
+  uint16_t           _low{0};                        // Low threshold armed while sleeping
+  uint16_t           _high{0};                       // High threshold armed while sleeping
+  VCNL4010PowerState _state{VCNL4010_POWER_ACTIVE};  // Active or sleeping
+  uint8_t            _target{20};                    // Signal to noise target
+  uint8_t            _minCode{3};                    // Lowest active rate code
+  uint8_t            _code{7};                       // Proximity rate code in use
+  uint8_t            _mA{20};                        // LED current in use
+  uint8_t            _count{0};                      // Readings in the window
+  bool               _skip{true};                    // Discard the next reading
+  bool               _motion{false};                 // Motion in the current window
+  bool               _arming{false};                 // Sleeping, interrupt not armed yet
+  bool               _usePin{false};                 // Interrupt pin wired to onInterrupt()
+};                                                   // of class VCNL4010Power
+#endif
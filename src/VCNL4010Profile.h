@@ -0,0 +1,184 @@
+/*! @file VCNL4010Profile.h
+
+@section VCNL4010Profile_intro_section Description
+
+Compile-time configuration of the VCNL4010. The VCNL4010Encode functions convert the settings into
+register bits and are used both by the runtime setters of the VCNL4010 class and, at compile time,
+by the VCNL4010Profile template. A profile checks its parameters with static_assert, so invalid
+values such as a 250mA LED current are a compiler error, and computes the complete configuration
+register image as a constant:\n
+    VCNL4010 sensor;\n
+    sensor.begin(VCNL4010Profile<250, 200>());  // 250 proximity readings/s with 200mA\n
+\n
+VCNL4010::begin(const VCNL4010Image&) writes the image with burst transactions, skipping the
+registers which already have the right values.
+
+See main library header file for details
+*/
+#ifndef VCNL4010Profile_h
+/*! @brief Guard code definition for the VCNL4010Profile header */
+#define VCNL4010Profile_h
+#if defined(ARDUINO)
+#include "Arduino.h"  // Arduino data type definitions
+#else
+#include <stdint.h>  // Fixed width integer types
+#endif
+
+/*******************************************************************
+** Interrupt sources in REGISTER_INTERRUPT, see VCNL4010Profile   **
+*******************************************************************/
+const uint8_t VCNL4010_INT_PROX_READY{0b1000};      ///< Interrupt on each proximity reading
+const uint8_t VCNL4010_INT_ALS_READY{0b0100};       ///< Interrupt on each ambient light reading
+const uint8_t VCNL4010_INT_PROX_THRESHOLD{0b0010};  ///< Interrupt on proximity thresholds
+const uint8_t VCNL4010_INT_ALS_THRESHOLD{0b0011};   ///< Interrupt on ambient light thresholds
+
+struct VCNL4010Encode {
+  /*!
+   * @struct VCNL4010Encode
+   * @brief  Conversion of settings to register bits. The encoders round down to the nearest value
+   *         supported by the device, the "is" functions check for exactly supported values
+   */
+  static constexpr uint8_t proximityRate(const uint8_t Hz) {
+    /*! @brief REGISTER_PROXIMITY_RATE code for 2, 4, 8, 16, 32, 64, 128 or 250 readings/s */
+    return Hz >= 250   ? 7
+           : Hz >= 128 ? 6
+           : Hz >= 64  ? 5
+           : Hz >= 32  ? 4
+           : Hz >= 16  ? 3
+           : Hz >= 8   ? 2
+           : Hz >= 4   ? 1
+                       : 0;
+  }
+  static constexpr uint32_t proximityPeriod(const uint8_t code) {
+    /*! @brief Self-timed proximity measurement period in microseconds for rate code 0-7 */
+    return code >= 7 ? 4000 : 512000UL >> code;
+  }
+  static constexpr uint8_t proximityHz(const uint8_t code) {
+    /*! @brief Proximity readings per second for rate code 0-7, 250 for the 3.9ms period */
+    return code >= 7 ? 250 : 2 << code;
+  }
+  static constexpr uint8_t ledCurrent(const uint8_t mA) {
+    /*! @brief REGISTER_LED_CURRENT value for 0 to 200mA in steps of 10mA */
+    return mA >= 200 ? 20 : mA / 10;
+  }
+  static constexpr uint8_t ambientRate(const uint8_t samples) {
+    /*! @brief REGISTER_AMBIENT_PARAM rate bits 4-6 for 1, 2, 3, 4, 5, 6, 8 or 10 samples/s */
+    return (samples >= 10 ? 7 : samples >= 8 ? 6 : samples >= 6 ? 5 : samples > 0 ? samples - 1 : 0)
+           << 4;
+  }
+  static constexpr uint8_t ambientHz(const uint8_t code) {
+    /*! @brief Ambient light samples per second for REGISTER_AMBIENT_PARAM rate bits 4-6 as 0-7 */
+    return code >= 7 ? 10 : code == 6 ? 8 : code + 1;
+  }
+  static constexpr uint8_t powerOf2(const uint8_t value) {
+    /*! @brief 3 bit code for 1, 2, 4 to 128, for ambient light averaging and interrupt count */
+    return value >= 128  ? 7
+           : value >= 64 ? 6
+           : value >= 32 ? 5
+           : value >= 16 ? 4
+           : value >= 8  ? 3
+           : value >= 4  ? 2
+           : value >= 2  ? 1
+                         : 0;
+  }
+  static constexpr uint8_t ambientAveraging(const uint8_t avg) {
+    /*! @brief REGISTER_AMBIENT_PARAM averaging bits 0-2 for 1, 2, 4 to 128 conversions */
+    return powerOf2(avg);
+  }
+  static constexpr uint8_t interruptCount(const uint8_t count) {
+    /*! @brief REGISTER_INTERRUPT count bits 5-7 for 1, 2, 4 to 128 readings */
+    return powerOf2(count) << 5;
+  }
+  static constexpr uint8_t proximityTiming(const uint8_t frequency) {
+    /*! @brief REGISTER_PROXIMITY_TIMING value for modulator frequency code 0-3, 1 dead time */
+    return (frequency & 0b11) << 3 | 1;
+  }
+  static constexpr bool isPowerOf2(const uint8_t value) {
+    /*! @brief "true" for 1, 2, 4, 8, 16, 32, 64 and 128 */
+    return value != 0 && (value & (value - 1)) == 0;
+  }
+  static constexpr bool isProximityRate(const uint8_t Hz) {
+    /*! @brief "true" for the supported proximity rates 2, 4, 8, 16, 32, 64, 128 and 250 */
+    return Hz == 250 || (Hz >= 2 && Hz <= 128 && isPowerOf2(Hz));
+  }
+  static constexpr bool isAmbientRate(const uint8_t samples) {
+    /*! @brief "true" for the supported ambient light rates 1, 2, 3, 4, 5, 6, 8 and 10 */
+    return (samples >= 1 && samples <= 6) || samples == 8 || samples == 10;
+  }
+};  // of struct VCNL4010Encode
+
+struct VCNL4010Image {
+  /*!
+   * @struct VCNL4010Image
+   * @brief  Values of the writable configuration registers, usually created by VCNL4010Profile
+   */
+  constexpr VCNL4010Image(const uint8_t cmd, const uint8_t rate, const uint8_t led,
+                          const uint8_t ambient, const uint8_t interrupt, const uint16_t low,
+                          const uint16_t high, const uint8_t timing)
+      : command(cmd),
+        parameters{rate, led, ambient},
+        thresholds{interrupt, (uint8_t)(low >> 8), (uint8_t)low, (uint8_t)(high >> 8),
+                   (uint8_t)high, 0b1111, timing} {
+    /*!
+     * @brief   Class constructor
+     * @param[in] cmd REGISTER_CMD enable bits
+     * @param[in] rate REGISTER_PROXIMITY_RATE
+     * @param[in] led REGISTER_LED_CURRENT
+     * @param[in] ambient REGISTER_AMBIENT_PARAM
+     * @param[in] interrupt REGISTER_INTERRUPT
+     * @param[in] low Low threshold
+     * @param[in] high High threshold
+     * @param[in] timing REGISTER_PROXIMITY_TIMING
+     */
+  }
+  uint8_t command;        ///< REGISTER_CMD enable bits, written last
+  uint8_t parameters[3];  ///< REGISTER_PROXIMITY_RATE through REGISTER_AMBIENT_PARAM
+  uint8_t thresholds[7];  ///< REGISTER_INTERRUPT through REGISTER_PROXIMITY_TIMING, the
+                          ///< REGISTER_INTERRUPT_STATUS value 0b1111 clears stale interrupts
+};                        // of struct VCNL4010Image
+
+template <uint8_t ProxHz = 2, uint8_t LEDmA = 20, uint8_t AlsRate = 2, uint8_t AlsAvg = 32,
+          uint8_t ProxFreq = 0, bool ProxContinuous = false, bool AlsContinuous = false,
+          uint8_t Interrupts = 0, uint8_t IntCount = 1, uint16_t LowThreshold = 0,
+          uint16_t HighThreshold = UINT16_MAX>
+struct VCNL4010Profile : public VCNL4010Image {
+  /*!
+   * @struct VCNL4010Profile
+   * @brief  Compile-time checked configuration. The defaults are the settings made by begin()
+   * @tparam ProxHz Proximity readings per second, 2, 4, 8, 16, 32, 64, 128 or 250
+   * @tparam LEDmA IR LED current, 0 to 200mA in steps of 10mA
+   * @tparam AlsRate Ambient light readings per second in continuous mode, 1-6, 8 or 10
+   * @tparam AlsAvg Conversions averaged per ambient light reading, 1, 2, 4 to 128
+   * @tparam ProxFreq Proximity modulator frequency code 0-3, see VCNL4010::setProximityFreq()
+   * @tparam ProxContinuous Continuous proximity measurements
+   * @tparam AlsContinuous Continuous ambient light measurements
+   * @tparam Interrupts VCNL4010_INT_PROX_READY, VCNL4010_INT_ALS_READY and one of the
+   *         VCNL4010_INT_PROX_THRESHOLD or VCNL4010_INT_ALS_THRESHOLD values or'ed together
+   * @tparam IntCount Consecutive readings outside the thresholds for an interrupt, 1, 2, 4 to 128
+   * @tparam LowThreshold Low threshold value
+   * @tparam HighThreshold High threshold value
+   */
+  static_assert(VCNL4010Encode::isProximityRate(ProxHz),
+                "ProxHz must be 2, 4, 8, 16, 32, 64, 128 or 250");
+  static_assert(LEDmA <= 200 && LEDmA % 10 == 0, "LEDmA must be 0 to 200 in steps of 10");
+  static_assert(VCNL4010Encode::isAmbientRate(AlsRate), "AlsRate must be 1-6, 8 or 10");
+  static_assert(VCNL4010Encode::isPowerOf2(AlsAvg), "AlsAvg must be 1, 2, 4, 8, 16, 32, 64 or 128");
+  static_assert(ProxFreq <= 3, "ProxFreq must be 0 to 3");
+  static_assert(Interrupts <= 0b1111, "Interrupts must be VCNL4010_INT_... values");
+  static_assert(VCNL4010Encode::isPowerOf2(IntCount),
+                "IntCount must be 1, 2, 4, 8, 16, 32, 64 or 128");
+  static_assert(LowThreshold <= HighThreshold, "LowThreshold must not exceed HighThreshold");
+  constexpr VCNL4010Profile()
+      : VCNL4010Image((ProxContinuous || AlsContinuous ? 0b001 : 0) | (ProxContinuous ? 0b010 : 0) |
+                          (AlsContinuous ? 0b100 : 0),
+                      VCNL4010Encode::proximityRate(ProxHz), VCNL4010Encode::ledCurrent(LEDmA),
+                      VCNL4010Encode::ambientRate(AlsRate) | 0b1000 |  // Auto offset on
+                          VCNL4010Encode::ambientAveraging(AlsAvg),
+                      VCNL4010Encode::interruptCount(IntCount) | Interrupts, LowThreshold,
+                      HighThreshold, VCNL4010Encode::proximityTiming(ProxFreq)) {
+    /*!
+     * @brief   Class constructor, the register image is computed at compile time
+     */
+  }
+};  // of struct VCNL4010Profile
+#endif
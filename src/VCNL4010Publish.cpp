@@ -0,0 +1,93 @@
+/*! @file VCNL4010Publish.cpp
+ @section VCNL4010Publish_cpp_intro_section Description
+
+Publication of the latest VCNL4010 readings to concurrent readers\n\n
+See VCNL4010Publish.h for details
+*/
+#include "VCNL4010Publish.h"  // Include the header definition
+
+#if defined(__AVR__)
+/*! @brief Load on single core AVR processors, where publish() blocks interrupts */
+#define VCNL4010_LOAD(value, order) (*(volatile __typeof__(value) *)&(value))
+/*! @brief Store on single core AVR processors, where publish() blocks interrupts */
+#define VCNL4010_STORE(value, data, order) (*(volatile __typeof__(value) *)&(value) = (data))
+#else
+/*! @brief Atomic load with the given memory order */
+#define VCNL4010_LOAD(value, order) __atomic_load_n(&(value), order)
+/*! @brief Atomic store with the given memory order */
+#define VCNL4010_STORE(value, data, order) __atomic_store_n(&(value), data, order)
+#endif
+
+VCNL4010Publisher::VCNL4010Publisher(VCNL4010 &sensor) : _sensor(&sensor) {
+  /*!
+   * @brief   Class constructor
+   * @param[in] sensor Sensor to own, only the owner may call its methods after begin()
+   */
+}
+bool VCNL4010Publisher::service() {
+  /*!
+    @brief     Runs one VCNL4010::service() step and publishes new readings, owner only
+    @details   Call regularly from the owner's loop with the sensor in continuous or triggered
+               mode, or in streaming mode where each new proximity reading is also in the ring
+    @return    "true" if a new reading was published
+  */
+  _sensor->service();
+  const bool proximity = _sensor->tryGetProximity(_proximity);
+  const bool ambient   = _sensor->tryGetAmbientLight(_ambient);
+  if (!proximity && !ambient) return false;
+  publish(_proximity, _ambient, _sensor->getMicros());
+  return true;
+}  // of method service()
+bool VCNL4010Publisher::read(VCNL4010Reading &reading) const {
+  /*!
+    @brief     Copies the latest published reading, may be called from any task or thread
+    @details   Lock-free, the copy is repeated while a publication is in progress
+    @param[out] reading Latest reading
+    @return    "false" if nothing was published yet or no consistent copy could be made
+  */
+  for (uint8_t attempt = 0; attempt < VCNL4010_PUBLISH_RETRIES; ++attempt) {
+    // Acquire loads keep the reading between the two loads of the version
+    const uint32_t version = VCNL4010_LOAD(_version, __ATOMIC_ACQUIRE);
+    reading.micros         = VCNL4010_LOAD(_publishedMicros, __ATOMIC_ACQUIRE);
+    reading.proximity      = VCNL4010_LOAD(_publishedProximity, __ATOMIC_ACQUIRE);
+    reading.ambient        = VCNL4010_LOAD(_publishedAmbient, __ATOMIC_ACQUIRE);
+    if (!(version & 1) && version == VCNL4010_LOAD(_version, __ATOMIC_RELAXED)) {
+      reading.sequence = version >> 1;
+      return version != 0;
+    }  // if-then consistent copy
+  }    // for-next each attempt
+  return false;
+}  // of method read()
+uint32_t VCNL4010Publisher::getSequence() const {
+  /*!
+    @brief     Returns the number of publications so far, may be called from any task or thread
+    @return    Sequence number of the latest reading, 0 if nothing was published yet
+  */
+  return VCNL4010_LOAD(_version, __ATOMIC_ACQUIRE) >> 1;
+}  // of method getSequence()
+void VCNL4010Publisher::publish(const uint16_t proximity, const uint16_t ambient,
+                                const uint32_t micros) {
+  /*!
+    @brief     Publishes readings, owner only
+    @details   Called by service(), or by an owner which reads the sensor itself, e.g. from the
+               ring in streaming mode. On AVR processors the 32 bit stores are not atomic, so
+               interrupts are blocked while publishing and interrupt routines never see a
+               publication in progress
+    @param[in] proximity Latest proximity reading
+    @param[in] ambient Latest ambient light reading
+    @param[in] micros Time of the reading
+  */
+#if defined(__AVR__)
+  noInterrupts();
+#endif
+  const uint32_t version = VCNL4010_LOAD(_version, __ATOMIC_RELAXED);
+  VCNL4010_STORE(_version, version + 1, __ATOMIC_RELAXED);  // Odd, readers retry
+  // Release stores keep the reading between the odd and the even version
+  VCNL4010_STORE(_publishedMicros, micros, __ATOMIC_RELEASE);
+  VCNL4010_STORE(_publishedProximity, proximity, __ATOMIC_RELEASE);
+  VCNL4010_STORE(_publishedAmbient, ambient, __ATOMIC_RELEASE);
+  VCNL4010_STORE(_version, version + 2, __ATOMIC_RELEASE);
+#if defined(__AVR__)
+  interrupts();
+#endif
+}  // of method publish()
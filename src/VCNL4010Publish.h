@@ -0,0 +1,69 @@
+/*! @file VCNL4010Publish.h
+
+@section VCNL4010Publish_intro_section Description
+
+Publication of the latest VCNL4010 readings to concurrent readers. When several tasks or threads
+need the readings, each of them calling the driver causes its own bus traffic and races on the bus
+and on the driver's state. With VCNL4010Publisher one task owns the sensor: it alone calls the
+driver, through service(), and every new reading is published together with the latest reading of
+the other sensor, its time and its sequence number. Any number of readers in other tasks or threads
+get the latest reading with read() without touching the bus or the driver.\n
+\n
+The reading is published through a seqlock: the writer makes the version odd, stores the reading
+and makes the version even again. A reader copies the reading between two reads of the version and
+repeats the copy if the version was odd or changed, so readers never block the writer and never
+see a half written reading. The version and the reading are only accessed with the compiler's
+__atomic builtins, the writer's with release and the reader's with acquire order, so the seqlock is
+free of data races in the C++ memory model; on single core AVR processors volatile accesses are used
+instead. A reader which cannot get a consistent copy within VCNL4010_PUBLISH_RETRIES attempts
+returns "false", which can only happen when an interrupt routine on the writer's core interrupted a
+publication.\n
+\n
+When the bus is also used for other devices, the owner installs lock hooks with
+VCNL4010Bus::setLock() so that the driver's transactions do not interleave with theirs. The hooks
+only serialize single bus transactions, the driver itself keeps state between them and must only
+be called by the owner.
+
+See main library header file for details
+*/
+#ifndef VCNL4010Publish_h
+/*! @brief Guard code definition for the VCNL4010Publish header */
+#define VCNL4010Publish_h
+#include "VCNL4010.h"  // Sensor class
+
+const uint8_t VCNL4010_PUBLISH_RETRIES{32};  ///< Attempts of read() to get a consistent copy
+
+struct VCNL4010Reading {
+  /*!
+   * @struct VCNL4010Reading
+   * @brief  Latest readings as published by VCNL4010Publisher
+   */
+  uint32_t micros;     ///< VCNL4010::getMicros() value when the reading was published
+  uint32_t sequence;   ///< Number of publications, 1 for the first
+  uint16_t proximity;  ///< Latest proximity reading
+  uint16_t ambient;    ///< Latest ambient light reading
+};                     // of struct VCNL4010Reading
+
+class VCNL4010Publisher {
+  /*!
+   * @class VCNL4010Publisher
+   * @brief Owns a VCNL4010 and publishes its latest readings to any number of readers
+   */
+ public:
+  explicit VCNL4010Publisher(VCNL4010 &sensor);
+  bool     service();  // Read the sensor and publish, owner only
+  void     publish(const uint16_t proximity, const uint16_t ambient,
+                   const uint32_t micros);        // Publish readings, owner only
+  bool     read(VCNL4010Reading &reading) const;  // Latest reading, any task or thread
+  uint32_t getSequence() const;                   // Number of publications
+
+ private:
+  VCNL4010 *_sensor;                 // Sensor owned
+  uint16_t  _proximity{0};           // Latest proximity reading, owner only
+  uint16_t  _ambient{0};             // Latest ambient reading, owner only
+  uint32_t  _version{0};             // Twice the sequence, odd while writing
+  uint32_t  _publishedMicros{0};     // Published time
+  uint16_t  _publishedProximity{0};  // Published proximity reading
+  uint16_t  _publishedAmbient{0};    // Published ambient light reading
+};                                   // of class VCNL4010Publisher
+#endif
@@ -0,0 +1,247 @@
+/*! @file VCNL4010Queue.cpp
+ @section VCNL4010Queue_cpp_intro_section Description
+
+Transaction queue for the VCNL4010 library\n\n
+See VCNL4010Queue.h for details
+*/
+#include "VCNL4010Queue.h"  // Include the header definition
+#include <string.h>         // memcpy(), memmove()
+
+VCNL4010Queue::VCNL4010Queue(VCNL4010Bus &bus) : _bus(&bus) {
+  /*!
+   * @brief   Class constructor
+   * @param[in] bus Bus transport that the transactions are carried out on
+   */
+}
+bool VCNL4010Queue::begin(const uint32_t speed) {
+  /*!
+    @brief     Completes queued transactions and starts the bus passed on to
+    @param[in] speed Speed of the I2C bus in Herz
+    @return    Result of the bus passed on to
+  */
+  drain();
+  return _bus->begin(speed);
+}  // of method begin()
+uint8_t VCNL4010Queue::read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                            const uint8_t length) {
+  /*!
+    @brief     Completes all queued transactions and then reads
+    @details   If a posted write failed since the last read, its status is returned instead of
+               VCNL4010_I2C_OK, so that the driver counts the failure and retries
+    @param[in] device I2C device address
+    @param[in] reg First register to read
+    @param[out] data Buffer for the register values
+    @param[in] length Number of bytes to read
+    @return    Status of the bus passed on to, or of a failed posted write
+  */
+  drain();
+  const uint8_t status = _bus->read(device, reg, data, length);
+  const uint8_t posted = _postedError;
+  _postedError         = VCNL4010_I2C_OK;
+  return status == VCNL4010_I2C_OK ? posted : status;
+}  // of method read()
+uint8_t VCNL4010Queue::write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                             const uint8_t length) {
+  /*!
+    @brief     Posts a write, which is merged with the last queued write if they are adjacent
+    @details   Writes longer than VCNL4010_TRANSACTION_BYTES are carried out at once after the
+               queued transactions
+    @param[in] device I2C device address
+    @param[in] reg First register to write
+    @param[in] data Bytes to write
+    @param[in] length Number of bytes to write
+    @return    VCNL4010_I2C_OK, or the status of the bus passed on to for long writes
+  */
+  if (length > VCNL4010_TRANSACTION_BYTES) {
+    drain();
+    return _bus->write(device, reg, data, length);
+  }  // if-then too long to queue
+  enqueue(device, reg, data, length, true, nullptr, nullptr);
+  return VCNL4010_I2C_OK;
+}  // of method write()
+void VCNL4010Queue::delayMicroseconds(const uint32_t us) {
+  /*!
+    @brief     Waits, working on the queue during the wait
+    @param[in] us Microseconds to wait
+  */
+  const uint32_t start = _bus->micros();
+  uint32_t       elapsed{0};
+  while (getPending() && elapsed < us) {
+    poll();
+    elapsed = _bus->micros() - start;
+  }  // of while-loop queued transactions and time left
+  if (elapsed < us) _bus->delayMicroseconds(us - elapsed);
+}  // of method delayMicroseconds()
+bool VCNL4010Queue::recover() {
+  /*!
+    @brief     Recovers the bus passed on to
+    @details   Queued transactions are kept and carried out afterwards
+    @return    Result of the bus passed on to
+  */
+  return _bus->recover();
+}  // of method recover()
+void VCNL4010Queue::setSettleDelay(const uint16_t us) {
+  /*!
+    @brief     Sets the settle delay of the queue and of the bus passed on to
+    @param[in] us Delay in microseconds
+  */
+  _settleMicros = us;
+  _bus->setSettleDelay(us);
+}  // of method setSettleDelay()
+bool VCNL4010Queue::submitRead(const uint8_t device, const uint8_t reg, const uint8_t length,
+                               VCNL4010Callback callback, void *context) {
+  /*!
+    @brief     Queues a read, the bytes read are passed to the callback in the transaction
+    @param[in] device I2C device address
+    @param[in] reg First register to read
+    @param[in] length Number of bytes to read, at most VCNL4010_TRANSACTION_BYTES
+    @param[in] callback Called from poll() when the read is complete
+    @param[in] context Passed to the callback
+    @return    "false" if the length is too long
+  */
+  if (length > VCNL4010_TRANSACTION_BYTES) return false;
+  return enqueue(device, reg, nullptr, length, false, callback, context);
+}  // of method submitRead()
+bool VCNL4010Queue::submitWrite(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                                const uint8_t length, VCNL4010Callback callback,
+                                void *context) {
+  /*!
+    @brief     Queues a write, the data is copied so the buffer may be reused at once
+    @details   Writes without a callback are merged with the last queued write if adjacent
+    @param[in] device I2C device address
+    @param[in] reg First register to write
+    @param[in] data Bytes to write
+    @param[in] length Number of bytes to write, at most VCNL4010_TRANSACTION_BYTES
+    @param[in] callback Called from poll() when the write is complete, or nullptr
+    @param[in] context Passed to the callback
+    @return    "false" if the length is too long
+  */
+  if (length > VCNL4010_TRANSACTION_BYTES) return false;
+  return enqueue(device, reg, data, length, true, callback, context);
+}  // of method submitWrite()
+bool VCNL4010Queue::poll() {
+  /*!
+    @brief     Works on the queue, call regularly from the main program loop
+    @details   If a background transaction has completed its callback is called. Otherwise the
+               oldest transaction is started in the background if the transport supports it, or
+               carried out at once
+    @return    "true" if a transaction was completed or started
+  */
+  if (_running) {
+    if (!_done) return false;  // Still running in the background
+    _running = false;
+    _done    = false;
+    finish(_doneStatus);
+    return true;
+  }  // if-then background transaction
+  if (_head == _tail) return false;
+  VCNL4010Transaction &transaction = _queue[_tail % VCNL4010_QUEUE_SIZE];
+  if (start(transaction)) {
+    _running = true;  // complete() will be called
+    return true;
+  }  // if-then started in the background
+  finish(transaction.write ? _bus->write(transaction.device, transaction.reg, transaction.data,
+                                         transaction.length)
+                           : _bus->read(transaction.device, transaction.reg, transaction.data,
+                                        transaction.length));
+  return true;
+}  // of method poll()
+uint8_t VCNL4010Queue::drain() {
+  /*!
+    @brief     Completes all queued transactions
+    @details   Waits for background transactions to complete
+    @return    Number of transactions completed
+  */
+  const uint8_t tail = _tail;
+  while (_head != _tail) poll();
+  return (uint8_t)(_tail - tail);
+}  // of method drain()
+void VCNL4010Queue::complete(const uint8_t status) {
+  /*!
+    @brief     Reports the end of the transaction started with start(), may be called from an
+               interrupt routine. The callback is called by the next poll()
+    @param[in] status Bus status of the transaction, the data of reads must already be stored
+  */
+  _doneStatus = status;
+  _done       = true;
+}  // of method complete()
+bool VCNL4010Queue::enqueue(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                            const uint8_t length, const bool write, VCNL4010Callback callback,
+                            void *context) {
+  /*!
+    @brief     Adds a transaction to the queue or merges a write into the last queued write
+    @details   If the queue is full the oldest transaction is completed first. A newly queued
+               transaction is started at once if the transport can run it in the background
+    @param[in] device I2C device address
+    @param[in] reg First register
+    @param[in] data Bytes to write, ignored for reads
+    @param[in] length Number of bytes
+    @param[in] write "true" for a write
+    @param[in] callback Completion callback or nullptr
+    @param[in] context Passed to the callback
+    @return    Always "true"
+  */
+  ++_submitted;
+  if (write && !callback && merge(device, reg, data, length)) {
+    ++_coalesced;
+    return true;
+  }                                                    // if-then merged
+  while (getPending() == VCNL4010_QUEUE_SIZE) poll();  // Make room
+  VCNL4010Transaction &transaction = _queue[_head % VCNL4010_QUEUE_SIZE];
+  transaction.device               = device;
+  transaction.reg                  = reg;
+  transaction.length               = length;
+  transaction.write                = write;
+  transaction.callback             = callback;
+  transaction.context              = context;
+  transaction.status               = VCNL4010_I2C_OK;
+  if (write) memcpy(transaction.data, data, length);
+  ++_head;
+  if (!_running && getPending() == 1 && start(transaction)) _running = true;
+  return true;
+}  // of method enqueue()
+bool VCNL4010Queue::merge(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                          const uint8_t length) {
+  /*!
+    @brief     Merges a write into the last queued write if it directly precedes or follows it
+    @details   The last queued transaction must be a write without callback to the same device
+               which has not been started, and the merged burst must fit into a transaction
+    @param[in] device I2C device address
+    @param[in] reg First register
+    @param[in] data Bytes to write
+    @param[in] length Number of bytes
+    @return    "true" if merged
+  */
+  if (_head == _tail || (_running && getPending() == 1)) return false;
+  VCNL4010Transaction &last = _queue[(uint8_t)(_head - 1) % VCNL4010_QUEUE_SIZE];
+  if (!last.write || last.callback || last.device != device ||
+      last.length + length > VCNL4010_TRANSACTION_BYTES) {
+    return false;
+  }  // if-then cannot be merged
+  if (reg == (uint8_t)(last.reg + last.length)) {
+    memcpy(last.data + last.length, data, length);  // Append
+  } else if ((uint8_t)(reg + length) == last.reg) {
+    memmove(last.data + length, last.data, last.length);  // Prepend
+    memcpy(last.data, data, length);
+    last.reg = reg;
+  } else {
+    return false;
+  }  // if-then-else adjacent
+  last.length += length;
+  return true;
+}  // of method merge()
+void VCNL4010Queue::finish(const uint8_t status) {
+  /*!
+    @brief     Completes the oldest transaction, counts errors and calls its callback
+    @param[in] status Bus status of the transaction
+  */
+  VCNL4010Transaction transaction = _queue[_tail % VCNL4010_QUEUE_SIZE];  // Copy, entry is reused
+  transaction.status              = status;
+  if (status != VCNL4010_I2C_OK) {
+    ++_errors;
+    _lastError = status;
+    if (!transaction.callback) _postedError = status;  // Reported by the next read()
+  }                                                    // if-then failed
+  ++_tail;  // Free the entry before the callback, which may queue a new transaction into it
+  if (transaction.callback) transaction.callback(transaction, transaction.context);
+}  // of method finish()
@@ -0,0 +1,115 @@
+/*! @file VCNL4010Queue.h
+
+@section VCNL4010Queue_intro_section Description
+
+Transaction queue for the VCNL4010 library. The VCNL4010Queue class is a VCNL4010Bus which is put
+between the driver and another bus:\n
+    VCNL4010WireBus wire;\n
+    VCNL4010Queue   queue(wire);\n
+    VCNL4010        sensor(queue);\n
+\n
+Writes made by the driver are posted: they are queued and the call returns at once. A write to the
+registers directly before or after the last queued write to the same device is merged into it, so
+the threshold and interrupt control writes of VCNL4010::setInterrupt() go out as one burst. Reads
+first complete all queued transactions, so the driver always sees its own writes. While the driver
+waits with delayMicroseconds(), queued transactions are carried out in the waiting time instead of
+idling.\n
+\n
+Programs can also queue reads, writes and bursts of their own with submitRead() and submitWrite(),
+each with a callback that is called with the result once the transaction is complete. The queue is
+worked off by poll() or drain() from the main program loop, or by the driver's own reads and waits.
+Transports which can run I2C transfers in the background, driven by interrupts or DMA, derive from
+VCNL4010Queue and override start(); they report the end of each transfer with complete(), which may
+be called from an interrupt routine. Callbacks are always called from poll(), never from an
+interrupt routine.\n
+\n
+Posted writes always return VCNL4010_I2C_OK to the driver. If a posted write fails, the next read()
+returns its status, so that the driver counts the failure and retries the read. Failed transactions
+are counted by getErrors() and the status of the last one is returned by getLastError().
+
+See main library header file for details
+*/
+#ifndef VCNL4010Queue_h
+/*! @brief Guard code definition for the VCNL4010Queue header */
+#define VCNL4010Queue_h
+#include "VCNL4010.h"  // Sensor class and bus transports
+
+const uint8_t VCNL4010_QUEUE_SIZE{4};          ///< Transactions in the queue
+const uint8_t VCNL4010_TRANSACTION_BYTES{16};  ///< Bytes in a transaction, registers 0x80-0x8F
+
+struct VCNL4010Transaction;
+/*! @brief Completion callback of a queued transaction */
+typedef void (*VCNL4010Callback)(const VCNL4010Transaction &transaction, void *context);
+
+struct VCNL4010Transaction {
+  /*!
+   * @struct VCNL4010Transaction
+   * @brief  A queued register read or write
+   */
+  uint8_t          data[VCNL4010_TRANSACTION_BYTES];  ///< Bytes to write or bytes read
+  VCNL4010Callback callback;                          ///< Called when complete, or nullptr
+  void            *context;                           ///< Passed to the callback
+  uint8_t          device;                            ///< I2C device address
+  uint8_t          reg;                               ///< First register
+  uint8_t          length;                            ///< Number of bytes
+  uint8_t          status;                            ///< Bus status once complete
+  bool             write;                             ///< "true" for a write, "false" for a read
+};                                                    // of struct VCNL4010Transaction
+
+class VCNL4010Queue : public VCNL4010Bus {
+  /*!
+   * @class VCNL4010Queue
+   * @brief Bus transport which queues and merges transactions and completes them later
+   */
+ public:
+  explicit VCNL4010Queue(VCNL4010Bus &bus);
+  bool     begin(const uint32_t speed) override;
+  uint8_t  read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                const uint8_t length) override;
+  uint8_t  write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                 const uint8_t length) override;
+  uint32_t micros() override { return _bus->micros(); }  ///< Pass on
+  void     delayMicroseconds(const uint32_t us) override;
+  bool     recover() override;
+  void     setSettleDelay(const uint16_t us) override;  // Set delay here and passed on
+  bool     submitRead(const uint8_t device, const uint8_t reg, const uint8_t length,
+                      VCNL4010Callback callback, void *context = nullptr);  // Queue a read
+  bool     submitWrite(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                       const uint8_t length, VCNL4010Callback callback = nullptr,
+                       void *context = nullptr);  // Queue a write
+  bool     poll();                                // Work on the queue
+  uint8_t  drain();                               // Complete all queued transactions
+  uint8_t  getPending() const { return (uint8_t)(_head - _tail); }  ///< Queued transactions
+  uint32_t getSubmitted() const { return _submitted; }              ///< Transactions queued
+  uint32_t getCoalesced() const { return _coalesced; }  ///< Writes merged into queued ones
+  uint32_t getErrors() const { return _errors; }        ///< Failed transactions
+  uint8_t  getLastError() const { return _lastError; }  ///< Status of the last failure
+
+ protected:
+  virtual bool start(VCNL4010Transaction &transaction) {
+    (void)transaction;
+    return false;
+  }                                     ///< Start in the background, "false" if not supported
+  void complete(const uint8_t status);  // End of a background transaction
+
+ private:
+  bool enqueue(const uint8_t device, const uint8_t reg, const uint8_t *data,
+               const uint8_t length, const bool write, VCNL4010Callback callback,
+               void *context);  // Add or merge a transaction
+  bool merge(const uint8_t device, const uint8_t reg, const uint8_t *data,
+             const uint8_t length);                 // Merge a write into the last one
+  void finish(const uint8_t status);                // Complete the oldest transaction
+  VCNL4010Bus        *_bus;                         // Bus passed on to
+  VCNL4010Transaction _queue[VCNL4010_QUEUE_SIZE];  // Queued transactions
+  uint32_t            _submitted{0};                // Transactions queued
+  uint32_t            _coalesced{0};                // Writes merged into queued ones
+  uint32_t            _errors{0};                   // Failed transactions
+  uint8_t             _head{0};                     // Index of the next free entry
+  uint8_t             _tail{0};                     // Index of the oldest entry
+  uint8_t             _lastError{0};                // Status of the last failure
+  uint8_t             _postedError{0};              // Failure of a posted write not yet reported
+  volatile uint8_t    _doneStatus{0};               // Status passed to complete()
+  volatile bool       _running{false};              // Oldest transaction runs in the background
+  volatile bool       _done{false};                 // Background transaction complete
+};                                                  // of class VCNL4010Queue
+#endif
@@ -0,0 +1,481 @@
+/*! @file VCNL4010Record.cpp
+ @section VCNL4010Record_cpp_intro_section Description
+
+Recording and replay of raw VCNL4010 sensor streams\n\n
+See VCNL4010Record.h for details
+*/
+#include "VCNL4010Record.h"  // Include the header definition
+#include <string.h>          // memset()
+
+/*! @brief Bits for the recorded registers 0x80, 0x82-0x84, 0x89-0x8D and 0x8F, bit n is 0x80+n */
+const uint16_t recordedRegisters{0xBE1D};
+/*! @brief Enable bits of REGISTER_CMD, the on-demand and data ready bits are not recorded */
+const uint8_t commandEnableBits{_BV(BIT_ALS_EN) | _BV(BIT_PROX_EN) | _BV(BIT_SELFTIMED_EN)};
+/*! @brief Data ready bits of REGISTER_CMD */
+const uint8_t dataReadyBits{_BV(BIT_ALS_DATA_RDY) | _BV(BIT_PROX_DATA_RDY)};
+/*! @brief Longest record: key with 32 bit time difference and two 17 bit reading differences */
+const uint8_t maxRecordBytes{11};
+/*! @brief Header magic */
+const char recordMagic[4]{'V', 'C', 'N', 'L'};
+
+VCNL4010Recorder::VCNL4010Recorder(VCNL4010Bus &bus) : _bus(&bus) {
+  /*!
+   * @brief   Class constructor
+   * @param[in] bus Bus transport that all transactions are passed on to
+   */
+}
+void VCNL4010Recorder::setSettleDelay(const uint16_t us) {
+  /*!
+    @brief     Sets the settle delay of the recorder and of the bus passed on to
+    @param[in] us Delay in microseconds
+  */
+  _settleMicros = us;
+  _bus->setSettleDelay(us);
+}  // of method setSettleDelay()
+uint8_t VCNL4010Recorder::read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                               const uint8_t length) {
+  /*!
+    @brief     Passes a read on and records the new readings in it
+    @details   The driver reads REGISTER_CMD, whose data ready bits show which readings are new,
+               and then the new results, either in the same burst or in separate reads. A read of
+               REGISTER_CMD records the readings found after the previous one and starts looking
+               for the results it announces. Reads of both bytes of an announced result store the
+               reading and the time, a later read of the same result replaces them, so that a
+               reading which the driver reads again is recorded with its last value
+    @param[in] device I2C device address
+    @param[in] reg First register to read
+    @param[out] data Buffer for the register values
+    @param[in] length Number of bytes to read
+    @return    Status of the bus passed on to
+  */
+  const uint8_t status = _bus->read(device, reg, data, length);
+  if (!_recording || status != VCNL4010_I2C_OK || device != _address) return status;
+  if (reg == REGISTER_CMD) {
+    record();  // Readings found after the previous status read
+    _ready = data[0] & dataReadyBits;
+  }  // if-then status read
+  for (uint8_t i = 0; i < 2; ++i) {
+    const uint8_t result = i ? REGISTER_PROXIMITY : REGISTER_AMBIENT_LIGHT;
+    const uint8_t bit    = i ? _BV(BIT_PROX_DATA_RDY) : _BV(BIT_ALS_DATA_RDY);
+    if (!(_ready & bit) || reg > result || reg + length < result + 2) continue;
+    const uint16_t value = (uint16_t)data[result - reg] << 8 | data[result + 1 - reg];
+    if (i) {
+      _newProximity = value;
+    } else {
+      _newAmbient = value;
+    }  // if-then-else proximity
+    _seen |= bit;
+    _seenMicros = _bus->micros();
+  }  // for-next each result
+  return status;
+}  // of method read()
+uint8_t VCNL4010Recorder::write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                                const uint8_t length) {
+  /*!
+    @brief     Passes a write on and records the configuration registers it changed
+    @param[in] device I2C device address
+    @param[in] reg First register to write
+    @param[in] data Bytes to write
+    @param[in] length Number of bytes to write
+    @return    Status of the bus passed on to
+  */
+  const uint8_t status = _bus->write(device, reg, data, length);
+  if (_recording && status == VCNL4010_I2C_OK && device == _address) {
+    record();  // Keep the records in time order
+    registers(reg, data, length);
+  }  // if-then write to the recorded device
+  return status;
+}  // of method write()
+#if defined(ARDUINO)
+bool VCNL4010Recorder::start(Print &sink, const uint8_t address) {
+#else
+bool VCNL4010Recorder::start(FILE *sink, const uint8_t address) {
+#endif
+  /*!
+    @brief     Starts recording to "sink"
+    @details   The header is written, followed by the current values of all recorded registers,
+               which are read from the device
+    @param[in] sink Print object such as Serial or an SD card File, or a FILE* on Linux, which
+               must stay valid until stop()
+    @param[in] address I2C address of the device to record
+    @return    "true" if the registers could be read, otherwise recording is not started
+  */
+#if defined(ARDUINO)
+  _sink = &sink;
+#else
+  _sink = sink;
+#endif
+  _address   = address;
+  _used      = 0;
+  _records   = 0;
+  _bytes     = 0;
+  _dropped   = 0;
+  _proximity = 0;
+  _ambient   = 0;
+  _ready     = 0;
+  _seen      = 0;
+  _last      = _bus->micros();
+  for (uint8_t i = 0; i < sizeof(recordMagic); ++i) put(recordMagic[i]);
+  put(VCNL4010_RECORD_VERSION);
+  putVarint(_last);
+  _recording = true;
+  if (!snapshot()) {
+    _recording = false;
+    return false;
+  }  // if-then registers not read
+  return true;
+}  // of method start()
+void VCNL4010Recorder::stop() {
+  /*!
+    @brief     Writes the buffered records to the sink and stops recording
+  */
+  if (!_recording) return;
+  record();
+  flush();
+#if !defined(ARDUINO)
+  fflush(_sink);
+#endif
+  _recording = false;
+}  // of method stop()
+void VCNL4010Recorder::flush() {
+  /*!
+    @brief     Writes the buffered records to the sink
+    @details   Bytes the sink does not take are counted in getDropped(), the recording cannot be
+               replayed past them
+  */
+  if (!_used) return;
+#if defined(ARDUINO)
+  const size_t written = _sink->write(_buffer, _used);
+#else
+  const size_t written = fwrite(_buffer, 1, _used, _sink);
+#endif
+  _bytes += written;
+  _dropped += _used - written;
+  _used = 0;
+}  // of method flush()
+bool VCNL4010Recorder::snapshot() {
+  /*!
+    @brief     Records the current values of all recorded registers
+    @details   REGISTER_CMD is read on its own, reading it does not clear the data ready bits
+    @return    "true" if all registers were read
+  */
+  uint8_t       buffer[REGISTER_HIGH_THRESH_LSB + 1 - REGISTER_INTERRUPT];  // Largest block
+  const uint8_t blocks[][2]{
+      {REGISTER_CMD, 1},
+      {REGISTER_PROXIMITY_RATE, REGISTER_AMBIENT_PARAM + 1 - REGISTER_PROXIMITY_RATE},
+      {REGISTER_INTERRUPT, sizeof(buffer)},
+      {REGISTER_PROXIMITY_TIMING, 1}};
+  _known = 0;  // Record all values
+  for (uint8_t i = 0; i < sizeof(blocks) / sizeof(blocks[0]); ++i) {
+    if (_bus->read(_address, blocks[i][0], buffer, blocks[i][1]) != VCNL4010_I2C_OK) return false;
+    registers(blocks[i][0], buffer, blocks[i][1]);
+  }  // for-next each block of registers
+  return true;
+}  // of method snapshot()
+void VCNL4010Recorder::registers(const uint8_t reg, const uint8_t *data, const uint8_t length) {
+  /*!
+    @brief     Records the recorded registers in a block whose value changed
+    @param[in] reg First register of the block
+    @param[in] data Register values
+    @param[in] length Number of registers
+  */
+  for (uint8_t i = 0; i < length; ++i) {
+    const uint8_t index = reg + i - REGISTER_CMD;
+    if (reg + i < REGISTER_CMD || index > 15 || !(recordedRegisters & (1 << index))) continue;
+    const uint8_t value = index ? data[i] : data[i] & commandEnableBits;
+    if ((_known & (1 << index)) && value == _config[index]) continue;
+    _known |= 1 << index;
+    _config[index] = value;
+    header(VCNL4010_RECORD_REGISTER, _bus->micros());
+    put(index);
+    put(value);
+  }  // for-next each register
+}  // of method registers()
+void VCNL4010Recorder::record() {
+  /*!
+    @brief     Records the readings found since the last status read, if any
+  */
+  if (_seen == dataReadyBits) {
+    header(VCNL4010_RECORD_BOTH, _seenMicros);
+    putValue(_newProximity, _proximity);
+    putValue(_newAmbient, _ambient);
+  } else if (_seen == _BV(BIT_PROX_DATA_RDY)) {
+    header(VCNL4010_RECORD_PROXIMITY, _seenMicros);
+    putValue(_newProximity, _proximity);
+  } else if (_seen) {
+    header(VCNL4010_RECORD_AMBIENT, _seenMicros);
+    putValue(_newAmbient, _ambient);
+  }  // if-then-else new readings
+  _seen = 0;
+}  // of method record()
+void VCNL4010Recorder::header(const uint8_t type, const uint32_t now) {
+  /*!
+    @brief     Starts a record with the time since the last record and the type
+    @details   The buffer is written to the sink first if the longest record might not fit
+    @param[in] type Record type
+    @param[in] now Time of the record, not before the time of the last record
+  */
+  if (_used + maxRecordBytes > VCNL4010_RECORD_BUFFER) flush();
+  const uint32_t delta = now - _last;
+  _last                = now;
+  put((uint8_t)((delta & 0x1F) << 2 | type | (delta > 0x1F ? 0x80 : 0)));
+  if (delta > 0x1F) putVarint(delta >> 5);
+  ++_records;
+}  // of method header()
+void VCNL4010Recorder::put(const uint8_t value) {
+  /*!
+    @brief     Adds a byte to the buffer, header() makes sure that there is space
+    @param[in] value Byte to add
+  */
+  _buffer[_used++] = value;
+}  // of method put()
+void VCNL4010Recorder::putVarint(uint32_t value) {
+  /*!
+    @brief     Adds a varint to the buffer
+    @param[in] value Value to add
+  */
+  while (value > 0x7F) {
+    put((uint8_t)(value | 0x80));
+    value >>= 7;
+  }  // of while-loop more than 7 bits left
+  put((uint8_t)value);
+}  // of method putVarint()
+void VCNL4010Recorder::putValue(const uint16_t value, uint16_t &last) {
+  /*!
+    @brief     Adds the difference of a reading to the last one as zigzag varint
+    @param[in] value Reading
+    @param[in,out] last Last reading of the same sensor, set to "value"
+  */
+  const int32_t difference = (int32_t)value - last;
+  last                     = value;
+  putVarint((uint32_t)difference << 1 ^ (uint32_t)(difference >> 31));
+}  // of method putValue()
+
+VCNL4010Replay::VCNL4010Replay(const uint8_t address) : VCNL4010FakeBus(address) {
+  /*!
+   * @brief   Class constructor
+   * @param[in] address I2C address the replayed device answers on
+   */
+}
+bool VCNL4010Replay::open(const uint8_t *data, const uint32_t length) {
+  /*!
+    @brief     Starts replaying a recording in memory
+    @details   The virtual clock is set to the start time of the recording and the recorded
+               register values are applied
+    @param[in] data Recording, must stay valid while replaying
+    @param[in] length Length of the recording in bytes
+    @return    "true" if the header is valid
+  */
+#if !defined(ARDUINO)
+  _file = nullptr;
+#endif
+  _data   = data;
+  _length = length;
+  _offset = 0;
+  return start();
+}  // of method open()
+#if !defined(ARDUINO)
+bool VCNL4010Replay::open(FILE *file) {
+  /*!
+    @brief     Starts replaying a recording file
+    @details   The file is read as the replay progresses, so recordings of any length can be used
+    @param[in] file Recording opened for reading, must stay open while replaying
+    @return    "true" if the header is valid
+  */
+  _file   = file;
+  _data   = nullptr;
+  _length = 0;
+  return start();
+}  // of method open()
+#endif
+uint8_t VCNL4010Replay::read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                             const uint8_t length) {
+  /*!
+    @brief     Bus read, moves the clock to the next record if the driver polls REGISTER_CMD and
+               there is no new reading
+    @details   After the last record the clock advances by 1ms for each such poll instead, so that
+               the driver's timeouts expire
+    @param[in] device I2C device address
+    @param[in] reg First register to read
+    @param[out] data Buffer for the register values
+    @param[in] length Number of bytes to read
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  if (device == _address && reg == REGISTER_CMD && !_ready) {
+    if (!_pending) {
+      advance(1000);
+    } else if ((int32_t)(_time - _now) > 0) {
+      advance(_time - _now);
+    }  // if-then-else end of the recording
+  }    // if-then no new readings
+  return VCNL4010FakeBus::read(device, reg, data, length);
+}  // of method read()
+void VCNL4010Replay::advance(const uint32_t us) {
+  /*!
+    @brief     Advances the virtual clock and applies the records up to the new time
+    @param[in] us Microseconds to advance
+  */
+  _now += us;
+  processUntil(_now);
+}  // of method advance()
+uint8_t VCNL4010Replay::readRegister(const uint8_t reg) {
+  /*!
+    @brief     Device side of a register read
+    @details   REGISTER_CMD returns the enable bits and the data ready bits, reading a result MSB
+               clears its data ready bit
+    @param[in] reg Register address
+    @return    Register value
+  */
+  if (reg == REGISTER_CMD) return (_registers[REGISTER_CMD] & commandEnableBits) | _ready;
+  if (reg == REGISTER_AMBIENT_LIGHT) _ready &= ~_BV(BIT_ALS_DATA_RDY);
+  if (reg == REGISTER_PROXIMITY) _ready &= ~_BV(BIT_PROX_DATA_RDY);
+  return _registers[reg];
+}  // of method readRegister()
+void VCNL4010Replay::writeRegister(const uint8_t reg, const uint8_t value) {
+  /*!
+    @brief     Device side of a register write, the product ID and results are read-only
+    @param[in] reg Register address
+    @param[in] value Value written
+  */
+  if (reg == REGISTER_PRODUCT || (reg >= REGISTER_AMBIENT_LIGHT && reg <= REGISTER_PROXIMITY + 1))
+    return;
+  _registers[reg] = value;
+}  // of method writeRegister()
+bool VCNL4010Replay::start() {
+  /*!
+    @brief     Reads the header, sets the clock to the start time and applies the first records
+    @return    "true" if the header is valid
+  */
+  uint32_t startMicros;
+  _pending    = false;
+  _valid      = false;
+  _records    = 0;
+  _overwrites = 0;
+  _ready      = 0;
+  _proximity  = 0;
+  _ambient    = 0;
+  for (uint8_t i = 0; i < sizeof(recordMagic); ++i) {
+    if (getByte() != recordMagic[i]) return false;
+  }  // for-next each magic character
+  if (getByte() != VCNL4010_RECORD_VERSION || !getVarint(startMicros)) return false;
+  _valid = true;
+  _now   = startMicros;
+  _time  = startMicros;
+  next();
+  processUntil(_now);
+  return _valid;
+}  // of method start()
+int16_t VCNL4010Replay::getByte() {
+  /*!
+    @brief     Returns the next byte of the recording
+    @return    Byte value, or -1 at the end of the recording
+  */
+#if !defined(ARDUINO)
+  if (_file) {
+    const int value = fgetc(_file);
+    return value == EOF ? -1 : value;
+  }  // if-then replaying from a file
+#endif
+  if (_offset >= _length) return -1;
+  return _data[_offset++];
+}  // of method getByte()
+bool VCNL4010Replay::getVarint(uint32_t &value) {
+  /*!
+    @brief     Reads a varint
+    @param[out] value Value read
+    @return    "true" if a complete varint was read
+  */
+  value = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    const int16_t next = getByte();
+    if (next < 0) return false;
+    value |= (uint32_t)(next & 0x7F) << shift;
+    if (!(next & 0x80)) return true;
+  }  // for-next each group of 7 bits
+  return false;
+}  // of method getVarint()
+bool VCNL4010Replay::getValue(uint16_t &last) {
+  /*!
+    @brief     Reads a zigzag varint difference and adds it to the last reading
+    @param[in,out] last Last reading of the same sensor
+    @return    "true" if a complete varint was read
+  */
+  uint32_t zigzag;
+  if (!getVarint(zigzag)) return false;
+  last += (uint16_t)((zigzag >> 1) ^ (0 - (zigzag & 1)));
+  return true;
+}  // of method getValue()
+void VCNL4010Replay::next() {
+  /*!
+    @brief     Reads the next record, isDone() is "true" at the end and isValid() "false" if the
+               record is incomplete or malformed
+  */
+  _pending          = false;
+  const int16_t key = getByte();
+  if (key < 0) return;  // Clean end of the recording
+  uint32_t delta = (key >> 2) & 0x1F;
+  uint32_t high{0};
+  bool     valid{true};
+  if (key & 0x80) {
+    valid = getVarint(high);
+    delta |= high << 5;
+  }  // if-then more time bits
+  _time += delta;
+  _type = key & 0x03;
+  switch (_type) {
+    case VCNL4010_RECORD_REGISTER: {
+      const int16_t index = getByte();
+      const int16_t value = getByte();
+      valid               = valid && index >= 0 && index <= 15 && value >= 0;
+      _reg                = REGISTER_CMD + (uint8_t)index;
+      _value              = (uint8_t)value;
+      break;
+    }
+    case VCNL4010_RECORD_PROXIMITY: valid = valid && getValue(_proximity); break;
+    case VCNL4010_RECORD_AMBIENT: valid = valid && getValue(_ambient); break;
+    default: valid = valid && getValue(_proximity) && getValue(_ambient); break;
+  }  // of switch record type
+  _pending = valid;
+  _valid   = _valid && valid;
+}  // of method next()
+void VCNL4010Replay::apply() {
+  /*!
+    @brief     Applies the record read by next() to the registers
+  */
+  ++_records;
+  switch (_type) {
+    case VCNL4010_RECORD_REGISTER: _registers[_reg] = _value; break;
+    case VCNL4010_RECORD_PROXIMITY:
+      setReading(REGISTER_PROXIMITY, _proximity, _BV(BIT_PROX_DATA_RDY));
+      break;
+    case VCNL4010_RECORD_AMBIENT:
+      setReading(REGISTER_AMBIENT_LIGHT, _ambient, _BV(BIT_ALS_DATA_RDY));
+      break;
+    default:
+      setReading(REGISTER_PROXIMITY, _proximity, _BV(BIT_PROX_DATA_RDY));
+      setReading(REGISTER_AMBIENT_LIGHT, _ambient, _BV(BIT_ALS_DATA_RDY));
+      break;
+  }  // of switch record type
+}  // of method apply()
+void VCNL4010Replay::processUntil(const uint32_t time) {
+  /*!
+    @brief     Applies all records up to and including "time"
+    @param[in] time Virtual time
+  */
+  while (_pending && (int32_t)(_time - time) <= 0) {
+    apply();
+    next();
+  }  // of while-loop records are due
+}  // of method processUntil()
+void VCNL4010Replay::setReading(const uint8_t reg, const uint16_t value, const uint8_t ready) {
+  /*!
+    @brief     Stores a reading in the result registers and sets its data ready bit
+    @param[in] reg Result MSB register
+    @param[in] value Reading
+    @param[in] ready Data ready bit of the reading
+  */
+  if (_ready & ready) ++_overwrites;
+  _registers[reg]     = (uint8_t)(value >> 8);
+  _registers[reg + 1] = (uint8_t)value;
+  _ready |= ready;
+}  // of method setReading()
@@ -0,0 +1,170 @@
+/*! @file VCNL4010Record.h
+
+@section VCNL4010Record_intro_section Description
+
+Recording and replay of raw VCNL4010 sensor streams. The VCNL4010Recorder class is a VCNL4010Bus
+which passes all transactions on to another bus and watches them: each new proximity and ambient
+light reading the driver reads is logged with its time, as are changes to the configuration
+registers (command enable bits, proximity rate, LED current, ambient light parameters, interrupt
+control, thresholds and proximity timing). New readings are those announced by the data ready bits
+of a REGISTER_CMD read, in polled, interrupt and streaming mode alike. They are logged with the
+time of the last read of their result when the next REGISTER_CMD read, configuration change or
+stop() shows that the driver is done with them. Recording is started and stopped at any time:\n
+    VCNL4010WireBus  wire;\n
+    VCNL4010Recorder recorder(wire);\n
+    VCNL4010         sensor(recorder);\n
+    ...\n
+    recorder.start(Serial);  // or an SD card File, or a FILE* on Linux\n
+\n
+The records are collected in a small fixed buffer and written to the sink when it is full or on
+flush(). The VCNL4010Replay class is a VCNL4010FakeBus which plays a recording back to the driver,
+so that programs, filters and detection logic run on real traces through the normal driver calls.
+The replay runs on a virtual clock at the recorded times, but whenever the driver finds no new
+reading the clock jumps to the next record, so hours of recording are replayed in seconds.\n
+\n
+The format is a header of the 4 characters "VCNL", the format version and the start time in
+microseconds as varint, followed by the records. Each record starts with a varint made of the
+microseconds since the previous record shifted left by 2 bits and the record type in the low 2
+bits:\n
+- VCNL4010_RECORD_REGISTER: followed by the register address minus 0x80 and the value, 1 byte each
+- VCNL4010_RECORD_PROXIMITY, VCNL4010_RECORD_AMBIENT: followed by the zigzag varint difference to
+  the previous reading of the same sensor
+- VCNL4010_RECORD_BOTH: followed by the proximity and then the ambient light difference\n
+\n
+Varints store 7 bits per byte, low bits first, with bit 7 set in all but the last byte. A reading
+at 250 proximity readings/s takes 3 to 4 bytes.
+
+See main library header file for details
+*/
+#ifndef VCNL4010Record_h
+/*! @brief Guard code definition for the VCNL4010Record header */
+#define VCNL4010Record_h
+#include "VCNL4010.h"  // Register definitions and bus transports
+#if !defined(ARDUINO)
+#include <stdio.h>  // FILE
+#endif
+
+const uint8_t VCNL4010_RECORD_VERSION{1};    ///< Format version written to the header
+const uint8_t VCNL4010_RECORD_BUFFER{32};    ///< Bytes buffered before writing to the sink
+const uint8_t VCNL4010_RECORD_REGISTER{0};   ///< Record type of a configuration register change
+const uint8_t VCNL4010_RECORD_PROXIMITY{1};  ///< Record type of a proximity reading
+const uint8_t VCNL4010_RECORD_AMBIENT{2};    ///< Record type of an ambient light reading
+const uint8_t VCNL4010_RECORD_BOTH{3};       ///< Record type of both readings at once
+
+class VCNL4010Recorder : public VCNL4010Bus {
+  /*!
+   * @class VCNL4010Recorder
+   * @brief Bus transport which records the readings and configuration changes passing through it
+   */
+ public:
+  explicit VCNL4010Recorder(VCNL4010Bus &bus);
+  bool     begin(const uint32_t speed) override { return _bus->begin(speed); }  ///< Pass on
+  uint8_t  read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                const uint8_t length) override;
+  uint8_t  write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                 const uint8_t length) override;
+  uint32_t micros() override { return _bus->micros(); }  ///< Pass on
+  void     delayMicroseconds(const uint32_t us) override {
+    _bus->delayMicroseconds(us);
+  }                                                        ///< Pass on
+  bool     recover() override { return _bus->recover(); }  ///< Pass on
+  void     setSettleDelay(const uint16_t us) override;     // Set delay here and passed on
+#if defined(ARDUINO)
+  bool start(Print &sink, const uint8_t address = VCNL4010_I2C_ADDRESS);  // Start recording
+#else
+  bool start(FILE *sink, const uint8_t address = VCNL4010_I2C_ADDRESS);  // Start recording
+#endif
+  void     stop();                                      // Flush and stop recording
+  void     flush();                                     // Write the buffer to the sink
+  bool     isRecording() const { return _recording; }  ///< Recording is running
+  uint32_t getRecords() const { return _records; }      ///< Records written
+  uint32_t getBytes() const { return _bytes; }          ///< Bytes passed to the sink
+  uint32_t getDropped() const { return _dropped; }      ///< Bytes the sink did not take
+
+ private:
+  bool snapshot();                                 // Record all recorded registers
+  void registers(const uint8_t reg, const uint8_t *data, const uint8_t length);  // Changes
+  void record();                                   // Record the readings found
+  void header(const uint8_t type, const uint32_t now);  // Start a record
+  void put(const uint8_t value);                   // Add a byte to the buffer
+  void putVarint(uint32_t value);                  // Add a varint to the buffer
+  void putValue(const uint16_t value, uint16_t &last);  // Add a zigzag difference
+  VCNL4010Bus *_bus;                               // Bus passed on to
+#if defined(ARDUINO)
+  Print *_sink{nullptr};  // Sink for the records
+#else
+  FILE *_sink{nullptr};  // Sink for the records
+#endif
+  uint32_t _last{0};                         // Time of the last record
+  uint32_t _records{0};                      // Records written
+  uint32_t _bytes{0};                        // Bytes passed to the sink
+  uint32_t _dropped{0};                      // Bytes the sink did not take
+  uint32_t _seenMicros{0};                   // Time the readings found were last read
+  uint16_t _proximity{0};                    // Last proximity reading recorded
+  uint16_t _ambient{0};                      // Last ambient light reading recorded
+  uint16_t _newProximity{0};                 // Proximity reading found, not yet recorded
+  uint16_t _newAmbient{0};                   // Ambient light reading found, not yet recorded
+  uint16_t _known{0};                        // Bits of the registers recorded so far
+  uint8_t  _config[16]{0};                   // Registers 0x80 to 0x8F as last recorded
+  uint8_t  _buffer[VCNL4010_RECORD_BUFFER];  // Records not yet written to the sink
+  uint8_t  _used{0};                         // Bytes used in the buffer
+  uint8_t  _ready{0};                        // Data ready bits of the last status read
+  uint8_t  _seen{0};                         // Data ready bits of the readings found
+  uint8_t  _address{VCNL4010_I2C_ADDRESS};   // I2C address of the recorded device
+  bool     _recording{false};                // Recording is running
+};                                           // of class VCNL4010Recorder
+
+class VCNL4010Replay : public VCNL4010FakeBus {
+  /*!
+   * @class VCNL4010Replay
+   * @brief Simulated VCNL4010 which plays back a recording made with VCNL4010Recorder
+   * @details Configuration writes by the driver are stored like in VCNL4010FakeBus until a
+   *          recorded configuration change overwrites them. On-demand bits written to
+   *          REGISTER_CMD read back as 0, readings only come from the recording
+   */
+ public:
+  explicit VCNL4010Replay(const uint8_t address = VCNL4010_I2C_ADDRESS);
+  bool open(const uint8_t *data, const uint32_t length);  // Replay from memory
+#if !defined(ARDUINO)
+  bool open(FILE *file);  // Replay from a file
+#endif
+  uint8_t  read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                const uint8_t length) override;
+  void     advance(const uint32_t us) override;
+  bool     isDone() const { return !_pending; }           ///< All records replayed
+  bool     isValid() const { return _valid; }             ///< Recording read without errors
+  uint32_t getRecords() const { return _records; }        ///< Records replayed
+  uint32_t getOverwrites() const { return _overwrites; }  ///< Readings replaced before read
+
+ protected:
+  uint8_t readRegister(const uint8_t reg) override;
+  void    writeRegister(const uint8_t reg, const uint8_t value) override;
+
+ private:
+  bool    start();                            // Read the header and the first record
+  int16_t getByte();                          // Next byte, -1 at the end
+  bool    getVarint(uint32_t &value);         // Next varint
+  bool    getValue(uint16_t &last);           // Next zigzag difference
+  void    next();                             // Read the next record
+  void    apply();                            // Apply the record read by next()
+  void    processUntil(const uint32_t time);  // Apply all records up to "time"
+  void    setReading(const uint8_t reg, const uint16_t value, const uint8_t ready);  // Store
+  const uint8_t *_data{nullptr};              // Recording in memory
+  uint32_t       _length{0};                  // Bytes of the recording in memory
+  uint32_t       _offset{0};                  // Read position in memory
+#if !defined(ARDUINO)
+  FILE *_file{nullptr};  // Recording file
+#endif
+  uint32_t _time{0};         // Time of the next record
+  uint32_t _records{0};      // Records replayed
+  uint32_t _overwrites{0};   // Readings replaced before they were read
+  uint16_t _proximity{0};    // Proximity reading of the next record
+  uint16_t _ambient{0};      // Ambient light reading of the next record
+  uint8_t  _type{0};         // Type of the next record
+  uint8_t  _reg{0};          // Register of the next register record
+  uint8_t  _value{0};        // Value of the next register record
+  uint8_t  _ready{0};        // Data ready bits of REGISTER_CMD
+  bool     _pending{false};  // The next record is valid
+  bool     _valid{false};    // No errors in the recording
+};                           // of class VCNL4010Replay
+#endif
@@ -0,0 +1,114 @@
+/*! @file VCNL4010Ring.h
+
+@section VCNL4010Ring_intro_section Description
+
+Fixed-capacity single-producer/single-consumer ring buffer used by the VCNL4010 library to pass
+samples from the interrupt handling code to the main program. No memory is allocated at runtime;
+the capacity is a template parameter and must be a power of 2 no larger than 128 so that the head
+and tail indices are single bytes, which are read and written atomically on all platforms
+including 8-bit AVR processors.
+
+The producer only ever writes "_head" and the consumer only ever writes "_tail", so no locking
+is required as long as there is exactly one of each.
+
+See main library header file for details
+*/
+#ifndef VCNL4010Ring_h
+/*! @brief Guard code definition for the VCNL4010Ring header */
+#define VCNL4010Ring_h
+#include <stdint.h>
+#if defined(__AVR__)
+/*! @brief Compiler barrier, single core AVR processors need no hardware barrier */
+#define VCNL4010_MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")
+#else
+/*! @brief Full memory barrier for multi-core processors such as the ESP32 */
+#define VCNL4010_MEMORY_BARRIER() __sync_synchronize()
+#endif
+
+template <typename T, uint8_t N>
+class VCNL4010Ring {
+  /*!
+   * @class VCNL4010Ring
+   * @brief Lock-free single-producer/single-consumer ring buffer of "N" elements of type "T"
+   */
+  static_assert(N >= 2 && N <= 128 && (N & (N - 1)) == 0, "Size must be a power of 2 up to 128");
+
+ public:
+  bool push(const T &item) {
+    /*!
+      @brief     Adds an element to the ring, called by the producer only
+      @details   If the ring is full the element is discarded and the overflow counter incremented
+      @param[in] item Element to add
+      @return    "true" if the element was stored, "false" if the ring was full
+    */
+    const uint8_t head = _head;
+    if ((uint8_t)(head - _tail) == N) {
+      ++_overflows;  // Count the lost element
+      return false;
+    }  // if-then ring is full
+    _data[head & (N - 1)] = item;
+    VCNL4010_MEMORY_BARRIER();  // Element must be stored before it is published
+    _head = head + 1;
+    return true;
+  }  // of method push()
+  uint8_t pop(T *items, const uint8_t maxItems) {
+    /*!
+      @brief     Removes up to "maxItems" elements from the ring, called by the consumer only
+      @param[out] items Array of at least "maxItems" elements to receive the data
+      @param[in] maxItems Maximum number of elements to return
+      @return    Number of elements returned
+    */
+    const uint8_t head = _head;
+    VCNL4010_MEMORY_BARRIER();  // Read elements only after the head index
+    uint8_t tail  = _tail;
+    uint8_t count = 0;
+    while (tail != head && count < maxItems) {
+      items[count++] = _data[tail++ & (N - 1)];
+    }  // of while-loop elements to copy
+    VCNL4010_MEMORY_BARRIER();  // Elements must be copied before the slots are released
+    _tail = tail;
+    return count;
+  }  // of method pop()
+  bool pop(T &item) {
+    /*!
+      @brief     Removes one element from the ring, called by the consumer only
+      @param[out] item Element returned
+      @return    "true" if an element was returned, "false" if the ring was empty
+    */
+    return pop(&item, 1) == 1;
+  }  // of method pop()
+  uint8_t available() const {
+    /*!
+      @brief     Returns the number of elements waiting in the ring
+      @return    Number of elements
+    */
+    return (uint8_t)(_head - _tail);
+  }  // of method available()
+  uint8_t capacity() const {
+    /*!
+      @brief     Returns the maximum number of elements the ring can hold
+      @return    Ring capacity
+    */
+    return N;
+  }  // of method capacity()
+  uint16_t overflows() const {
+    /*!
+      @brief     Returns the number of elements discarded because the ring was full
+      @return    Overflow count
+    */
+    return _overflows;
+  }  // of method overflows()
+  void clearOverflows() {
+    /*!
+      @brief     Resets the overflow counter
+    */
+    _overflows = 0;
+  }  // of method clearOverflows()
+
+ private:
+  T                 _data[N];       // Storage for the elements
+  volatile uint8_t  _head{0};       // Next slot to write, only changed by the producer
+  volatile uint8_t  _tail{0};       // Next slot to read, only changed by the consumer
+  volatile uint16_t _overflows{0};  // Elements discarded because the ring was full
+};                                  // of class VCNL4010Ring
+#endif
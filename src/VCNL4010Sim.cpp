@@ -0,0 +1,386 @@
+/*! @file VCNL4010Sim.cpp
+ @section VCNL4010Sim_cpp_intro_section Description
+
+Simulated VCNL4010 device for host-side testing\n\n
+See VCNL4010Sim.h for details
+*/
+#include "VCNL4010Sim.h"  // Include the header definition
+#include <string.h>        // memset()
+
+#include "VCNL4010.h"  // Register and bit definitions
+/*! @brief Returns "true" if virtual time "a" is not later than "b", allowing for wrap-around */
+static inline bool notAfter(const uint32_t a, const uint32_t b) { return (int32_t)(a - b) <= 0; }
+
+VCNL4010Sim::VCNL4010Sim(const uint8_t address) : VCNL4010FakeBus(address) {
+  /*!
+   * @brief   Class constructor
+   * @param[in] address I2C address the simulated device answers on
+   */
+}
+void VCNL4010Sim::reset() {
+  /*!
+    @brief     Returns the simulated device to its power-on state
+    @details   The virtual clock, the scene and the counters are not changed
+  */
+  memset(_registers, 0, sizeof(_registers));
+  _registers[REGISTER_PRODUCT]          = VCNL4010_PRODUCT_VERSION;
+  _registers[REGISTER_LED_CURRENT]      = 0x02;
+  _registers[REGISTER_AMBIENT_PARAM]    = 0x1D;
+  _registers[REGISTER_PROXIMITY_TIMING] = 0x01;
+  _proxRunning                          = false;
+  _alsRunning                           = false;
+  _proxExceeded                         = 0;
+  _alsExceeded                          = 0;
+}  // of method reset()
+void VCNL4010Sim::setScene(const uint16_t proximity, const uint16_t ambient) {
+  /*!
+    @brief     Sets a fixed scene
+    @param[in] proximity Proximity reading at an LED current of 20mA, scaled with the current
+    @param[in] ambient Ambient light reading
+  */
+  _scene          = nullptr;
+  _sceneProximity = proximity;
+  _sceneAmbient   = ambient;
+}  // of method setScene()
+void VCNL4010Sim::setScene(VCNL4010SimScene scene, void *context) {
+  /*!
+    @brief     Sets a scene callback which is called for each measurement
+    @details   Proximity values returned are taken to be at an LED current of 20mA and are scaled
+               with the current set in REGISTER_LED_CURRENT
+    @param[in] scene Callback function
+    @param[in] context Pointer passed to the callback
+  */
+  _scene        = scene;
+  _sceneContext = context;
+}  // of method setScene()
+void VCNL4010Sim::setNoise(const uint16_t proximity, const uint16_t ambient) {
+  /*!
+    @brief     Sets the peak amplitude of the uniform noise added to readings
+    @details   The noise comes from a fixed-seed pseudo random generator, so runs are repeatable.
+               The ambient light noise is that of a single conversion, it falls with the square
+               root of the number of conversions averaged as set in REGISTER_AMBIENT_PARAM
+    @param[in] proximity Peak proximity noise in counts
+    @param[in] ambient Peak ambient light noise of one conversion in counts
+  */
+  _noiseProximity = proximity;
+  _noiseAmbient   = ambient;
+}  // of method setNoise()
+void VCNL4010Sim::setTiming(const uint16_t proxMicros, const uint16_t alsConversionMicros) {
+  /*!
+    @brief     Sets the measurement times used by the model
+    @param[in] proxMicros Time of one proximity measurement
+    @param[in] alsConversionMicros Time of one ALS conversion, a measurement takes this times the
+               averaging count
+  */
+  _proxMicros    = proxMicros;
+  _alsConvMicros = alsConversionMicros;
+}  // of method setTiming()
+void VCNL4010Sim::onInterrupt(VCNL4010SimInterrupt callback, void *context) {
+  /*!
+    @brief     Sets a function to be called when the simulated INT pin is asserted
+    @param[in] callback Callback function, e.g. one that calls VCNL4010::onInterrupt()
+    @param[in] context Pointer passed to the callback
+  */
+  _interrupt        = callback;
+  _interruptContext = context;
+}  // of method onInterrupt()
+bool VCNL4010Sim::interruptAsserted() const {
+  /*!
+    @brief     Returns the state of the simulated INT pin
+    @return    "true" while any REGISTER_INTERRUPT_STATUS bit is set
+  */
+  return _registers[REGISTER_INTERRUPT_STATUS] & 0x0F;
+}  // of method interruptAsserted()
+uint32_t VCNL4010Sim::transactionMicros(const uint8_t bytes) const {
+  /*!
+    @brief     Returns the bus time of a transaction at the current speed
+    @details   Each byte takes 9 clock cycles including the acknowledge bit, the start and stop
+               conditions take one cycle each
+    @param[in] bytes Bytes transferred including address bytes
+    @return    Time in microseconds, rounded up
+  */
+  return cycleMicros((uint32_t)bytes * 9 + 2);
+}  // of method transactionMicros()
+uint32_t VCNL4010Sim::cycleMicros(const uint32_t cycles) const {
+  /*!
+    @brief     Returns the time of a number of bus clock cycles at the current speed
+    @param[in] cycles Clock cycles
+    @return    Time in microseconds, rounded up
+  */
+  return (uint32_t)(((uint64_t)cycles * 1000000 + _speed - 1) / _speed);
+}  // of method cycleMicros()
+uint8_t VCNL4010Sim::read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                          const uint8_t length) {
+  /*!
+    @brief     Bus read, takes the bus time of a write of the register address and a read of
+               "length" bytes joined with a repeated start
+    @details   The virtual clock runs byte by byte, each register is read when its byte starts, so
+               measurements which complete during a burst show up in the later bytes only
+    @param[in] device I2C device address
+    @param[in] reg First register to read
+    @param[out] data Buffer for the register values
+    @param[in] length Number of bytes to read
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  _busMicros += transactionMicros(3 + length);
+  _transactionStart  = _now;
+  _transactionCycles = 1 + 3 * 9;  // Start, address, register, repeated start and address
+  const uint8_t status = VCNL4010FakeBus::read(device, reg, data, length);
+  clockTo(transactionMicros(3 + length));  // Rest of the last byte and the stop condition
+  return status;
+}  // of method read()
+uint8_t VCNL4010Sim::write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                           const uint8_t length) {
+  /*!
+    @brief     Bus write, takes the bus time of the address, register and data bytes
+    @details   The virtual clock runs byte by byte, each register is written when its byte has
+               been acknowledged
+    @param[in] device I2C device address
+    @param[in] reg First register to write
+    @param[in] data Bytes to write
+    @param[in] length Number of bytes to write
+    @return    VCNL4010_I2C_OK or an error status
+  */
+  _busMicros += transactionMicros(2 + length);
+  _transactionStart  = _now;
+  _transactionCycles = 1 + 2 * 9;  // Start, address and register
+  const uint8_t status = VCNL4010FakeBus::write(device, reg, data, length);
+  clockTo(transactionMicros(2 + length));  // Stop condition
+  return status;
+}  // of method write()
+void VCNL4010Sim::clockTo(const uint32_t us) {
+  /*!
+    @brief     Runs the device model up to a time within the current transaction
+    @details   Does nothing if the clock is already later, e.g. after a settle delay
+    @param[in] us Microseconds since the start of the transaction
+  */
+  if (!notAfter(_transactionStart + us, _now)) processUntil(_transactionStart + us);
+}  // of method clockTo()
+void VCNL4010Sim::advance(const uint32_t us) {
+  /*!
+    @brief     Advances the virtual clock and runs the device model up to the new time
+    @param[in] us Microseconds to advance
+  */
+  processUntil(_now + us);
+}  // of method advance()
+void VCNL4010Sim::processUntil(const uint32_t time) {
+  /*!
+    @brief     Processes all device events up to "time" in chronological order
+    @param[in] time Virtual time to run to
+  */
+  for (;;) {
+    const uint8_t command   = _registers[REGISTER_CMD];
+    const bool    selfTimed = command & _BV(BIT_SELFTIMED_EN);
+    const bool    proxTimed = selfTimed && (command & _BV(BIT_PROX_EN));
+    const bool    alsTimed  = selfTimed && (command & _BV(BIT_ALS_EN));
+    uint8_t       event{0};  // 1 = PROX done, 2 = ALS done, 3 = PROX start, 4 = ALS start
+    uint32_t      at{time};
+    if (_proxRunning && notAfter(_proxDone, at)) {
+      event = 1;
+      at    = _proxDone;
+    }  // if-then proximity completes first
+    if (_alsRunning && notAfter(_alsDone, at) && !(event && _alsDone == at)) {
+      event = 2;
+      at    = _alsDone;
+    }  // if-then ambient completes first
+    if (proxTimed && !_proxRunning && notAfter(_proxNext, at) && !(event && _proxNext == at)) {
+      event = 3;
+      at    = _proxNext;
+    }  // if-then self-timed proximity starts first
+    if (alsTimed && !_alsRunning && notAfter(_alsNext, at) && !(event && _alsNext == at)) {
+      event = 4;
+      at    = _alsNext;
+    }  // if-then self-timed ambient starts first
+    if (!event) break;
+    _now = at;
+    switch (event) {
+      case 1: completeProximity(at); break;
+      case 2: completeAmbient(at); break;
+      case 3:
+        startProximity(at);
+        _proxNext = at + proximityPeriod();
+        break;
+      default:
+        startAmbient(at);
+        _alsNext = at + ambientPeriod();
+        break;
+    }  // of switch event
+  }    // of for-ever until no more events
+  _now = time;
+}  // of method processUntil()
+void VCNL4010Sim::startProximity(const uint32_t time) {
+  /*!
+    @brief     Starts a proximity measurement
+    @param[in] time Start time
+  */
+  _proxRunning = true;
+  _proxDone    = time + _proxMicros;
+}  // of method startProximity()
+void VCNL4010Sim::startAmbient(const uint32_t time) {
+  /*!
+    @brief     Starts an ambient light measurement, which takes longer with more averaging
+    @param[in] time Start time
+  */
+  _alsRunning = true;
+  _alsDone    = time + ((uint32_t)_alsConvMicros << (_registers[REGISTER_AMBIENT_PARAM] & 0x07));
+}  // of method startAmbient()
+void VCNL4010Sim::completeProximity(const uint32_t time) {
+  /*!
+    @brief     Stores a proximity result and updates the status and interrupt bits
+    @param[in] time Completion time
+  */
+  const uint16_t value = sceneValue(time, true);
+  if (_registers[REGISTER_CMD] & _BV(BIT_PROX_DATA_RDY)) ++_proxOverwrites;
+  _registers[REGISTER_PROXIMITY]     = value >> 8;
+  _registers[REGISTER_PROXIMITY + 1] = value & 0xFF;
+  _registers[REGISTER_CMD] =
+      (_registers[REGISTER_CMD] & ~_BV(BIT_PROX_OD)) | _BV(BIT_PROX_DATA_RDY);
+  _proxRunning = false;
+  ++_proxCount;
+  if (_registers[REGISTER_INTERRUPT] & 0b00001000) raiseInterrupt(0b00001000);
+  checkThreshold(true, value);
+}  // of method completeProximity()
+void VCNL4010Sim::completeAmbient(const uint32_t time) {
+  /*!
+    @brief     Stores an ambient light result and updates the status and interrupt bits
+    @param[in] time Completion time
+  */
+  const uint16_t value                   = sceneValue(time, false);
+  _registers[REGISTER_AMBIENT_LIGHT]     = value >> 8;
+  _registers[REGISTER_AMBIENT_LIGHT + 1] = value & 0xFF;
+  _registers[REGISTER_CMD] = (_registers[REGISTER_CMD] & ~_BV(BIT_ALS_OD)) | _BV(BIT_ALS_DATA_RDY);
+  _alsRunning              = false;
+  ++_alsCount;
+  if (_registers[REGISTER_INTERRUPT] & 0b00000100) raiseInterrupt(0b00000100);
+  checkThreshold(false, value);
+}  // of method completeAmbient()
+void VCNL4010Sim::checkThreshold(const bool proximity, const uint16_t value) {
+  /*!
+    @brief     Applies the threshold interrupt logic to a new reading
+    @details   The interrupt is raised when the number of consecutive readings outside of the
+               threshold window reaches the count set in bits 5-7 of REGISTER_INTERRUPT
+    @param[in] proximity "true" for a proximity reading, "false" for ambient light
+    @param[in] value New reading
+  */
+  const uint8_t control = _registers[REGISTER_INTERRUPT];
+  if (!(control & 0b00000010) || (bool)(control & 0b00000001) == proximity) return;
+  const uint16_t low   = (uint16_t)_registers[REGISTER_LOW_THRESH_MSB] << 8 |
+                       _registers[REGISTER_LOW_THRESH_LSB];
+  const uint16_t high  = (uint16_t)_registers[REGISTER_HIGH_THRESH_MSB] << 8 |
+                        _registers[REGISTER_HIGH_THRESH_LSB];
+  const uint8_t  count = 1 << (control >> 5);
+  uint8_t       &exceeded = proximity ? _proxExceeded : _alsExceeded;
+  if (value >= low && value <= high) {
+    exceeded = 0;  // Back inside the window
+    return;
+  }  // if-then inside the window
+  if (exceeded < count) ++exceeded;
+  if (exceeded >= count) raiseInterrupt(value < low ? 0b00000010 : 0b00000001);
+}  // of method checkThreshold()
+void VCNL4010Sim::raiseInterrupt(const uint8_t bits) {
+  /*!
+    @brief     Sets interrupt status bits and calls the INT pin callback when the pin is asserted
+    @param[in] bits REGISTER_INTERRUPT_STATUS bits to set
+  */
+  const bool asserted = interruptAsserted();
+  _registers[REGISTER_INTERRUPT_STATUS] |= bits;
+  if (!asserted && _interrupt) _interrupt(_interruptContext);
+}  // of method raiseInterrupt()
+uint16_t VCNL4010Sim::sceneValue(const uint32_t time, const bool proximity) {
+  /*!
+    @brief     Returns the reading for the current scene with noise added
+    @param[in] time Measurement time
+    @param[in] proximity "true" for a proximity reading, "false" for ambient light
+    @return    Reading, limited to 0-65535
+  */
+  int32_t value = _scene ? _scene(time, proximity, _sceneContext)
+                         : (proximity ? _sceneProximity : _sceneAmbient);
+  if (proximity) value = value * (_registers[REGISTER_LED_CURRENT] & 0x3F) / 2;  // 20mA = 2
+  uint16_t noise = proximity ? _noiseProximity : _noiseAmbient;
+  if (!proximity) {
+    const uint8_t averaging = _registers[REGISTER_AMBIENT_PARAM] & 0x07;  // log2 of conversions
+    noise >>= averaging / 2;                                             // Halve every 4 times and
+    if (averaging & 1) noise = (uint16_t)((uint32_t)noise * 181 >> 8);   // divide by sqrt(2)
+  }  // if-then ambient noise is averaged
+  if (noise) {
+    _random ^= _random << 13;  // xorshift32 generator
+    _random ^= _random >> 17;
+    _random ^= _random << 5;
+    value += (int32_t)(_random % (2 * (uint32_t)noise + 1)) - noise;
+  }  // if-then noise is added
+  if (value < 0) return 0;
+  if (value > 65535) return 65535;
+  return (uint16_t)value;
+}  // of method sceneValue()
+uint32_t VCNL4010Sim::proximityPeriod() const {
+  /*!
+    @brief     Returns the self-timed proximity measurement period
+    @return    Period in microseconds
+  */
+  return VCNL4010Encode::proximityPeriod(_registers[REGISTER_PROXIMITY_RATE] & 0x07);
+}  // of method proximityPeriod()
+uint32_t VCNL4010Sim::ambientPeriod() const {
+  /*!
+    @brief     Returns the self-timed ambient light measurement period
+    @return    Period in microseconds
+  */
+  return 1000000UL / VCNL4010Encode::ambientHz((_registers[REGISTER_AMBIENT_PARAM] >> 4) & 0x07);
+}  // of method ambientPeriod()
+uint8_t VCNL4010Sim::readRegister(const uint8_t reg) {
+  /*!
+    @brief     Device side of a register read, reading a result MSB clears its data ready bit
+    @details   Runs the device model up to the start of the byte first
+    @param[in] reg Register address
+    @return    Register value
+  */
+  clockTo(cycleMicros(_transactionCycles));  // Start of this byte
+  _transactionCycles += 9;
+  if (reg == REGISTER_AMBIENT_LIGHT) _registers[REGISTER_CMD] &= ~_BV(BIT_ALS_DATA_RDY);
+  if (reg == REGISTER_PROXIMITY) _registers[REGISTER_CMD] &= ~_BV(BIT_PROX_DATA_RDY);
+  return _registers[reg];
+}  // of method readRegister()
+void VCNL4010Sim::writeRegister(const uint8_t reg, const uint8_t value) {
+  /*!
+    @brief     Device side of a register write
+    @details   Read-only registers ignore writes. Writing REGISTER_CMD starts on-demand
+               measurements and schedules self-timed ones, writing REGISTER_INTERRUPT_STATUS
+               clears the bits written as 1. Runs the device model up to the end of the byte first
+    @param[in] reg Register address
+    @param[in] value Value written
+  */
+  _transactionCycles += 9;
+  clockTo(cycleMicros(_transactionCycles));  // Byte acknowledged
+  switch (reg) {
+    case REGISTER_CMD: {
+      const uint8_t old     = _registers[REGISTER_CMD];
+      const uint8_t enabled = _BV(BIT_SELFTIMED_EN);
+      uint8_t       command = (old & 0b11111000) | (value & 0b00000111);
+      if ((value & _BV(BIT_PROX_OD)) && !_proxRunning) {
+        command |= _BV(BIT_PROX_OD);
+        startProximity(_now);
+      }  // if-then proximity on-demand measurement started
+      if ((value & _BV(BIT_ALS_OD)) && !_alsRunning) {
+        command |= _BV(BIT_ALS_OD);
+        startAmbient(_now);
+      }  // if-then ambient on-demand measurement started
+      if ((command & (enabled | _BV(BIT_PROX_EN))) == (enabled | _BV(BIT_PROX_EN)) &&
+          (old & (enabled | _BV(BIT_PROX_EN))) != (enabled | _BV(BIT_PROX_EN))) {
+        _proxNext = _now;  // Self-timed proximity starts now
+      }                    // if-then self-timed proximity switched on
+      if ((command & (enabled | _BV(BIT_ALS_EN))) == (enabled | _BV(BIT_ALS_EN)) &&
+          (old & (enabled | _BV(BIT_ALS_EN))) != (enabled | _BV(BIT_ALS_EN))) {
+        _alsNext = _now;  // Self-timed ambient starts now
+      }                   // if-then self-timed ambient switched on
+      _registers[REGISTER_CMD] = command;
+      break;
+    }
+    case REGISTER_PRODUCT:
+    case REGISTER_AMBIENT_LIGHT:
+    case REGISTER_AMBIENT_LIGHT + 1:
+    case REGISTER_PROXIMITY:
+    case REGISTER_PROXIMITY + 1: break;  // Read-only
+    case REGISTER_LED_CURRENT: _registers[reg] = value & 0x3F; break;
+    case REGISTER_INTERRUPT_STATUS: _registers[reg] &= ~value; break;  // Write 1 to clear
+    default: _registers[reg] = value; break;
+  }  // of switch register
+}  // of method writeRegister()
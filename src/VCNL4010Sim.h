@@ -0,0 +1,115 @@
+/*! @file VCNL4010Sim.h
+
+@section VCNL4010Sim_intro_section Description
+
+Simulated VCNL4010 device for host-side testing of the VCNL4010 library. The VCNL4010Sim class is
+a VCNL4010Bus, so the VCNL4010 class is used against it exactly as against real hardware:\n
+    VCNL4010Sim sim;\n
+    VCNL4010    sensor(sim);\n
+\n
+The simulation runs on a virtual clock which only moves when the driver waits, when a bus
+transaction takes place (each transaction takes the time its bits need at the bus speed given to
+begin(), and the clock runs byte by byte so measurements interleave with the register accesses of
+a burst) or when advance() is called. Runs are therefore deterministic, and the latency and bus
+time of each driver call can be measured exactly with micros() and getBusMicros().\n
+\n
+The model covers the register file and these behaviours of the device:\n
+- REGISTER_CMD on-demand bits stay set while a measurement runs and clear when it completes,
+  setting the matching data ready bit; the data ready bits clear when the result MSB is read
+- Self-timed proximity measurements at the REGISTER_PROXIMITY_RATE rates and self-timed ambient
+  light measurements at the REGISTER_AMBIENT_PARAM rates
+- Ambient light measurement time scaled by the averaging setting
+- Threshold interrupts with the REGISTER_INTERRUPT count setting, data ready interrupts and the
+  sticky, write-1-to-clear REGISTER_INTERRUPT_STATUS bits
+- Read-only registers ignore writes\n
+\n
+The readings are produced from a scene, which is either a fixed value set with setScene() or a
+callback, plus optional deterministic noise. Proximity readings scale with the LED current.
+Measurement times are approximations from the datasheet and can be changed with setTiming().
+
+See main library header file for details
+*/
+#ifndef VCNL4010Sim_h
+/*! @brief Guard code definition for the VCNL4010Sim header */
+#define VCNL4010Sim_h
+#include "VCNL4010Bus.h"  // Base classes
+
+/*! @brief Scene callback, returns the raw reading for the proximity or ambient light sensor */
+typedef uint16_t (*VCNL4010SimScene)(const uint32_t micros, const bool proximity, void *context);
+/*! @brief Interrupt callback, called when the simulated INT pin is asserted */
+typedef void (*VCNL4010SimInterrupt)(void *context);
+
+const uint16_t VCNL4010_SIM_PROX_MICROS{250};     ///< Default proximity measurement time
+const uint16_t VCNL4010_SIM_ALS_CONV_MICROS{300};  ///< Default time of a single ALS conversion
+
+class VCNL4010Sim : public VCNL4010FakeBus {
+  /*!
+   * @class VCNL4010Sim
+   * @brief Simulated VCNL4010 on a virtual clock, see the file description for details
+   */
+ public:
+  explicit VCNL4010Sim(const uint8_t address = 0x13);
+  uint8_t  read(const uint8_t device, const uint8_t reg, uint8_t *data,
+                const uint8_t length) override;
+  uint8_t  write(const uint8_t device, const uint8_t reg, const uint8_t *data,
+                 const uint8_t length) override;
+  void     advance(const uint32_t us) override;
+  void     reset();                                                 // Power-on reset
+  void     setScene(const uint16_t proximity, const uint16_t ambient);  // Fixed scene
+  void     setScene(VCNL4010SimScene scene, void *context);        // Scene callback
+  void     setNoise(const uint16_t proximity, const uint16_t ambient);  // Noise amplitude
+  void     setTiming(const uint16_t proxMicros, const uint16_t alsConversionMicros);
+  void     onInterrupt(VCNL4010SimInterrupt callback, void *context);  // INT pin callback
+  bool     interruptAsserted() const;                      // State of the simulated INT pin
+  uint32_t getBusMicros() const { return _busMicros; }     ///< Total time the bus was busy
+  uint32_t getProximityCount() const { return _proxCount; }  ///< Proximity measurements made
+  uint32_t getAmbientCount() const { return _alsCount; }     ///< Ambient measurements made
+  uint32_t getProximityOverwrites() const {
+    return _proxOverwrites;
+  }  ///< Proximity results replaced before they were read
+
+ protected:
+  uint8_t readRegister(const uint8_t reg) override;
+  void    writeRegister(const uint8_t reg, const uint8_t value) override;
+
+ private:
+  uint32_t transactionMicros(const uint8_t bytes) const;  // Bus time for a transaction
+  uint32_t cycleMicros(const uint32_t cycles) const;      // Bus time for clock cycles
+  void     clockTo(const uint32_t us);                    // Run model within a transaction
+  void     processUntil(const uint32_t time);             // Run the device model
+  void     startProximity(const uint32_t time);           // Start a proximity measurement
+  void     startAmbient(const uint32_t time);             // Start an ambient measurement
+  void     completeProximity(const uint32_t time);        // Store a proximity result
+  void     completeAmbient(const uint32_t time);          // Store an ambient result
+  void     checkThreshold(const bool proximity, const uint16_t value);  // Threshold interrupts
+  void     raiseInterrupt(const uint8_t bits);                          // Set status bits
+  uint16_t sceneValue(const uint32_t time, const bool proximity);       // Reading with noise
+  uint32_t proximityPeriod() const;                                     // Self-timed PROX period
+  uint32_t ambientPeriod() const;                                       // Self-timed ALS period
+  VCNL4010SimScene     _scene{nullptr};           // Scene callback or nullptr for fixed scene
+  void                *_sceneContext{nullptr};    // Context passed to the scene callback
+  VCNL4010SimInterrupt _interrupt{nullptr};       // INT pin callback
+  void                *_interruptContext{nullptr};  // Context passed to the INT pin callback
+  uint16_t _sceneProximity{2000};                 // Fixed proximity scene at 20mA
+  uint16_t _sceneAmbient{100};                    // Fixed ambient light scene
+  uint16_t _noiseProximity{0};                    // Peak proximity noise
+  uint16_t _noiseAmbient{0};                      // Peak ambient light noise
+  uint16_t _proxMicros{VCNL4010_SIM_PROX_MICROS};  // Proximity measurement time
+  uint16_t _alsConvMicros{VCNL4010_SIM_ALS_CONV_MICROS};  // Single ALS conversion time
+  uint32_t _random{0x12345678};                   // xorshift32 state for the noise
+  uint32_t _proxDone{0};                          // Completion time of running PROX measurement
+  uint32_t _alsDone{0};                           // Completion time of running ALS measurement
+  uint32_t _proxNext{0};                          // Next self-timed PROX measurement
+  uint32_t _alsNext{0};                           // Next self-timed ALS measurement
+  uint32_t _busMicros{0};                         // Total bus time
+  uint32_t _transactionStart{0};                  // Start time of the current transaction
+  uint32_t _transactionCycles{0};                 // Bus cycles of the transaction so far
+  uint32_t _proxCount{0};                         // Proximity measurements made
+  uint32_t _alsCount{0};                          // Ambient measurements made
+  uint32_t _proxOverwrites{0};                    // Proximity results not read in time
+  bool     _proxRunning{false};                   // Proximity measurement in progress
+  bool     _alsRunning{false};                    // Ambient measurement in progress
+  uint8_t  _proxExceeded{0};                      // Consecutive PROX threshold violations
+  uint8_t  _alsExceeded{0};                       // Consecutive ALS threshold violations
+};                                                // of class VCNL4010Sim
+#endif
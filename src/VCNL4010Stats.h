@@ -0,0 +1,162 @@
+/*! @file VCNL4010Stats.h
+
+@section VCNL4010Stats_intro_section Description
+
+Optional instrumentation of the VCNL4010 library. It is compiled in when VCNL4010_STATS is defined
+as 1 for the whole build, e.g. with "-DVCNL4010_STATS=1" in the compiler flags, as the library is
+compiled separately from the sketch. Otherwise nothing in this file is compiled and the
+instrumentation takes no memory and no processing time.\n
+\n
+When enabled, VCNL4010::getStats() returns a VCNL4010Stats structure with:\n
+- For each bus transaction type and each public operation the number of calls, the bus
+  transactions made and the bytes moved, and the minimum, maximum and a log2 histogram of the time
+  taken in microseconds. Transactions are counted for the outermost operation, so those made by
+  service() inside getProximity() count for VCNL4010_OP_PROXIMITY
+- The number of service() steps taken while waiting for a reading or for queued settings
+- The number of failed transactions for each type of bus error\n
+\n
+Times are taken with the bus transport's micros(), so they include the settle delays.
+
+See main library header file for details
+*/
+#ifndef VCNL4010Stats_h
+/*! @brief Guard code definition for the VCNL4010Stats header */
+#define VCNL4010Stats_h
+#ifndef VCNL4010_STATS
+/*! @brief Set to 1 to compile the instrumentation */
+#define VCNL4010_STATS 0
+#endif
+#if VCNL4010_STATS
+#include <string.h>       // memset()
+#include "VCNL4010Bus.h"  // Bus transport and status codes
+
+/*! @brief Operations counted in VCNL4010Stats */
+enum VCNL4010Operation : uint8_t {
+  VCNL4010_OP_READ      = 0,    ///< Bus read transactions
+  VCNL4010_OP_WRITE     = 1,    ///< Bus write transactions
+  VCNL4010_OP_SERVICE   = 2,    ///< service() and getAll()
+  VCNL4010_OP_INTERRUPT = 3,    ///< handleInterrupt()
+  VCNL4010_OP_PROXIMITY = 4,    ///< getProximity()
+  VCNL4010_OP_AMBIENT   = 5,    ///< getAmbientLight()
+  VCNL4010_OP_CONFIG    = 6,    ///< begin(), resync(), flush() and the setters
+  VCNL4010_OPERATIONS   = 7,    ///< Number of operations
+  VCNL4010_OP_NONE      = 0xFF  ///< No operation running
+};
+const uint8_t VCNL4010_STATS_BUCKETS{16};  ///< Latency histogram buckets
+
+struct VCNL4010OpStats {
+  /*!
+   * @struct VCNL4010OpStats
+   * @brief  Counters of one operation. Histogram bucket 0 counts calls taking 0us, bucket n calls
+   *         taking 2^(n-1) to 2^n-1 microseconds and the last bucket all longer calls. The bucket
+   *         counts stop at 65535
+   */
+  uint32_t calls;                            ///< Number of calls
+  uint32_t transactions;                     ///< Bus transactions made
+  uint32_t bytes;                            ///< Register bytes read or written
+  uint32_t minMicros;                        ///< Shortest call
+  uint32_t maxMicros;                        ///< Longest call
+  uint16_t buckets[VCNL4010_STATS_BUCKETS];  ///< Log2 histogram of the call times
+  void     addTime(const uint32_t us) {
+    /*!
+      @brief     Counts one call and its time
+      @param[in] us Time taken in microseconds
+    */
+    uint8_t bucket{0};
+    for (uint32_t rest = us; rest && bucket < VCNL4010_STATS_BUCKETS - 1; rest >>= 1) ++bucket;
+    if (buckets[bucket] != UINT16_MAX) ++buckets[bucket];
+    if (calls == 0 || us < minMicros) minMicros = us;
+    if (us > maxMicros) maxMicros = us;
+    ++calls;
+  }  // of method addTime()
+};   // of struct VCNL4010OpStats
+
+struct VCNL4010Stats {
+  /*!
+   * @struct VCNL4010Stats
+   * @brief  Instrumentation counters of a VCNL4010, see VCNL4010::getStats()
+   */
+  VCNL4010OpStats   op[VCNL4010_OPERATIONS];  ///< Counters for each operation
+  uint32_t          spins;                    ///< service() steps in waiting loops
+  uint16_t          nackAddress;              ///< Transactions with VCNL4010_I2C_NACK_ADDR
+  uint16_t          nackData;                 ///< Transactions with VCNL4010_I2C_NACK_DATA
+  uint16_t          shortReads;               ///< Transactions with VCNL4010_I2C_SHORT_READ
+  uint16_t          timeouts;                 ///< Transactions with VCNL4010_I2C_TIMEOUT
+  uint16_t          otherErrors;              ///< Transactions failing with other codes
+  VCNL4010Operation current;                  ///< Outermost operation running
+  void              reset() {
+    /*!
+      @brief     Sets all counters to 0
+    */
+    memset(this, 0, sizeof(*this));
+    current = VCNL4010_OP_NONE;
+  }  // of method reset()
+  void addTransaction(const VCNL4010Operation type, const uint8_t bytes, const uint32_t us,
+                      const uint8_t status) {
+    /*!
+      @brief     Counts one bus transaction for its type and the running operation
+      @param[in] type VCNL4010_OP_READ or VCNL4010_OP_WRITE
+      @param[in] bytes Number of register bytes
+      @param[in] us Time taken in microseconds
+      @param[in] status Status returned by the bus transport
+    */
+    op[type].addTime(us);
+    ++op[type].transactions;
+    op[type].bytes += bytes;
+    if (current != VCNL4010_OP_NONE) {
+      ++op[current].transactions;
+      op[current].bytes += bytes;
+    }  // if-then in an operation
+    switch (status) {
+      case VCNL4010_I2C_OK: break;
+      case VCNL4010_I2C_NACK_ADDR: ++nackAddress; break;
+      case VCNL4010_I2C_NACK_DATA: ++nackData; break;
+      case VCNL4010_I2C_SHORT_READ: ++shortReads; break;
+      case VCNL4010_I2C_TIMEOUT: ++timeouts; break;
+      default: ++otherErrors; break;
+    }  // of switch status
+  }    // of method addTransaction()
+};     // of struct VCNL4010Stats
+
+class VCNL4010StatsScope {
+  /*!
+   * @class VCNL4010StatsScope
+   * @brief Times an operation from construction to destruction
+   */
+ public:
+  VCNL4010StatsScope(VCNL4010Stats &stats, const VCNL4010Operation operation, VCNL4010Bus &bus)
+      : _stats(stats), _bus(bus), _start(bus.micros()), _outer(stats.current),
+        _operation(operation) {
+    /*!
+     * @brief   Class constructor, starts timing
+     * @param[in] stats Counters to update
+     * @param[in] operation Operation being timed
+     * @param[in] bus Bus transport providing the time
+     */
+    if (_outer == VCNL4010_OP_NONE) stats.current = operation;
+  }
+  ~VCNL4010StatsScope() {
+    /*!
+     * @brief   Class destructor, counts the operation and its time
+     */
+    _stats.op[_operation].addTime(_bus.micros() - _start);
+    _stats.current = _outer;
+  }
+
+ private:
+  VCNL4010Stats          &_stats;      // Counters to update
+  VCNL4010Bus            &_bus;        // Bus transport providing the time
+  const uint32_t          _start;      // Start time
+  const VCNL4010Operation _outer;      // Operation running before
+  const VCNL4010Operation _operation;  // Operation being timed
+};                                     // of class VCNL4010StatsScope
+
+/*! @brief Times the rest of the enclosing block as "operation" */
+#define VCNL4010_STATS_SCOPE(operation) VCNL4010StatsScope statsScope(_stats, operation, *_bus)
+/*! @brief Counts one service() step in a waiting loop */
+#define VCNL4010_STATS_SPIN() ++_stats.spins
+#else
+#define VCNL4010_STATS_SCOPE(operation)  ///< Instrumentation not compiled
+#define VCNL4010_STATS_SPIN()            ///< Instrumentation not compiled
+#endif
+#endif
@@ -0,0 +1,107 @@
+/*! @file VCNL4010Tracker.cpp
+ @section VCNL4010Tracker_cpp_intro_section Description
+
+Adaptive proximity threshold tracking for the VCNL4010 library\n\n
+See VCNL4010Tracker.h for details
+*/
+#include "VCNL4010Tracker.h"  // Include the header definition
+
+VCNL4010Tracker::VCNL4010Tracker(VCNL4010 &sensor) : _sensor(&sensor) {
+  /*!
+   * @brief   Class constructor
+   * @param[in] sensor Sensor to track, begin() must have been called for it
+   */
+}
+void VCNL4010Tracker::begin(const uint16_t window, const uint16_t hysteresis, const uint8_t count,
+                            const uint8_t shift) {
+  /*!
+    @brief     Takes a proximity reading as the initial baseline and enables the threshold
+               interrupt with a window around it
+    @details   This call blocks until a proximity reading is available. Other interrupt sources
+               set with setInterrupt() are turned off
+    @param[in] window Half width of the threshold window in proximity counts
+    @param[in] hysteresis Baseline drift in counts before the window is moved
+    @param[in] count Consecutive readings outside the window before the interrupt is raised, the
+               values 1, 2, 4, 8, 16, 32, 64 and 128 are supported by the device
+    @param[in] shift Baseline time constant as power of 2 in readings, 0 to 8
+  */
+  _window     = window;
+  _hysteresis = hysteresis;
+  _shift      = shift > 8 ? 8 : shift;
+  _count      = 1 << (VCNL4010Encode::interruptCount(count) >> 5);  // As set in the device
+  _outside    = 0;
+  const uint16_t proximity = _sensor->getProximity();
+  _baseline                = (uint32_t)proximity << 8;
+  setWindow(proximity);  // Write the thresholds, so setInterrupt() finds them unchanged
+  _sensor->setInterrupt(count, false, false, true, false, _low, _high);
+  _events    = 0;
+  _recenters = 0;
+}  // of method begin()
+VCNL4010TrackerEvent VCNL4010Tracker::update(const uint16_t proximity) {
+  /*!
+    @brief     Processes one proximity reading
+    @details   Once "count" readings in a row, as given to begin(), are outside of the window, the
+               last one sets the baseline and the window is moved there. Fewer are ignored.
+               Otherwise the reading is added to the baseline average and the window is moved if
+               the baseline drifted more than the hysteresis from the window centre
+    @param[in] proximity Proximity reading
+    @return    Event caused by the reading
+  */
+  if (proximity > _high || proximity < _low) {
+    if (++_outside < _count) return VCNL4010_TRACK_NONE;  // Not yet debounced
+    const VCNL4010TrackerEvent event = proximity > _high ? VCNL4010_TRACK_NEAR : VCNL4010_TRACK_FAR;
+    _outside                         = 0;
+    _baseline                        = (uint32_t)proximity << 8;
+    ++_events;
+    setWindow(proximity);  // Moves "_high"
+    return event;
+  }  // if-then reading outside the window
+  _outside             = 0;
+  const uint32_t value = (uint32_t)proximity << 8;
+  if (value > _baseline) {
+    _baseline += (value - _baseline) >> _shift;
+  } else {
+    _baseline -= (_baseline - value) >> _shift;
+  }  // if-then-else reading above baseline
+  const uint16_t baseline = getBaseline();
+  const uint16_t drift    = baseline > _centre ? baseline - _centre : _centre - baseline;
+  if (drift <= _hysteresis) return VCNL4010_TRACK_NONE;
+  setWindow(baseline);
+  return VCNL4010_TRACK_RECENTER;
+}  // of method update()
+VCNL4010TrackerEvent VCNL4010Tracker::service() {
+  /*!
+    @brief     Runs one VCNL4010::service() step and processes the proximity reading, if any
+    @details   The sensor's service() also handles a pending interrupt flagged with onInterrupt(),
+               which reads and clears the interrupt status along with the proximity value. After
+               a threshold interrupt the device has already seen "count" readings outside of the
+               window, so a reading outside of it is an event at once
+    @return    Event caused by the reading, VCNL4010_TRACK_NONE if there was no new reading
+  */
+  uint16_t proximity;
+  uint8_t  interrupts;
+  _sensor->service();
+  if (_sensor->tryGetInterrupts(interrupts) && (interrupts & 0b00000011)) {
+    _outside = _count - 1;  // Debounced by the device
+  }                         // if-then threshold interrupt
+  if (!_sensor->tryGetProximity(proximity)) return VCNL4010_TRACK_NONE;
+  return update(proximity);
+}  // of method service()
+uint16_t VCNL4010Tracker::getBaseline() const {
+  /*!
+    @brief     Returns the current baseline
+    @return    Baseline rounded to the nearest count
+  */
+  return (uint16_t)((_baseline + 0x80) >> 8);
+}  // of method getBaseline()
+void VCNL4010Tracker::setWindow(const uint16_t centre) {
+  /*!
+    @brief     Centres the threshold window on the given value
+    @details   The 4 threshold registers are written in one burst, see VCNL4010::setThresholds()
+    @param[in] centre New window centre
+  */
+  _centre = centre;
+  _low    = centre > _window ? centre - _window : 0;
+  _high   = (uint32_t)centre + _window > UINT16_MAX ? UINT16_MAX : centre + _window;
+  if (_sensor->setThresholds(_low, _high)) ++_recenters;
+}  // of method setWindow()
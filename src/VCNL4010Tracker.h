@@ -0,0 +1,69 @@
+/*! @file VCNL4010Tracker.h
+
+@section VCNL4010Tracker_intro_section Description
+
+Adaptive proximity threshold tracking for the VCNL4010 library. Instead of polling the proximity
+value, the VCNL4010 compares each reading against its low and high threshold registers and only
+raises its INT pin when "count" consecutive readings are outside of that window. The
+VCNL4010Tracker class keeps the window centred on a running baseline of the proximity readings:\n
+- Readings inside the window update the baseline, an exponential moving average in fixed point
+  with a time constant of 2^shift readings. The window is only moved once the baseline has drifted
+  more than the hysteresis away from the window centre, and is then written to the 4 threshold
+  registers in one burst transaction
+- "count" consecutive readings outside of the window are an event, an object approaching or
+  leaving, the same debounce the device applies to its interrupt. The baseline is set to the last
+  of these readings and the window is re-centred on it at once, so the next interrupt is only
+  raised when the scene changes again and not for every reading while the object is present.
+  Fewer readings outside of the window in a row, e.g. a noise spike, are ignored\n
+\n
+With the sensor in continuous proximity mode the host only needs to wake up on the INT pin and,
+to follow slow drift, every now and then to feed a reading. Both are done by calling service().
+
+See main library header file for details
+*/
+#ifndef VCNL4010Tracker_h
+/*! @brief Guard code definition for the VCNL4010Tracker header */
+#define VCNL4010Tracker_h
+#include "VCNL4010.h"  // Sensor class
+
+/*! @brief Result of VCNL4010Tracker::update() and VCNL4010Tracker::service() */
+enum VCNL4010TrackerEvent : uint8_t {
+  VCNL4010_TRACK_NONE     = 0,  ///< No reading or reading inside the window
+  VCNL4010_TRACK_RECENTER = 1,  ///< Baseline drifted, threshold window was moved
+  VCNL4010_TRACK_NEAR     = 2,  ///< Reading above the window, an object approached
+  VCNL4010_TRACK_FAR      = 3   ///< Reading below the window, an object left
+};
+
+class VCNL4010Tracker {
+  /*!
+   * @class VCNL4010Tracker
+   * @brief Keeps the proximity threshold window of a VCNL4010 centred on a running baseline
+   */
+ public:
+  explicit VCNL4010Tracker(VCNL4010 &sensor);
+  void     begin(const uint16_t window = 100, const uint16_t hysteresis = 20,
+                 const uint8_t count = 4, const uint8_t shift = 4);  // Measure baseline and arm
+  VCNL4010TrackerEvent update(const uint16_t proximity);  // Process a reading
+  VCNL4010TrackerEvent service();                         // Process a reading if available
+  uint16_t getBaseline() const;                           // Current baseline
+  uint16_t getLow() const { return _low; }                ///< Low threshold written to device
+  uint16_t getHigh() const { return _high; }              ///< High threshold written to device
+  uint32_t getEvents() const { return _events; }          ///< Near and far events
+  uint32_t getRecenters() const { return _recenters; }    ///< Threshold window writes
+
+ private:
+  void      setWindow(const uint16_t centre);  // Write the window around "centre"
+  VCNL4010 *_sensor;                           // Sensor being tracked
+  uint32_t  _baseline{0};                      // Baseline with 8 fractional bits
+  uint32_t  _events{0};                        // Near and far events
+  uint32_t  _recenters{0};                     // Threshold window writes
+  uint16_t  _centre{0};                        // Centre of the window written to the device
+  uint16_t  _low{0};                           // Low threshold written to the device
+  uint16_t  _high{UINT16_MAX};                 // High threshold written to the device
+  uint16_t  _window{100};                      // Half width of the window
+  uint16_t  _hysteresis{20};                   // Baseline drift before the window is moved
+  uint8_t   _shift{4};                         // Baseline time constant is 2^shift readings
+  uint8_t   _count{4};                         // Readings outside the window for an event
+  uint8_t   _outside{0};                       // Consecutive readings outside the window
+};                                             // of class VCNL4010Tracker
+#endif